@@ -0,0 +1,90 @@
+#include "Benchmark.hpp"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <igl/Timer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace polyfem::benchmarks
+{
+	void Context::measure(
+		const std::string &name,
+		const json &params,
+		const std::function<void()> &fun,
+		const std::function<void()> &setup)
+	{
+		for (int i = 0; i < settings_.warmup; ++i)
+		{
+			if (setup)
+				setup();
+			fun();
+		}
+
+		std::vector<double> times;
+		times.reserve(settings_.repetitions);
+
+		igl::Timer timer;
+		for (int i = 0; i < settings_.repetitions; ++i)
+		{
+			if (setup)
+				setup();
+			timer.start();
+			fun();
+			timer.stop();
+			times.push_back(timer.getElapsedTime());
+		}
+
+		json result;
+		result["name"] = name;
+		result["params"] = params;
+		result["repetitions"] = times.size();
+		result["times"] = times;
+
+		if (!times.empty())
+		{
+			std::vector<double> sorted = times;
+			std::sort(sorted.begin(), sorted.end());
+			const int n = sorted.size();
+			const double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+			double var = 0;
+			for (const double t : sorted)
+				var += (t - mean) * (t - mean);
+
+			result["min"] = sorted.front();
+			result["max"] = sorted.back();
+			result["mean"] = mean;
+			result["median"] = n % 2 == 1 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+			result["stddev"] = n > 1 ? std::sqrt(var / (n - 1)) : 0.0;
+
+			benchmark_logger().info("{} {}: median {}s, min {}s ({} reps)", name, params.dump(), result["median"].get<double>(), sorted.front(), n);
+		}
+
+		results_.push_back(result);
+	}
+
+	int Context::scaled(const int n) const
+	{
+		return std::max(1, int(std::round(n * settings_.scale)));
+	}
+
+	spdlog::logger &benchmark_logger()
+	{
+		static std::shared_ptr<spdlog::logger> logger = spdlog::stderr_color_mt("benchmarks");
+		return *logger;
+	}
+
+	std::vector<std::pair<std::string, BenchmarkFunction>> &registered_benchmarks()
+	{
+		static std::vector<std::pair<std::string, BenchmarkFunction>> benchmarks;
+		return benchmarks;
+	}
+
+	bool register_benchmark(const std::string &name, const BenchmarkFunction &fun)
+	{
+		registered_benchmarks().emplace_back(name, fun);
+		return true;
+	}
+} // namespace polyfem::benchmarks
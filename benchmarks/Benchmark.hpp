@@ -0,0 +1,74 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace polyfem::benchmarks
+{
+	/// @brief Global settings of a benchmark run, set from the command line.
+	struct Settings
+	{
+		/// number of timed repetitions of every measurement
+		int repetitions = 5;
+		/// number of untimed repetitions run before the timed ones
+		int warmup = 1;
+		/// multiplier applied to the problem sizes
+		double scale = 1;
+		/// maximum number of threads
+		size_t max_threads = 1;
+	};
+
+	/// @brief Collects the timings of the measurements of a run.
+	class Context
+	{
+	public:
+		Context(const Settings &settings) : settings_(settings) {}
+
+		/// @brief Times fun, first settings().warmup times untimed, then settings().repetitions times.
+		/// @param name name of the measurement
+		/// @param params problem parameters stored with the result (size, material, ...)
+		/// @param fun function to time
+		/// @param setup function called before every call of fun, not timed
+		void measure(
+			const std::string &name,
+			const json &params,
+			const std::function<void()> &fun,
+			const std::function<void()> &setup = nullptr);
+
+		/// @brief Scales a problem size with settings().scale
+		int scaled(const int n) const;
+
+		const Settings &settings() const { return settings_; }
+
+		/// @brief Results of the measurements so far, one entry per measurement
+		const json &results() const { return results_; }
+
+	private:
+		const Settings settings_;
+		json results_ = json::array();
+	};
+
+	/// @brief Logger of the benchmark runner, writes to stderr so that stdout only holds the results.
+	/// The states created by the benchmarks are quiet, see bar_args.
+	spdlog::logger &benchmark_logger();
+
+	using BenchmarkFunction = std::function<void(Context &)>;
+
+	/// @brief Registered benchmarks, in registration order
+	std::vector<std::pair<std::string, BenchmarkFunction>> &registered_benchmarks();
+
+	/// @brief Adds a benchmark to the registry, used by POLYFEM_BENCHMARK
+	bool register_benchmark(const std::string &name, const BenchmarkFunction &fun);
+} // namespace polyfem::benchmarks
+
+/// Defines and registers a benchmark, the body receives a Context &ctx
+#define POLYFEM_BENCHMARK(NAME)                                                                                        \
+	static void polyfem_benchmark_##NAME(polyfem::benchmarks::Context &ctx);                                           \
+	[[maybe_unused]] static const bool polyfem_benchmark_##NAME##_registered = polyfem::benchmarks::register_benchmark(#NAME, polyfem_benchmark_##NAME); \
+	static void polyfem_benchmark_##NAME(polyfem::benchmarks::Context &ctx)
@@ -0,0 +1,175 @@
+#include "BenchmarkProblems.hpp"
+
+#include <polyfem/io/MshWriter.hpp>
+#include <polyfem/io/OBJWriter.hpp>
+#include <polyfem/utils/Logger.hpp>
+
+#include <Eigen/Dense>
+
+#include <array>
+#include <filesystem>
+#include <vector>
+
+namespace polyfem::benchmarks
+{
+	void simplex_grid(const int dim, const int n, Eigen::MatrixXd &V, Eigen::MatrixXi &F)
+	{
+		assert(dim == 2 || dim == 3);
+		assert(n > 0);
+
+		const int np = n + 1;
+		const auto vid = [&](const int i, const int j, const int k) { return i + np * (j + np * k); };
+
+		V.resize(dim == 2 ? np * np : np * np * np, dim);
+		for (int k = 0; k < (dim == 2 ? 1 : np); ++k)
+			for (int j = 0; j < np; ++j)
+				for (int i = 0; i < np; ++i)
+				{
+					V(vid(i, j, k), 0) = double(i) / n;
+					V(vid(i, j, k), 1) = double(j) / n;
+					if (dim == 3)
+						V(vid(i, j, k), 2) = double(k) / n;
+				}
+
+		if (dim == 2)
+		{
+			F.resize(2 * n * n, 3);
+			int index = 0;
+			for (int j = 0; j < n; ++j)
+				for (int i = 0; i < n; ++i)
+				{
+					F.row(index++) << vid(i, j, 0), vid(i + 1, j, 0), vid(i + 1, j + 1, 0);
+					F.row(index++) << vid(i, j, 0), vid(i + 1, j + 1, 0), vid(i, j + 1, 0);
+				}
+			return;
+		}
+
+		// Kuhn subdivision: one tet per monotone path from corner 000 to corner 111,
+		// the corners are encoded with one bit per axis
+		static const std::array<std::array<int, 3>, 6> paths = {{{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}}};
+
+		F.resize(6 * n * n * n, 4);
+		int index = 0;
+		for (int k = 0; k < n; ++k)
+			for (int j = 0; j < n; ++j)
+				for (int i = 0; i < n; ++i)
+				{
+					const auto corner = [&](const int bits) { return vid(i + (bits & 1), j + ((bits >> 1) & 1), k + ((bits >> 2) & 1)); };
+
+					for (const auto &p : paths)
+					{
+						const int c1 = 1 << p[0];
+						const int c2 = c1 | (1 << p[1]);
+						std::array<int, 4> tet = {{corner(0), corner(c1), corner(c2), corner(7)}};
+
+						Eigen::Matrix3d J;
+						for (int d = 0; d < 3; ++d)
+							J.row(d) = V.row(tet[d + 1]) - V.row(tet[0]);
+						if (J.determinant() < 0)
+							std::swap(tet[2], tet[3]);
+
+						F.row(index++) << tet[0], tet[1], tet[2], tet[3];
+					}
+				}
+	}
+
+	std::string write_grid(const int dim, const int n, const bool stacked, const double gap)
+	{
+		Eigen::MatrixXd V;
+		Eigen::MatrixXi F;
+		simplex_grid(dim, n, V, F);
+
+		if (stacked)
+		{
+			Eigen::MatrixXd V2(2 * V.rows(), dim);
+			Eigen::MatrixXi F2(2 * F.rows(), F.cols());
+			V2 << V, V;
+			V2.bottomRows(V.rows()).col(dim - 1).array() += 1 + gap;
+			F2 << F, F.array() + V.rows();
+			std::swap(V, V2);
+			std::swap(F, F2);
+		}
+
+		const std::string name = fmt::format("polyfem_benchmark_{}d_{}{}.{}", dim, n, stacked ? "_stacked" : "", dim == 2 ? "obj" : "msh");
+		const std::string path = (std::filesystem::temp_directory_path() / name).string();
+
+		if (dim == 2)
+		{
+			if (!io::OBJWriter::write(path, V, Eigen::MatrixXi(), F))
+				log_and_throw_error("Unable to write {}", path);
+		}
+		else
+			io::MshWriter::write(path, V, F, std::vector<int>(F.rows(), 0), /*is_volume=*/true);
+
+		return path;
+	}
+
+	json bar_args(const int dim, const std::string &mesh_path, const json &material, const int discr_order)
+	{
+		json args = R"(
+		{
+			"geometry": [{
+				"surface_selection": [
+					{
+						"id": 1,
+						"axis": "-x",
+						"position": 0.01,
+						"relative": true
+					},
+					{
+						"id": 2,
+						"axis": "x",
+						"position": 0.99,
+						"relative": true
+					}
+				]
+			}],
+			"output": {
+				"log": {
+					"level": "error",
+					"quiet": true
+				}
+			}
+		})"_json;
+
+		args["geometry"][0]["mesh"] = mesh_path;
+		args["materials"] = material;
+		args["space"]["discr_order"] = discr_order;
+
+		args["boundary_conditions"]["dirichlet_boundary"] = {{{"id", 1}, {"value", std::vector<double>(dim, 0.0)}}};
+		std::vector<double> traction(dim, 0.0);
+		traction[0] = 100;
+		args["boundary_conditions"]["neumann_boundary"] = {{{"id", 2}, {"value", traction}}};
+
+		return args;
+	}
+
+	std::shared_ptr<State> make_state(const json &args, const size_t max_threads)
+	{
+		auto state = std::make_shared<State>();
+		state->init(args, true);
+		state->set_max_threads(max_threads);
+
+		state->load_mesh();
+
+		state->build_basis();
+		state->assemble_rhs();
+		state->assemble_mass_mat();
+
+		return state;
+	}
+
+	json benchmark_materials()
+	{
+		return R"(
+		{
+			"LinearElasticity": {"type": "LinearElasticity", "E": 10000, "nu": 0.3},
+			"NeoHookean": {"type": "NeoHookean", "E": 10000, "nu": 0.3},
+			"MooneyRivlin": {"type": "MooneyRivlin", "c1": 1000, "c2": 500, "k": 10000},
+			"MooneyRivlin3Param": {"type": "MooneyRivlin3Param", "c1": 1000, "c2": 500, "c3": 100, "d1": 10000},
+			"UnconstrainedOgden": {"type": "UnconstrainedOgden", "alphas": 2.0, "mus": [3000], "Ds": [0.0001]},
+			"IncompressibleOgden": {"type": "IncompressibleOgden", "c": [3000], "m": [2.0], "k": 10000},
+			"AMIPS": {"type": "AMIPS"}
+		})"_json;
+	}
+} // namespace polyfem::benchmarks
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+#include <polyfem/State.hpp>
+
+#include <Eigen/Core>
+
+#include <memory>
+#include <string>
+
+namespace polyfem::benchmarks
+{
+	/// @brief Generates a simplicial grid of [0, 1]^dim with n cells per side.
+	/// Squares are split in 2 triangles, cubes in 6 tetrahedra (Kuhn subdivision).
+	/// @param[in] dim dimension, 2 or 3
+	/// @param[in] n number of cells per side
+	/// @param[out] V #V x dim vertices
+	/// @param[out] F #F x (dim + 1) simplices
+	void simplex_grid(const int dim, const int n, Eigen::MatrixXd &V, Eigen::MatrixXi &F);
+
+	/// @brief Writes a simplicial grid (.obj in 2D, .msh in 3D) to the temporary directory.
+	/// @param[in] dim dimension, 2 or 3
+	/// @param[in] n number of cells per side
+	/// @param[in] stacked if true, adds a copy of the grid shifted by 1 + gap along the last axis
+	/// @param[in] gap distance between the stacked copies
+	/// @return path of the written mesh
+	std::string write_grid(const int dim, const int n, const bool stacked = false, const double gap = 0);
+
+	/// @brief Default input of a bar fixed on its left side (id 1) and pulled on its right side (id 2).
+	/// @param[in] dim dimension, 2 or 3
+	/// @param[in] mesh_path path of the mesh
+	/// @param[in] material material json
+	/// @param[in] discr_order discretization order
+	/// @return input json
+	json bar_args(const int dim, const std::string &mesh_path, const json &material, const int discr_order = 1);
+
+	/// @brief Creates a state from args, loads the mesh and builds bases, rhs and mass matrix.
+	std::shared_ptr<State> make_state(const json &args, const size_t max_threads);
+
+	/// @brief Materials for which the benchmarks are run, keyed by name.
+	json benchmark_materials();
+} // namespace polyfem::benchmarks
@@ -0,0 +1,142 @@
+#include "Benchmark.hpp"
+#include "BenchmarkProblems.hpp"
+
+#include <polyfem/assembler/AssemblyValsCache.hpp>
+#include <polyfem/assembler/ElementAssemblyValues.hpp>
+#include <polyfem/assembler/RhsAssembler.hpp>
+#include <polyfem/utils/MatrixCache.hpp>
+
+#include <Eigen/Core>
+
+#include <vector>
+
+using namespace polyfem;
+using namespace polyfem::assembler;
+using namespace polyfem::benchmarks;
+
+namespace
+{
+	std::shared_ptr<State> linear_elastic_state(const int dim, const int n, const int order, const size_t max_threads)
+	{
+		const json material = benchmark_materials()["LinearElasticity"];
+		return make_state(bar_args(dim, write_grid(dim, n), material, order), max_threads);
+	}
+
+	int grid_size(const Context &ctx, const int dim)
+	{
+		return ctx.scaled(dim == 2 ? 64 : 12);
+	}
+} // namespace
+
+POLYFEM_BENCHMARK(element_assembly_values)
+{
+	for (const int dim : {2, 3})
+	{
+		for (const int order : {1, 2})
+		{
+			const int n = grid_size(ctx, dim);
+			const auto state = linear_elastic_state(dim, n, order, ctx.settings().max_threads);
+			const auto &gbases = state->geom_bases();
+			const bool is_volume = state->mesh->is_volume();
+
+			ElementAssemblyValues vals;
+			ctx.measure(
+				"ElementAssemblyValues::compute",
+				{{"dim", dim}, {"n", n}, {"order", order}, {"n_elements", state->bases.size()}},
+				[&]() {
+					for (int e = 0; e < int(state->bases.size()); ++e)
+						vals.compute(e, is_volume, state->bases[e], gbases[e]);
+				});
+		}
+	}
+}
+
+POLYFEM_BENCHMARK(linear_assembly)
+{
+	for (const int dim : {2, 3})
+	{
+		for (const int order : {1, 2})
+		{
+			const int n = grid_size(ctx, dim);
+			const auto state = linear_elastic_state(dim, n, order, ctx.settings().max_threads);
+			const json params = {{"dim", dim}, {"n", n}, {"order", order}, {"n_bases", state->n_bases}};
+
+			StiffnessMatrix stiffness;
+			ctx.measure("LinearAssembler::assemble", params, [&]() {
+				state->assembler->assemble(
+					state->mesh->is_volume(), state->n_bases, state->bases, state->geom_bases(),
+					state->ass_vals_cache, 0, stiffness);
+			});
+
+			// same assembly without precomputed element values
+			AssemblyValsCache no_cache;
+			ctx.measure("LinearAssembler::assemble (no cache)", params, [&]() {
+				state->assembler->assemble(
+					state->mesh->is_volume(), state->n_bases, state->bases, state->geom_bases(),
+					no_cache, 0, stiffness);
+			});
+		}
+	}
+}
+
+POLYFEM_BENCHMARK(rhs_assembly)
+{
+	for (const int dim : {2, 3})
+	{
+		const int n = grid_size(ctx, dim);
+		const auto state = linear_elastic_state(dim, n, 1, ctx.settings().max_threads);
+		const auto rhs_assembler = state->build_rhs_assembler();
+
+		Eigen::MatrixXd rhs;
+		ctx.measure(
+			"RhsAssembler::assemble",
+			{{"dim", dim}, {"n", n}, {"n_bases", state->n_bases}},
+			[&]() { rhs_assembler->assemble(state->mass_matrix_assembler->density(), rhs); });
+	}
+}
+
+POLYFEM_BENCHMARK(sparse_matrix_cache)
+{
+	for (const int dim : {2, 3})
+	{
+		const int n = grid_size(ctx, dim);
+		const auto state = linear_elastic_state(dim, n, 1, ctx.settings().max_threads);
+		const int n_dofs = state->n_bases * dim;
+		const json params = {{"dim", dim}, {"n", n}, {"n_dofs", n_dofs}};
+
+		// element-wise dense blocks on the global dofs, as added by the assemblers
+		std::vector<std::vector<int>> element_dofs(state->bases.size());
+		for (int e = 0; e < int(state->bases.size()); ++e)
+			for (const auto &b : state->bases[e].bases)
+				for (const auto &g : b.global())
+					for (int d = 0; d < dim; ++d)
+						element_dofs[e].push_back(g.index * dim + d);
+
+		const auto fill = [&](utils::SparseMatrixCache &cache) {
+			for (int e = 0; e < int(element_dofs.size()); ++e)
+				for (const int i : element_dofs[e])
+					for (const int j : element_dofs[e])
+						cache.add_value(e, i, j, 1);
+		};
+
+		utils::SparseMatrixCache cache;
+		ctx.measure(
+			"SparseMatrixCache::get_matrix (build mapping)", params,
+			[&]() { cache.get_matrix(); },
+			[&]() {
+				cache = utils::SparseMatrixCache(n_dofs);
+				fill(cache);
+			});
+
+		// cache now holds the mapping, later calls only scatter the values
+		ctx.measure(
+			"SparseMatrixCache::get_matrix (cached mapping)", params,
+			[&]() { cache.get_matrix(); },
+			[&]() { fill(cache); });
+
+		ctx.measure(
+			"SparseMatrixCache::add_value (cached mapping)", params,
+			[&]() { fill(cache); },
+			[&]() { cache.get_matrix(); });
+	}
+}
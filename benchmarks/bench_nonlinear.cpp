@@ -0,0 +1,102 @@
+#include "Benchmark.hpp"
+#include "BenchmarkProblems.hpp"
+
+#include <polyfem/solver/forms/ContactForm.hpp>
+#include <polyfem/utils/MatrixCache.hpp>
+
+#include <Eigen/Core>
+
+using namespace polyfem;
+using namespace polyfem::benchmarks;
+
+namespace
+{
+	/// small smooth displacement, keeps every element positively oriented
+	Eigen::MatrixXd test_displacement(const State &state)
+	{
+		const int dim = state.mesh->dimension();
+		Eigen::MatrixXd disp = Eigen::MatrixXd::Zero(state.n_bases * dim, 1);
+		for (int i = 0; i < state.n_bases; ++i)
+		{
+			const RowVectorNd p = state.mesh_nodes->node_position(i);
+			for (int d = 0; d < dim; ++d)
+				disp(i * dim + d) = 0.01 * std::sin(3 * p(0) + d) * p((d + 1) % dim);
+		}
+		return disp;
+	}
+} // namespace
+
+POLYFEM_BENCHMARK(nonlinear_assembly)
+{
+	const json materials = benchmark_materials();
+	for (const int dim : {2, 3})
+	{
+		const int n = ctx.scaled(dim == 2 ? 48 : 8);
+		const std::string mesh_path = write_grid(dim, n);
+
+		for (const auto &[name, material] : materials.items())
+		{
+			const auto state = make_state(bar_args(dim, mesh_path, material), ctx.settings().max_threads);
+			if (state->assembler->is_linear())
+				continue;
+
+			const Eigen::MatrixXd disp = test_displacement(*state);
+			const bool is_volume = state->mesh->is_volume();
+			const json params = {{"material", name}, {"dim", dim}, {"n", n}, {"n_bases", state->n_bases}};
+
+			Eigen::MatrixXd grad;
+			ctx.measure("NLAssembler::assemble_gradient", params, [&]() {
+				state->assembler->assemble_gradient(
+					is_volume, state->n_bases, state->bases, state->geom_bases(),
+					state->ass_vals_cache, 0, 1, disp, disp, grad);
+			});
+
+			utils::SparseMatrixCache mat_cache;
+			StiffnessMatrix hessian;
+			ctx.measure("NLAssembler::assemble_hessian", params, [&]() {
+				state->assembler->assemble_hessian(
+					is_volume, state->n_bases, /*project_to_psd=*/false, state->bases, state->geom_bases(),
+					state->ass_vals_cache, 0, 1, disp, disp, mat_cache, hessian);
+			});
+		}
+	}
+}
+
+POLYFEM_BENCHMARK(contact_form)
+{
+	for (const int dim : {2, 3})
+	{
+		const int n = ctx.scaled(dim == 2 ? 48 : 8);
+		// two stacked blocks, the gap is inside the barrier activation distance
+		const double gap = 0.25 / n;
+
+		json args = bar_args(dim, write_grid(dim, n, /*stacked=*/true, gap), benchmark_materials()["NeoHookean"]);
+		args["contact"]["enabled"] = true;
+		args["contact"]["dhat"] = 2 * gap;
+
+		const auto state = make_state(args, ctx.settings().max_threads);
+
+		Eigen::MatrixXd sol, pressure;
+		state->init_solve(sol, pressure);
+		state->init_nonlinear_tensor_solve(sol);
+
+		solver::ContactForm &form = *state->solve_data.contact_form;
+		const Eigen::VectorXd x0 = sol;
+		const Eigen::VectorXd x1 = x0 + test_displacement(*state);
+
+		form.init(x0);
+
+		const json params = {{"dim", dim}, {"n", n}, {"n_collisions", form.get_collision_set().size()}};
+
+		ctx.measure("ContactForm::solution_changed", params, [&]() { form.solution_changed(x0); });
+		ctx.measure("ContactForm::value", params, [&]() { form.value(x0); });
+
+		Eigen::VectorXd grad;
+		ctx.measure("ContactForm::first_derivative", params, [&]() { form.first_derivative(x0, grad); });
+
+		StiffnessMatrix hessian;
+		ctx.measure("ContactForm::second_derivative", params, [&]() { form.second_derivative(x0, hessian); });
+
+		ctx.measure("ContactForm::max_step_size", params, [&]() { form.max_step_size(x0, x1); });
+	}
+}
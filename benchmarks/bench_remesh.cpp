@@ -0,0 +1,72 @@
+#include "Benchmark.hpp"
+#include "BenchmarkProblems.hpp"
+
+#include <polyfem/mesh/remesh/wild_remesh/AMIPSForm.hpp>
+
+#include <Eigen/Core>
+
+#include <vector>
+
+using namespace polyfem;
+using namespace polyfem::benchmarks;
+
+POLYFEM_BENCHMARK(remesh_amips)
+{
+	const int n = ctx.scaled(128);
+	Eigen::MatrixXd V;
+	Eigen::MatrixXi F;
+	simplex_grid(2, n, V, F);
+
+	// small smooth deformation, keeps every triangle positively oriented
+	Eigen::MatrixXd U = V;
+	for (int i = 0; i < U.rows(); ++i)
+	{
+		U(i, 0) += 0.1 / n * std::sin(3 * V(i, 1));
+		U(i, 1) += 0.1 / n * std::cos(2 * V(i, 0));
+	}
+
+	// one local form per triangle, as the vertex smoothing builds them
+	std::vector<solver::AMIPSForm> forms;
+	std::vector<Eigen::VectorXd> xs;
+	forms.reserve(F.rows());
+	xs.reserve(F.rows());
+	for (int f = 0; f < F.rows(); ++f)
+	{
+		Eigen::MatrixXd X_rest(3, 2), X(3, 2);
+		for (int k = 0; k < 3; ++k)
+		{
+			X_rest.row(k) = V.row(F(f, k));
+			X.row(k) = U.row(F(f, k));
+		}
+		forms.emplace_back(X_rest, X);
+		xs.push_back(U.row(F(f, 0)).transpose());
+	}
+
+	const json params = {{"n", n}, {"n_triangles", F.rows()}};
+
+	double sum = 0;
+	ctx.measure("AMIPSForm::value", params, [&]() {
+		for (int f = 0; f < F.rows(); ++f)
+			sum += forms[f].value(xs[f]);
+	});
+
+	Eigen::VectorXd grad;
+	ctx.measure("AMIPSForm::first_derivative", params, [&]() {
+		for (int f = 0; f < F.rows(); ++f)
+			forms[f].first_derivative(xs[f], grad);
+	});
+
+	StiffnessMatrix hessian;
+	ctx.measure("AMIPSForm::second_derivative", params, [&]() {
+		for (int f = 0; f < F.rows(); ++f)
+			forms[f].second_derivative(xs[f], hessian);
+	});
+
+	int n_valid = 0;
+	ctx.measure("AMIPSForm::is_step_valid", params, [&]() {
+		for (int f = 0; f < F.rows(); ++f)
+			n_valid += forms[f].is_step_valid(xs[f], xs[f]);
+	});
+
+	benchmark_logger().debug("remesh_amips: {} {}", sum, n_valid);
+}
@@ -0,0 +1,41 @@
+#include "Benchmark.hpp"
+#include "BenchmarkProblems.hpp"
+
+#include <polyfem/solver/forms/adjoint_forms/AMIPSForm.hpp>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <vector>
+
+using namespace polyfem;
+using namespace polyfem::benchmarks;
+
+POLYFEM_BENCHMARK(flip_check)
+{
+	for (const int dim : {2, 3})
+	{
+		// the line search of a shape optimization checks every step, on meshes from a few to many elements
+		for (const int base_n : (dim == 2 ? std::vector<int>{4, 16, 64, 256} : std::vector<int>{2, 4, 8, 24}))
+		{
+			const int n = ctx.scaled(base_n);
+			Eigen::MatrixXd V;
+			Eigen::MatrixXi F;
+			simplex_grid(dim, n, V, F);
+
+			// no element is flipped, every element is checked,
+			// the small meshes are checked several times per measurement to be above the timer resolution
+			const int n_calls = std::max<int>(1, 100000 / F.rows());
+			bool flipped = false;
+			ctx.measure(
+				"is_flipped", {{"dim", dim}, {"n", n}, {"n_elements", F.rows()}, {"n_calls", n_calls}},
+				[&]() {
+					for (int i = 0; i < n_calls; ++i)
+						flipped |= solver::is_flipped(V, F);
+				});
+
+			if (flipped)
+				benchmark_logger().error("flip_check: the grid has flipped elements");
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#include "Benchmark.hpp"
+#include "BenchmarkProblems.hpp"
+
+#include <polyfem/io/Evaluator.hpp>
+#include <polyfem/utils/RefElementSampler.hpp>
+
+#include <Eigen/Core>
+
+using namespace polyfem;
+using namespace polyfem::benchmarks;
+
+POLYFEM_BENCHMARK(interpolate_function)
+{
+	for (const int dim : {2, 3})
+	{
+		for (const int order : {1, 2})
+		{
+			const int n = ctx.scaled(dim == 2 ? 64 : 12);
+			const auto state = make_state(
+				bar_args(dim, write_grid(dim, n), benchmark_materials()["LinearElasticity"], order),
+				ctx.settings().max_threads);
+
+			utils::RefElementSampler sampler;
+			sampler.init(state->mesh->is_volume(), state->mesh->n_elements(), 0.00001);
+			const int n_points = state->mesh->n_elements() * sampler.simplex_points().rows();
+
+			const Eigen::MatrixXd fun = Eigen::MatrixXd::Random(state->n_bases * dim, 1);
+			Eigen::MatrixXd result;
+
+			ctx.measure(
+				"Evaluator::interpolate_function",
+				{{"dim", dim}, {"n", n}, {"order", order}, {"n_points", n_points}},
+				[&]() {
+					io::Evaluator::interpolate_function(
+						*state->mesh, /*is_problem_scalar=*/false, state->bases, state->disc_orders,
+						state->polys, state->polys_3d, sampler, n_points, fun, result,
+						/*use_sampler=*/true, /*boundary_only=*/false);
+				});
+		}
+	}
+}
+
+POLYFEM_BENCHMARK(state_solve)
+{
+	const json materials = benchmark_materials();
+	for (const int dim : {2, 3})
+	{
+		const int n = ctx.scaled(dim == 2 ? 32 : 6);
+		const std::string mesh_path = write_grid(dim, n);
+
+		for (const std::string name : {"LinearElasticity", "NeoHookean", "MooneyRivlin"})
+		{
+			const auto state = make_state(bar_args(dim, mesh_path, materials[name]), ctx.settings().max_threads);
+
+			Eigen::MatrixXd sol, pressure;
+			ctx.measure(
+				"State::solve",
+				{{"material", name}, {"dim", dim}, {"n", n}, {"n_dofs", state->ndof()}},
+				[&]() { state->solve(sol, pressure); });
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#include "Benchmark.hpp"
+
+#include <CLI/CLI.hpp>
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <regex>
+
+using namespace polyfem;
+using namespace polyfem::benchmarks;
+
+int main(int argc, char **argv)
+{
+	CLI::App command_line{"polyfem benchmarks"};
+
+	command_line.ignore_case();
+	command_line.ignore_underscore();
+
+	Settings settings;
+	command_line.add_option("--max_threads", settings.max_threads, "Maximum number of threads");
+	command_line.add_option("-r,--repetitions", settings.repetitions, "Number of timed repetitions")->check(CLI::PositiveNumber);
+	command_line.add_option("-w,--warmup", settings.warmup, "Number of untimed repetitions")->check(CLI::NonNegativeNumber);
+	command_line.add_option("-s,--scale", settings.scale, "Problem size multiplier")->check(CLI::PositiveNumber);
+
+	std::string filter = "";
+	command_line.add_option("-f,--filter", filter, "Only run the benchmarks whose name matches this regex");
+
+	std::string output = "";
+	command_line.add_option("-o,--output", output, "Output JSON file, prints to stdout if empty");
+
+	bool list = false;
+	command_line.add_flag("-l,--list", list, "List the benchmarks and exit");
+
+	const std::vector<std::pair<std::string, spdlog::level::level_enum>>
+		SPDLOG_LEVEL_NAMES_TO_LEVELS = {
+			{"trace", spdlog::level::trace},
+			{"debug", spdlog::level::debug},
+			{"info", spdlog::level::info},
+			{"warning", spdlog::level::warn},
+			{"error", spdlog::level::err},
+			{"critical", spdlog::level::critical},
+			{"off", spdlog::level::off}};
+	spdlog::level::level_enum log_level = spdlog::level::info;
+	command_line.add_option("--log_level", log_level, "Log level")
+		->transform(CLI::CheckedTransformer(SPDLOG_LEVEL_NAMES_TO_LEVELS, CLI::ignore_case));
+
+	CLI11_PARSE(command_line, argc, argv);
+
+	benchmark_logger().set_level(log_level);
+
+	if (list)
+	{
+		for (const auto &[name, fun] : registered_benchmarks())
+			std::cout << name << std::endl;
+		return EXIT_SUCCESS;
+	}
+
+	Context ctx(settings);
+	const std::regex filter_regex(filter.empty() ? ".*" : filter);
+
+	for (const auto &[name, fun] : registered_benchmarks())
+	{
+		if (!std::regex_search(name, filter_regex))
+			continue;
+
+		benchmark_logger().info("Running {}", name);
+		fun(ctx);
+	}
+
+	const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	char date[32];
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+	json out;
+	out["date"] = date;
+	out["settings"] = {
+		{"repetitions", settings.repetitions},
+		{"warmup", settings.warmup},
+		{"scale", settings.scale},
+		{"max_threads", settings.max_threads},
+		{"filter", filter}};
+	out["benchmarks"] = ctx.results();
+
+	if (output.empty())
+		std::cout << out.dump(4) << std::endl;
+	else
+	{
+		std::ofstream file(output);
+		if (!file.is_open())
+		{
+			benchmark_logger().error("Unable to open {}", output);
+			return EXIT_FAILURE;
+		}
+		file << out.dump(4) << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
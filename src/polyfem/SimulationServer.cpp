@@ -0,0 +1,284 @@
+#include "SimulationServer.hpp"
+
+#include <polyfem/State.hpp>
+#include <polyfem/utils/Logger.hpp>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <igl/Timer.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace polyfem
+{
+	namespace
+	{
+		/// stage affected by a change of the value at a json pointer of the input
+		SimulationServer::Stage path_stage(const std::string &path)
+		{
+			using Stage = SimulationServer::Stage;
+
+			std::vector<std::string> tokens;
+			std::stringstream ss(path);
+			std::string token;
+			std::getline(ss, token, '/'); // leading empty token
+			while (std::getline(ss, token, '/'))
+				tokens.push_back(token);
+			tokens.resize(std::max<size_t>(tokens.size(), 3));
+
+			const std::string &key = tokens[0];
+			const std::string &sub_key = tokens[1];
+
+			if (key == "output")
+			{
+				// used by load_mesh and build_basis
+				if ((sub_key == "paraview" && tokens[2] == "vismesh_rel_area")
+					|| (sub_key == "advanced" && (tokens[2] == "sol_on_grid" || tokens[2] == "curved_mesh_size")))
+					return Stage::Full;
+				if (sub_key == "paraview" || sub_key == "json" || sub_key == "log" || sub_key == "directory")
+					return Stage::Export;
+				return Stage::Solve;
+			}
+			if (key == "tests")
+				return Stage::Export;
+			if (key == "solver")
+				return (sub_key == "advanced" && tokens[2] == "cache_size") ? Stage::Full : Stage::Solve;
+			if (key == "boundary_conditions")
+			{
+				// obstacles are loaded with the mesh and periodic conditions change the node mapping
+				if (sub_key.empty() || sub_key == "obstacle_displacements" || sub_key == "periodic_boundary")
+					return Stage::Full;
+				return Stage::Solve;
+			}
+			if (key == "initial_conditions" || key == "load_cases")
+				return Stage::Solve;
+			if (key == "materials" || key == "time")
+				return Stage::Assembly;
+
+			return Stage::Full;
+		}
+	} // namespace
+
+	SimulationServer::SimulationServer(const json &overrides, const bool strict_validation)
+		: overrides_(overrides), strict_validation_(strict_validation)
+	{
+	}
+
+	SimulationServer::~SimulationServer() = default;
+
+	std::string SimulationServer::stage_name(const Stage stage)
+	{
+		switch (stage)
+		{
+		case Stage::Export:
+			return "export";
+		case Stage::Solve:
+			return "solve";
+		case Stage::Assembly:
+			return "assembly";
+		case Stage::Full:
+			return "full";
+		}
+		return "";
+	}
+
+	SimulationServer::Stage SimulationServer::affected_stage(const json &old_args, const json &new_args)
+	{
+		if (!old_args.is_object() || old_args.empty())
+			return Stage::Full;
+
+		// a diff operation can add or remove a whole subtree, check all its leaves
+		std::vector<std::string> paths;
+		const std::function<void(const std::string &, const json &)> add_leaves = [&](const std::string &path, const json &value) {
+			if (value.is_object() && !value.empty())
+			{
+				for (const auto &[key, child] : value.items())
+					add_leaves(path + "/" + key, child);
+			}
+			else
+				paths.push_back(path);
+		};
+
+		for (const json &op : json::diff(old_args, new_args))
+		{
+			const std::string path = op["path"];
+			if (op.contains("value"))
+				add_leaves(path, op["value"]);
+			if (op["op"] != "add")
+				add_leaves(path, old_args.at(json::json_pointer(path)));
+		}
+
+		Stage stage = Stage::Export;
+		for (const std::string &path : paths)
+			stage = std::max(stage, path_stage(path));
+		return stage;
+	}
+
+	json SimulationServer::run(const json &patch)
+	{
+		if (!patch.is_object())
+			log_and_throw_error("A job must be a JSON object");
+
+		igl::Timer timer;
+		timer.start();
+
+		json in_args = in_args_;
+		in_args.merge_patch(patch);
+		in_args.merge_patch(overrides_);
+
+		Stage stage = affected_stage(in_args_, in_args);
+		try
+		{
+			stage = update_state(in_args, stage);
+		}
+		catch (...)
+		{
+			// the state is only partially updated, the next job rebuilds it from scratch
+			state_ = nullptr;
+			throw;
+		}
+		in_args_ = in_args;
+
+		timer.stop();
+
+		std::stringstream ss;
+		state_->save_json(sol_, ss);
+
+		json result;
+		result["stage"] = stage_name(stage);
+		result["time"] = timer.getElapsedTime();
+		result["stats"] = ss.str().empty() ? json::object() : json::parse(ss.str());
+		return result;
+	}
+
+	void SimulationServer::init_state(const json &in_args)
+	{
+		// stdout holds the results, the log goes to stderr (and to the log file, if any)
+		json args = in_args;
+		const bool is_quiet = args["/output/log/quiet"_json_pointer].is_boolean() && args["/output/log/quiet"_json_pointer].get<bool>();
+		args["/output/log/quiet"_json_pointer] = true;
+
+		state_->init(args, strict_validation_);
+
+		if (!is_quiet)
+		{
+			auto sink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+			sink->set_level(state_->args["output"]["log"]["level"].get<spdlog::level::level_enum>());
+			logger().sinks().push_back(sink);
+		}
+	}
+
+	SimulationServer::Stage SimulationServer::update_state(const json &in_args, Stage stage)
+	{
+		if (state_ == nullptr)
+			stage = Stage::Full;
+
+		if (stage != Stage::Full)
+		{
+			const std::string formulation = state_->assembler->name();
+			const bool bc_changed = in_args_.value("boundary_conditions", json()) != in_args.value("boundary_conditions", json());
+
+			init_state(in_args);
+
+			// the bases depend on the formulation, and obstacles on the boundary conditions
+			if (state_->assembler->name() != formulation || formulation == "MultiModels"
+				|| (bc_changed && state_->obstacle.n_vertices() > 0))
+				stage = Stage::Full;
+		}
+
+		if (stage != Stage::Full)
+		{
+			// init recreates the assemblers and the problem, rebind them to the current bases
+			std::vector<std::shared_ptr<assembler::Assembler>> assemblers = {state_->assembler, state_->mass_matrix_assembler};
+			if (state_->pressure_assembler != nullptr)
+				assemblers.push_back(state_->pressure_assembler);
+			if (state_->mixed_assembler != nullptr)
+				state_->mixed_assembler->set_size(state_->mesh->dimension());
+			state_->set_materials(assemblers);
+
+			std::vector<mesh::LocalBoundary> local_boundary, local_neumann_boundary;
+			if (state_->setup_problem_bc(*state_->problem, local_boundary, local_neumann_boundary))
+			{
+				// as in build_basis
+				state_->use_avg_pressure = local_neumann_boundary.empty() && local_boundary.size() >= state_->total_local_boundary.size();
+				state_->local_boundary = std::move(local_boundary);
+				state_->local_neumann_boundary = std::move(local_neumann_boundary);
+			}
+			else
+			{
+				logger().info("The boundary conditions constrain different nodes, rebuilding everything");
+				stage = Stage::Full;
+			}
+		}
+
+		// transient outputs are written while solving
+		if (stage == Stage::Export && state_->problem->is_time_dependent())
+			stage = Stage::Solve;
+
+		logger().info("Server job {}: re-running from stage '{}'", n_jobs_, stage_name(stage));
+
+		if (stage == Stage::Full)
+		{
+			state_ = std::make_unique<State>();
+			init_state(in_args);
+			state_->load_mesh();
+			if (state_->mesh == nullptr)
+				log_and_throw_error("Unable to load the mesh");
+
+			state_->stats.compute_mesh_stats(*state_->mesh);
+			state_->build_basis();
+		}
+
+		state_->assemble_rhs();
+		if (stage >= Stage::Assembly)
+			state_->assemble_mass_mat();
+
+		if (stage >= Stage::Solve)
+		{
+			state_->solve_problem(sol_, pressure_);
+			state_->compute_errors(sol_);
+		}
+
+		state_->save_json(sol_);
+		state_->export_data(sol_, pressure_);
+
+		return stage;
+	}
+
+	void SimulationServer::serve(std::istream &in, std::ostream &out)
+	{
+		std::string line;
+		while (std::getline(in, line))
+		{
+			if (line.find_first_not_of(" \t\r") == std::string::npos)
+				continue;
+
+			json result;
+			result["job"] = n_jobs_;
+			try
+			{
+				result.update(run(json::parse(line)));
+				result["status"] = "ok";
+			}
+			catch (const std::exception &e)
+			{
+				logger().error("Server job {} failed: {}", n_jobs_, e.what());
+				result["status"] = "error";
+				result["message"] = e.what();
+			}
+			catch (const char *e)
+			{
+				logger().error("Server job {} failed: {}", n_jobs_, e);
+				result["status"] = "error";
+				result["message"] = e;
+			}
+			++n_jobs_;
+
+			out << result.dump() << std::endl;
+		}
+	}
+} // namespace polyfem
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+
+#include <Eigen/Dense>
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace polyfem
+{
+	class State;
+
+	/// @brief Long-lived simulation process that keeps a State alive across jobs.
+	///
+	/// Every job is a JSON merge patch of the input of the previous job, the first job being
+	/// the full input. Only the stages affected by the patch are re-run: new boundary conditions
+	/// only rebuild the problem and the right-hand side, new materials also reassemble the
+	/// operators, and anything touching the geometry or the discretization reloads the mesh
+	/// and rebuilds the bases.
+	class SimulationServer
+	{
+	public:
+		/// Stages re-run by a job, each stage includes the ones before it
+		enum class Stage
+		{
+			Export,   ///< rebuild the problem and write the outputs of the previous solution
+			Solve,    ///< rebuild the problem and the rhs, then solve
+			Assembly, ///< also set the materials and reassemble the mass matrix
+			Full,     ///< reload the mesh and rebuild the bases
+		};
+
+		/// @param[in] overrides arguments merged into the input of every job (e.g., command line options)
+		/// @param[in] strict_validation strict validation of the input
+		SimulationServer(const json &overrides, const bool strict_validation);
+		~SimulationServer();
+
+		/// @brief Runs one job, if it fails the input of the last successful job is kept
+		/// @param[in] patch merge patch of the input of the previous job
+		/// @return the stage that was re-run, its time, and the statistics of State::save_json
+		json run(const json &patch);
+
+		/// @brief Runs the jobs read from in, one JSON per line, and writes one JSON result per line to out.
+		/// Failed jobs are reported in their result and do not stop the server, blank lines are skipped.
+		void serve(std::istream &in, std::ostream &out);
+
+		/// @brief Earliest stage that must be re-run when the input changes from old_args to new_args
+		static Stage affected_stage(const json &old_args, const json &new_args);
+
+		static std::string stage_name(const Stage stage);
+
+		/// @brief Current state, null before the first successful job
+		const State *state() const { return state_.get(); }
+
+	private:
+		/// @brief Brings the state to in_args, re-running from stage
+		/// @return the stage actually re-run
+		Stage update_state(const json &in_args, Stage stage);
+
+		/// @brief Initializes the state with in_args, the log goes to stderr since stdout holds the results
+		void init_state(const json &in_args);
+
+		const json overrides_;
+		const bool strict_validation_;
+
+		/// input of the last successful job, before validation
+		json in_args_;
+		int n_jobs_ = 0;
+
+		std::unique_ptr<State> state_;
+		Eigen::MatrixXd sol_;
+		Eigen::MatrixXd pressure_;
+	};
+} // namespace polyfem
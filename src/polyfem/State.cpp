@@ -28,6 +28,7 @@
 
 #include <polyfem/basis/PolygonalBasis2d.hpp>
 #include <polyfem/basis/PolygonalBasis3d.hpp>
+#include <polyfem/basis/PolygonalBasisCache.hpp>
 
 #include <polyfem/autogen/auto_p_bases.hpp>
 #include <polyfem/autogen/auto_q_bases.hpp>
@@ -39,9 +40,12 @@
 
 #include <polyfem/utils/Logger.hpp>
 #include <polyfem/utils/Timer.hpp>
+#include <polyfem/utils/Reordering.hpp>
 
 #include <polysolve/linear/FEMSolver.hpp>
 
+#include <h5pp/h5pp.h>
+
 #include <polyfem/io/OBJWriter.hpp>
 
 #include <igl/edges.h>
@@ -381,6 +385,85 @@ namespace polyfem
 		logger().trace("Done (took {}s)", timer.getElapsedTime());
 	}
 
+	void State::reorder_nodes()
+	{
+		node_reordering.resize(0);
+
+		const std::string method = args["space"]["advanced"]["dof_reordering"];
+		if (method == "none")
+			return;
+
+		if (args["space"]["basis_type"] == "Spline")
+		{
+			logger().warn("DOF reordering disabled, it dosent work for splines!");
+			return;
+		}
+
+		if (mesh->has_poly())
+		{
+			logger().warn("DOF reordering disabled, not supported for polygonal meshes!");
+			return;
+		}
+
+		if (!mesh_nodes || mesh_nodes->n_nodes() != n_bases)
+		{
+			logger().warn("DOF reordering disabled, bases are not in one to one correspondence with the mesh nodes!");
+			return;
+		}
+
+		igl::Timer timer;
+		timer.start();
+
+		std::vector<std::vector<int>> adjacency(n_bases);
+		std::vector<int> element_nodes;
+		for (const auto &eb : bases)
+		{
+			element_nodes.clear();
+			for (const auto &b : eb.bases)
+				for (const auto &g : b.global())
+					element_nodes.push_back(g.index);
+
+			for (const int i : element_nodes)
+				for (const int j : element_nodes)
+					if (i != j)
+						adjacency[i].push_back(j);
+		}
+		for (auto &neighs : adjacency)
+		{
+			std::sort(neighs.begin(), neighs.end());
+			neighs.erase(std::unique(neighs.begin(), neighs.end()), neighs.end());
+		}
+
+		Eigen::VectorXi order;
+		if (method == "rcm")
+		{
+			order = utils::reverse_cuthill_mckee(adjacency);
+		}
+		else
+		{
+			assert(method == "morton");
+			Eigen::MatrixXd nodes(n_bases, mesh->dimension());
+			for (const auto &eb : bases)
+				for (const auto &b : eb.bases)
+					for (const auto &g : b.global())
+						nodes.row(g.index) = g.node;
+
+			order = utils::morton_order(nodes);
+		}
+		const Eigen::VectorXi new_index = utils::invert_permutation(order);
+
+		for (auto &eb : bases)
+			for (auto &b : eb.bases)
+				for (auto &g : b.global())
+					g.index = new_index[g.index];
+
+		mesh_nodes->reorder_nodes(new_index);
+		node_reordering = order;
+
+		timer.stop();
+		logger().debug("Reordered nodes with {}, bandwidth {} -> {} (took {}s)", method, utils::graph_bandwidth(adjacency), utils::graph_bandwidth(adjacency, new_index), timer.getElapsedTime());
+	}
+
 	std::string State::formulation() const
 	{
 		if (args["materials"].is_null())
@@ -570,6 +653,8 @@ namespace polyfem
 
 	void State::build_basis()
 	{
+		POLYFEM_PROFILE_SCOPE("Building basis");
+
 		if (!mesh)
 		{
 			logger().error("Load the mesh first!");
@@ -798,6 +883,8 @@ namespace polyfem
 
 		timer.stop();
 
+		reorder_nodes();
+
 		build_polygonal_basis();
 
 		if (n_geom_bases == 0)
@@ -1016,12 +1103,25 @@ namespace polyfem
 
 		ass_vals_cache.clear();
 		mass_ass_vals_cache.clear();
+		const std::shared_ptr<const State> source = discretization_source.lock();
+		discretization_source.reset();
 		if (n_bases <= args["solver"]["advanced"]["cache_size"])
 		{
 			timer.start();
-			logger().info("Building cache...");
-			ass_vals_cache.init(mesh->is_volume(), bases, curret_bases);
-			mass_ass_vals_cache.init(mesh->is_volume(), bases, curret_bases, true);
+			if (source && has_same_discretization(*source)
+				&& source->n_bases == n_bases && source->n_geom_bases == n_geom_bases
+				&& !source->ass_vals_cache.empty() && !source->mass_ass_vals_cache.empty())
+			{
+				logger().info("Sharing cache of a state with the same discretization...");
+				ass_vals_cache = source->ass_vals_cache;
+				mass_ass_vals_cache = source->mass_ass_vals_cache;
+			}
+			else
+			{
+				logger().info("Building cache...");
+				ass_vals_cache.init(mesh->is_volume(), bases, curret_bases);
+				mass_ass_vals_cache.init(mesh->is_volume(), bases, curret_bases, true);
+			}
 			if (mixed_assembler != nullptr)
 				pressure_ass_vals_cache.init(mesh->is_volume(), pressure_bases, curret_bases);
 
@@ -1036,8 +1136,20 @@ namespace polyfem
 		}
 	}
 
+	bool State::has_same_discretization(const State &other) const
+	{
+		// the mesh depends on the geometry, the bases and their numbering on the space and the formulation
+		return args["geometry"] == other.args["geometry"]
+			   && args["root_path"] == other.args["root_path"]
+			   && args["units"] == other.args["units"]
+			   && args["space"] == other.args["space"]
+			   && assembler->name() == other.assembler->name();
+	}
+
 	void State::build_polygonal_basis()
 	{
+		POLYFEM_PROFILE_SCOPE("Building polygonal basis");
+
 		if (!mesh)
 		{
 			logger().error("Load the mesh first!");
@@ -1063,6 +1175,16 @@ namespace polyfem
 
 		int new_bases = 0;
 
+		std::unique_ptr<basis::PolygonalBasisCache> poly_basis_cache;
+		const std::string poly_basis_cache_path = resolve_output_path(args["space"]["advanced"]["poly_basis_cache"]);
+		if (!poly_basis_cache_path.empty())
+		{
+			// the weights also depend on the PDE and its parameters through the integral constraints
+			poly_basis_cache = std::make_unique<basis::PolygonalBasisCache>(fmt::format(
+				"{}d {} {}", mesh->dimension(), assembler->name(), args["materials"].dump()));
+			poly_basis_cache->load(poly_basis_cache_path);
+		}
+
 		if (iso_parametric())
 		{
 			if (mesh->is_volume())
@@ -1081,7 +1203,8 @@ namespace polyfem
 					bases,
 					bases,
 					poly_edge_to_data,
-					polys_3d);
+					polys_3d,
+					poly_basis_cache.get());
 			}
 			else
 			{
@@ -1121,7 +1244,8 @@ namespace polyfem
 						bases,
 						bases,
 						poly_edge_to_data,
-						polys);
+						polys,
+						poly_basis_cache.get());
 				}
 			}
 		}
@@ -1148,7 +1272,8 @@ namespace polyfem
 						bases,
 						geom_bases_,
 						poly_edge_to_data,
-						polys_3d);
+						polys_3d,
+						poly_basis_cache.get());
 				}
 			}
 			else
@@ -1187,11 +1312,19 @@ namespace polyfem
 						bases,
 						geom_bases_,
 						poly_edge_to_data,
-						polys);
+						polys,
+						poly_basis_cache.get());
 				}
 			}
 		}
 
+		if (poly_basis_cache)
+		{
+			logger().debug("Polygonal basis cache: {} hits, {} misses", poly_basis_cache->hits(), poly_basis_cache->misses());
+			if (poly_basis_cache->misses() > 0)
+				poly_basis_cache->save(poly_basis_cache_path);
+		}
+
 		timer.stop();
 		timings.computing_poly_basis_time = timer.getElapsedTime();
 		logger().info(" took {}s", timings.computing_poly_basis_time);
@@ -1322,8 +1455,32 @@ namespace polyfem
 		collision_mesh.init_area_jacobians();
 	}
 
+	namespace
+	{
+		/// reads the mass matrix of a checkpoint, after checking that it was written for the same discretization
+		bool read_checkpoint_mass(
+			const std::string &path,
+			const int n_bases,
+			const Eigen::VectorXi &in_node_to_node,
+			StiffnessMatrix &mass)
+		{
+			{
+				h5pp::File file(path, h5pp::FileAccess::READONLY);
+				const Eigen::VectorXi stored_in_node_to_node = file.readDataset<Eigen::VectorXi>("in_node_to_node");
+				if (file.readDataset<int>("n_bases") != n_bases
+					|| stored_in_node_to_node.size() != in_node_to_node.size()
+					|| stored_in_node_to_node != in_node_to_node)
+					log_and_throw_error("Checkpoint {} was written for a different discretization", path);
+			}
+
+			return io::read_sparse_matrix(path, "mass", mass);
+		}
+	} // namespace
+
 	void State::assemble_mass_mat()
 	{
+		POLYFEM_PROFILE_SCOPE("Assembling mass mat");
+
 		if (!mesh)
 		{
 			logger().error("Load the mesh first!");
@@ -1352,10 +1509,20 @@ namespace polyfem
 
 		igl::Timer timer;
 		timer.start();
-		logger().info("Assembling mass mat...");
 
-		if (mixed_assembler != nullptr)
+		const std::string checkpoint_path = resolve_input_path(args["input"]["data"]["checkpoint"]);
+		const bool mass_loaded = !checkpoint_path.empty() && read_checkpoint_mass(checkpoint_path, n_bases, in_node_to_node, mass);
+		if (mass_loaded && mass.rows() != n_bases * assembler->size())
+			log_and_throw_error("Checkpoint {} has a mass matrix of size {}, expected {}", checkpoint_path, mass.rows(), n_bases * assembler->size());
+
+		if (mass_loaded)
 		{
+			logger().info("Loaded mass mat from {}", checkpoint_path);
+		}
+		else if (mixed_assembler != nullptr)
+		{
+			logger().info("Assembling mass mat...");
+
 			StiffnessMatrix velocity_mass;
 			mass_matrix_assembler->assemble(mesh->is_volume(), n_bases, bases, geom_bases(), mass_ass_vals_cache, 0, velocity_mass, true);
 
@@ -1376,6 +1543,7 @@ namespace polyfem
 		}
 		else
 		{
+			logger().info("Assembling mass mat...");
 			mass_matrix_assembler->assemble(mesh->is_volume(), n_bases, bases, geom_bases(), mass_ass_vals_cache, 0, mass, true);
 		}
 
@@ -1395,7 +1563,8 @@ namespace polyfem
 		avg_mass /= mass.rows();
 		logger().info("average mass {}", avg_mass);
 
-		if (args["solver"]["advanced"]["lump_mass_matrix"])
+		// a stored mass matrix is already lumped
+		if (args["solver"]["advanced"]["lump_mass_matrix"] && !mass_loaded)
 		{
 			mass = lump_matrix(mass);
 		}
@@ -1413,7 +1582,8 @@ namespace polyfem
 	std::shared_ptr<RhsAssembler> State::build_rhs_assembler(
 		const int n_bases_,
 		const std::vector<basis::ElementBases> &bases_,
-		const assembler::AssemblyValsCache &ass_vals_cache_) const
+		const assembler::AssemblyValsCache &ass_vals_cache_,
+		const assembler::Problem &problem_) const
 	{
 		json rhs_solver_params = args["solver"]["linear"];
 		if (!rhs_solver_params.contains("Pardiso"))
@@ -1426,13 +1596,46 @@ namespace polyfem
 			*assembler, *mesh, obstacle,
 			dirichlet_nodes, neumann_nodes,
 			dirichlet_nodes_position, neumann_nodes_position,
-			n_bases_, size, bases_, geom_bases(), ass_vals_cache_, *problem,
+			n_bases_, size, bases_, geom_bases(), ass_vals_cache_, problem_,
 			args["space"]["advanced"]["bc_method"],
 			rhs_solver_params);
 	}
 
+	bool State::setup_problem_bc(
+		assembler::Problem &problem_,
+		std::vector<LocalBoundary> &local_boundary_,
+		std::vector<LocalBoundary> &local_neumann_boundary_) const
+	{
+		problem_.update_nodes(in_node_to_node);
+
+		// setup_bc filters the full boundary, as in build_basis
+		local_boundary_ = total_local_boundary;
+		local_neumann_boundary_.clear();
+		std::vector<int> boundary_nodes_, pressure_boundary_nodes_, dirichlet_nodes_, neumann_nodes_;
+		problem_.setup_bc(*mesh, n_bases - obstacle.n_vertices(),
+						  bases, geom_bases(), pressure_bases,
+						  local_boundary_, boundary_nodes_, local_neumann_boundary_, pressure_boundary_nodes_,
+						  dirichlet_nodes_, neumann_nodes_);
+
+		const int problem_dim = problem_.is_scalar() ? 1 : mesh->dimension();
+		for (int i = n_bases - obstacle.n_vertices(); i < n_bases; ++i)
+		{
+			for (int d = 0; d < problem_dim; ++d)
+				boundary_nodes_.push_back(i * problem_dim + d);
+		}
+		std::sort(boundary_nodes_.begin(), boundary_nodes_.end());
+		boundary_nodes_.erase(std::unique(boundary_nodes_.begin(), boundary_nodes_.end()), boundary_nodes_.end());
+
+		return boundary_nodes_ == boundary_nodes
+			   && pressure_boundary_nodes_ == pressure_boundary_nodes
+			   && dirichlet_nodes_ == dirichlet_nodes
+			   && neumann_nodes_ == neumann_nodes;
+	}
+
 	void State::assemble_rhs()
 	{
+		POLYFEM_PROFILE_SCOPE("Assigning rhs");
+
 		if (!mesh)
 		{
 			logger().error("Load the mesh first!");
@@ -1505,6 +1708,8 @@ namespace polyfem
 
 	void State::solve_problem(Eigen::MatrixXd &sol, Eigen::MatrixXd &pressure)
 	{
+		POLYFEM_PROFILE_SCOPE("Solving");
+
 		if (!mesh)
 		{
 			logger().error("Load the mesh first!");
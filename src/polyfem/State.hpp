@@ -186,6 +186,14 @@ namespace polyfem
 		/// used to store assembly values for pressure for small problems
 		assembler::AssemblyValsCache pressure_ass_vals_cache;
 
+		/// state with the same discretization whose assembly caches are shared by the next build_basis
+		/// instead of being computed again, a later build_basis (e.g., after a shape update) computes its own
+		std::weak_ptr<const State> discretization_source;
+		/// copy of the mesh as loaded, before build_basis renumbers its nodes, only kept while later states with the same discretization may copy it
+		std::shared_ptr<const mesh::Mesh> loaded_mesh;
+		/// check if the other state builds the same mesh and bases, based on the arguments
+		bool has_same_discretization(const State &other) const;
+
 		/// Mass matrix, it is computed only for time dependent problems
 		StiffnessMatrix mass;
 		/// average system mass, used for contact with IPC
@@ -231,13 +239,33 @@ namespace polyfem
 		std::shared_ptr<assembler::RhsAssembler> build_rhs_assembler(
 			const int n_bases,
 			const std::vector<basis::ElementBases> &bases,
-			const assembler::AssemblyValsCache &ass_vals_cache) const;
+			const assembler::AssemblyValsCache &ass_vals_cache) const
+		{
+			return build_rhs_assembler(n_bases, bases, ass_vals_cache, *problem);
+		}
+		/// build a RhsAssembler for another problem on the same discretization (e.g., a load case)
+		std::shared_ptr<assembler::RhsAssembler> build_rhs_assembler(
+			const int n_bases,
+			const std::vector<basis::ElementBases> &bases,
+			const assembler::AssemblyValsCache &ass_vals_cache,
+			const assembler::Problem &problem) const;
 		/// build a RhsAssembler for the problem
 		std::shared_ptr<assembler::RhsAssembler> build_rhs_assembler() const
 		{
 			return build_rhs_assembler(n_bases, bases, mass_ass_vals_cache);
 		}
 
+		/// sets up the boundary conditions of a problem on the current bases without rebuilding them
+		/// (e.g., a load case or new boundary values of the same boundaries)
+		/// @param[in,out] problem problem with its parameters and units already set
+		/// @param[out] local_boundary dirichlet boundary of the problem
+		/// @param[out] local_neumann_boundary neumann boundary of the problem
+		/// @return false if the problem constrains different nodes than the current bases were set up with
+		bool setup_problem_bc(
+			assembler::Problem &problem,
+			std::vector<mesh::LocalBoundary> &local_boundary,
+			std::vector<mesh::LocalBoundary> &local_neumann_boundary) const;
+
 		/// quadrature used for projecting boundary conditions
 		/// @return the quadrature used for projecting boundary conditions
 		int n_boundary_samples() const
@@ -352,6 +380,11 @@ namespace polyfem
 		/// @param[out] sol solution
 		/// @param[out] pressure pressure
 		void solve_linear(Eigen::MatrixXd &sol, Eigen::MatrixXd &pressure);
+		/// solves the additional load cases of a static linear problem (args["load_cases"])
+		/// with the factorization of the last linear solve, fills load_case_sols
+		/// @param[in] A stiffness matrix before the Dirichlet conditions are applied
+		/// @param[in] A_factorized stiffness matrix with the Dirichlet rows replaced, as factorized
+		void solve_load_cases(const StiffnessMatrix &A, const StiffnessMatrix &A_factorized);
 		/// solves a navier stokes
 		/// @param[out] sol solution
 		/// @param[out] pressure pressure
@@ -416,6 +449,8 @@ namespace polyfem
 		Eigen::VectorXi in_node_to_node;
 		/// maps in vertices/edges/faces/cells to polyfem vertices/edges/faces/cells
 		Eigen::VectorXi in_primitive_to_primitive;
+		/// polyfem nodes after the locality reordering to polyfem nodes before it, empty if no reordering was done
+		Eigen::VectorXi node_reordering;
 
 		std::vector<int> primitive_to_node() const;
 		std::vector<int> node_to_primitive() const;
@@ -423,6 +458,8 @@ namespace polyfem
 	private:
 		/// build the mapping from input nodes to polyfem nodes
 		void build_node_mapping();
+		/// renumbers the nodes of the bases to improve locality (space/advanced/dof_reordering)
+		void reorder_nodes();
 
 		//---------------------------------------------------
 		//-----------------Geometry--------------------------
@@ -591,10 +628,20 @@ namespace polyfem
 		/// @brief computes all errors
 		void compute_errors(const Eigen::MatrixXd &sol);
 
+		/// @brief Build the JSON sim file for restarting the simulation at time t
+		/// @param t current time to restart at
+		json restart_json(const double t0, const double dt, const int t) const;
+
 		/// @brief Save a JSON sim file for restarting the simulation at time t
 		/// @param t current time to restart at
 		void save_restart_json(const double t0, const double dt, const int t) const;
 
+		/// @brief Save a single-file hdf5 checkpoint for restarting the simulation at time t
+		/// (restart JSON, time integrator history, node mapping, barrier stiffness, and optionally mass matrix)
+		/// @param time_integrator time integrator holding the history of the solution
+		/// @param t current time to restart at
+		void save_checkpoint(const time_integrator::ImplicitTimeIntegrator &time_integrator, const double t0, const double dt, const int t) const;
+
 		//-----------PATH management
 		/// Get the root path for the state (e.g., args["root_path"] or ".")
 		/// @return root path
@@ -621,6 +668,9 @@ namespace polyfem
 
 		std::unique_ptr<polysolve::linear::Solver> lin_solver_cached; // matrix factorization of last linear solve
 
+		/// solutions of the load cases, one column per entry of args["load_cases"]
+		Eigen::MatrixXd load_case_sols;
+
 		int ndof() const
 		{
 			const int actual_dim = problem->is_scalar() ? 1 : mesh->dimension();
@@ -12,7 +12,9 @@ namespace polyfem
 		{
 			is_mass_ = is_mass;
 			const int n_bases = bases.size();
-			cache.resize(n_bases);
+			// the values are computed in a new vector, the old one may be shared with other caches
+			auto new_cache = std::make_shared<std::vector<ElementAssemblyValues>>(n_bases);
+			std::vector<ElementAssemblyValues> &values = *new_cache;
 
 			// loop over elements
 			utils::maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
@@ -20,19 +22,21 @@ namespace polyfem
 				{
 					if (is_mass_)
 					{
-						auto &quadrature = cache[e].quadrature;
+						auto &quadrature = values[e].quadrature;
 						bases[e].compute_mass_quadrature(quadrature);
-						cache[e].compute(e, is_volume, quadrature.points, bases[e], gbases[e]);
+						values[e].compute(e, is_volume, quadrature.points, bases[e], gbases[e]);
 					}
 					else
-						cache[e].compute(e, is_volume, bases[e], gbases[e]);
+						values[e].compute(e, is_volume, bases[e], gbases[e]);
 				}
 			});
+
+			cache = new_cache;
 		}
 
 		void AssemblyValsCache::compute(const int el_index, const bool is_volume, const ElementBases &basis, const ElementBases &gbasis, ElementAssemblyValues &vals) const
 		{
-			if (cache.empty())
+			if (empty())
 			{
 				if (is_mass_)
 				{
@@ -44,7 +48,7 @@ namespace polyfem
 					vals.compute(el_index, is_volume, basis, gbasis);
 			}
 			else
-				vals = cache[el_index];
+				vals = (*cache)[el_index];
 		}
 	} // namespace assembler
 
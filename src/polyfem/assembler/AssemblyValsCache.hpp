@@ -2,17 +2,20 @@
 
 #include <polyfem/assembler/ElementAssemblyValues.hpp>
 
+#include <memory>
+
 namespace polyfem
 {
 	namespace assembler
 	{
-		/// Caches basis evaluation and geometric mapping at every element
+		/// Caches basis evaluation and geometric mapping at every element.
+		/// The cached values are read-only, copies of a cache share them until one is initialized again.
 		class AssemblyValsCache
 		{
 		public:
 			/// computes the basis evaluation and geometric mapping
 			/// for each of the given ElementBases in bases
-			/// initializes cache member
+			/// initializes cache member, the values shared with other caches are left untouched
 			void init(const bool is_volume, const std::vector<basis::ElementBases> &bases, const std::vector<basis::ElementBases> &gbases, const bool is_mass = false);
 
 			/// retrieves cached basis evaluation and geometric for the given element
@@ -21,14 +24,18 @@ namespace polyfem
 
 			void clear()
 			{
-				cache.clear();
+				cache.reset();
 			}
 
+			inline bool empty() const { return cache == nullptr || cache->empty(); }
 			inline bool is_mass() const { return is_mass_; }
 
+			/// if the two caches share their values
+			inline bool shares_values_with(const AssemblyValsCache &other) const { return cache != nullptr && cache == other.cache; }
+
 		private:
-			std::vector<ElementAssemblyValues> cache; ///< vector of basis values and geometric mapping with one entry per element
-			bool is_mass_;
+			std::shared_ptr<const std::vector<ElementAssemblyValues>> cache; ///< vector of basis values and geometric mapping with one entry per element
+			bool is_mass_ = false;
 		};
 	} // namespace assembler
 } // namespace polyfem
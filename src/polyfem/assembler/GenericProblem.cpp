@@ -5,6 +5,8 @@
 #include <polyfem/utils/StringUtils.hpp>
 #include <polyfem/io/MatrixIO.hpp>
 
+#include <unordered_map>
+
 namespace polyfem
 {
 	using namespace utils;
@@ -46,6 +48,41 @@ namespace polyfem
 
 				return j_boundary;
 			}
+
+			/// @brief groups the points by boundary condition
+			/// @param[in] global_ids boundary primitive of every point
+			/// @param[in] ids boundary id of every boundary condition
+			/// @return for every boundary condition applied to some points, its position in ids and the rows of its points
+			std::vector<std::pair<int, std::vector<int>>> group_by_boundary(const mesh::Mesh &mesh, const Eigen::MatrixXi &global_ids, const std::vector<int> &ids)
+			{
+				std::vector<std::pair<int, std::vector<int>>> groups;
+				if (ids.empty())
+					return groups;
+
+				// the points usually lie on a few primitives, ids are looked up once per boundary id
+				std::unordered_map<int, int> id_to_group;
+				for (int i = 0; i < global_ids.size(); ++i)
+				{
+					const int id = mesh.get_boundary_id(global_ids(i));
+					auto it = id_to_group.find(id);
+					if (it == id_to_group.end())
+					{
+						const auto slot = std::find(ids.begin(), ids.end(), id);
+						int group = -1;
+						if (slot != ids.end())
+						{
+							group = groups.size();
+							groups.emplace_back(int(slot - ids.begin()), std::vector<int>());
+						}
+						it = id_to_group.emplace(id, group).first;
+					}
+
+					if (it->second >= 0)
+						groups[it->second].second.push_back(i);
+				}
+
+				return groups;
+			}
 		} // namespace
 
 		double TensorBCValue::eval(const RowVectorNd &pts, const int dim, const double t, const int el_id) const
@@ -70,6 +107,30 @@ namespace polyfem
 			return val;
 		}
 
+		void TensorBCValue::eval(const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &val) const
+		{
+			val.resize(pts.rows(), pts.cols());
+
+			Eigen::VectorXd tmp;
+			for (int d = 0; d < pts.cols(); ++d)
+			{
+				value[d].eval(pts, t, -1, tmp);
+
+				if (interpolation.empty())
+				{
+				}
+				else if (interpolation.size() == 1)
+					tmp *= interpolation[0]->eval(t);
+				else
+				{
+					assert(d < interpolation.size());
+					tmp *= interpolation[d]->eval(t);
+				}
+
+				val.col(d) = tmp;
+			}
+		}
+
 		double ScalarBCValue::eval(const RowVectorNd &pts, const double t) const
 		{
 			assert(pts.size() == 2 || pts.size() == 3);
@@ -77,6 +138,12 @@ namespace polyfem
 			return value(x, y, z, t) * interpolation->eval(t);
 		}
 
+		void ScalarBCValue::eval(const Eigen::MatrixXd &pts, const double t, Eigen::VectorXd &val) const
+		{
+			value.eval(pts, t, -1, val);
+			val *= interpolation->eval(t);
+		}
+
 		GenericTensorProblem::GenericTensorProblem(const std::string &name)
 			: Problem(name), is_all_(false)
 		{
@@ -176,68 +243,41 @@ namespace polyfem
 		void GenericTensorProblem::dirichlet_bc(const mesh::Mesh &mesh, const Eigen::MatrixXi &global_ids, const Eigen::MatrixXd &uv, const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &val) const
 		{
 			val = Eigen::MatrixXd::Zero(pts.rows(), mesh.dimension());
+			assert(pts.cols() == val.cols());
 
-			for (long i = 0; i < pts.rows(); ++i)
+			if (is_all_)
 			{
-				if (is_all_)
-				{
-					assert(displacements_.size() == 1);
-					for (int d = 0; d < val.cols(); ++d)
-					{
-						val(i, d) = displacements_[0].eval(pts.row(i), d, t);
-					}
-				}
-				else
-				{
-					const int id = mesh.get_boundary_id(global_ids(i));
-					for (size_t b = 0; b < boundary_ids_.size(); ++b)
-					{
-						if (id == boundary_ids_[b])
-						{
-							for (int d = 0; d < val.cols(); ++d)
-							{
-								val(i, d) = displacements_[b].eval(pts.row(i), d, t);
-							}
+				assert(displacements_.size() == 1);
+				displacements_[0].eval(pts, t, val);
+				return;
+			}
 
-							break;
-						}
-					}
-				}
+			Eigen::MatrixXd group_val;
+			for (const auto &[b, rows] : group_by_boundary(mesh, global_ids, boundary_ids_))
+			{
+				displacements_[b].eval(pts(rows, Eigen::all), t, group_val);
+				val(rows, Eigen::all) = group_val;
 			}
 		}
 
 		void GenericTensorProblem::neumann_bc(const mesh::Mesh &mesh, const Eigen::MatrixXi &global_ids, const Eigen::MatrixXd &uv, const Eigen::MatrixXd &pts, const Eigen::MatrixXd &normals, const double t, Eigen::MatrixXd &val) const
 		{
 			val = Eigen::MatrixXd::Zero(pts.rows(), mesh.dimension());
+			assert(pts.cols() == val.cols());
 
-			for (long i = 0; i < pts.rows(); ++i)
+			Eigen::MatrixXd group_val;
+			for (const auto &[b, rows] : group_by_boundary(mesh, global_ids, neumann_boundary_ids_))
 			{
-				const int id = mesh.get_boundary_id(global_ids(i));
-
-				for (size_t b = 0; b < neumann_boundary_ids_.size(); ++b)
-				{
-					if (id == neumann_boundary_ids_[b])
-					{
-						for (int d = 0; d < val.cols(); ++d)
-						{
-							val(i, d) = forces_[b].eval(pts.row(i), d, t);
-						}
-
-						break;
-					}
-				}
+				forces_[b].eval(pts(rows, Eigen::all), t, group_val);
+				val(rows, Eigen::all) = group_val;
+			}
 
-				for (size_t b = 0; b < pressure_boundary_ids_.size(); ++b)
-				{
-					if (id == pressure_boundary_ids_[b])
-					{
-						for (int d = 0; d < val.cols(); ++d)
-						{
-							val(i, d) = pressures_[b].eval(pts.row(i), t) * normals(i, d);
-						}
-						break;
-					}
-				}
+			// pressures take precedence over forces on the same boundary
+			Eigen::VectorXd pressure;
+			for (const auto &[b, rows] : group_by_boundary(mesh, global_ids, pressure_boundary_ids_))
+			{
+				pressures_[b].eval(pts(rows, Eigen::all), t, pressure);
+				val(rows, Eigen::all) = normals(rows, Eigen::all).array().colwise() * pressure.array();
 			}
 		}
 
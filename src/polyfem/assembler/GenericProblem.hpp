@@ -21,7 +21,11 @@ namespace polyfem
 			}
 
 			double eval(const RowVectorNd &pts, const int dim, const double t, const int el_id = -1) const;
-
+			/// @brief evaluates all dimensions at all points, the interpolations are evaluated once
+			/// @param[in] pts #pts x dim points
+			/// @param[in] t time
+			/// @param[out] val #pts x dim values
+			void eval(const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &val) const;
 		};
 
 		struct ScalarBCValue
@@ -35,6 +39,11 @@ namespace polyfem
 			}
       
 			double eval(const RowVectorNd &pts, const double t) const;
+			/// @brief evaluates the value at all points, the interpolation is evaluated once
+			/// @param[in] pts #pts x dim points
+			/// @param[in] t time
+			/// @param[out] val #pts values
+			void eval(const Eigen::MatrixXd &pts, const double t, Eigen::VectorXd &val) const;
 		};
 
 		class GenericTensorProblem : public Problem
@@ -6,6 +6,7 @@
 #include <polyfem/basis/ElementBases.hpp>
 #include <polyfem/assembler/ElementAssemblyValues.hpp>
 #include <polyfem/basis/InterfaceData.hpp>
+#include <polyfem/basis/PolygonalBasisCache.hpp>
 
 #include <Eigen/Dense>
 #include <vector>
@@ -50,6 +51,7 @@ namespace polyfem
 			/// @param[in]     gbases                 List of the different basis used to discretize the geometry of the mesh
 			/// @param[in]     poly_edge_to_data      Additional data computed for edges at the interface with a polygon
 			/// @param[out]    mapped_boundary        Map element id -> #S x dim polyline formed by the collocation points on the boundary of the polygon. The collocation points are mapped through the geometric mapping of the element across the edge, so this polyline may differ from the original polygon.
+			/// @param[in,out] cache                  Optional cache of the RBF weights, filled with the missing polygons
 			/// @param[in]  element_types   Per-element tag indicating the type of each element (see Mesh.hpp)
 			/// @param[in]  values          Per-element shape functions for the PDE, evaluated over the element, used for the system matrix assembly (used for linear reproduction)
 			/// @param[in]  gvalues         Per-element shape functions for the geometric mapping, evaluated over the element (get boundary of the polygon)
@@ -65,7 +67,8 @@ namespace polyfem
 				std::vector<ElementBases> &bases,
 				const std::vector<ElementBases> &gbases,
 				const std::map<int, InterfaceData> &poly_edge_to_data,
-				std::map<int, Eigen::MatrixXd> &mapped_boundary);
+				std::map<int, Eigen::MatrixXd> &mapped_boundary,
+				PolygonalBasisCache *cache = nullptr);
 		};
 	} // namespace basis
 } // namespace polyfem
@@ -11,7 +11,9 @@
 #include "function/RBFWithLinear.hpp"
 #include "function/RBFWithQuadratic.hpp"
 #include "function/RBFWithQuadraticLagrange.hpp"
+#include "PolygonalBasisCache.hpp"
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 
 #include <polyfem/autogen/auto_q_bases.hpp>
 
@@ -583,7 +585,8 @@ namespace polyfem
 			std::vector<ElementBases> &bases,
 			const std::vector<ElementBases> &gbases,
 			const std::map<int, InterfaceData> &poly_face_to_data,
-			std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &mapped_boundary)
+			std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &mapped_boundary,
+			PolygonalBasisCache *cache)
 		{
 			assert(mesh.is_volume());
 			if (poly_face_to_data.empty())
@@ -593,149 +596,168 @@ namespace polyfem
 			int n_kernels_per_edge = 4; //(int) std::round(n_samples_per_edge / 3.0);
 			int n_samples_per_edge = 3 * n_kernels_per_edge;
 
+			if (integral_constraints < 0 || integral_constraints > 2)
+			{
+				throw std::runtime_error(fmt::format("Unsupported constraint order: {:d}", integral_constraints));
+			}
+
 			// Step 1: Compute integral constraints
 			Eigen::MatrixXd basis_integrals;
 			compute_integral_constraints(assembler, mesh, n_bases, bases, gbases, basis_integrals);
 
 			// Step 2: Compute the rest =)
+			// Polytopes only read the bases of their (non-polytope) neighbors, so they are independent
+			std::vector<int> polytopes;
+			std::vector<std::pair<Eigen::MatrixXd, Eigen::MatrixXi> *> polytope_boundaries;
 			for (int e = 0; e < mesh.n_elements(); ++e)
 			{
-				if (!mesh.is_polytope(e))
+				if (mesh.is_polytope(e))
 				{
-					continue;
+					polytopes.push_back(e);
+					polytope_boundaries.push_back(&mapped_boundary[e]);
 				}
-				// No boundary polytope
-				// assert(element_type[e] != ElementType::BOUNDARY_POLYTOPE);
-
-				// Kernel distance to polygon boundary
-				const double eps = compute_epsilon(mesh, e);
-
-				std::vector<int> local_to_global; // map local basis id (the ones that are nonzero on the polygon boundary) to global basis id
-				Eigen::MatrixXd collocation_points, kernel_centers, triangulated_vertices;
-				Eigen::MatrixXi triangulated_faces;
-				Eigen::MatrixXd rhs; // 1 row per collocation point, 1 column per basis that is nonzero on the polygon boundary
-
-				ElementBases &b = bases[e];
-				b.has_parameterization = false;
-
-				Quadrature tmp_quadrature, tmp_mass_quadrature;
-				double scaling;
-				Eigen::RowVector3d translation;
-				sample_polyhedra(e, 2, n_kernels_per_edge, n_samples_per_edge,
-								 quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler.name(), 2, AssemblerUtils::BasisType::POLY, 3),
-								 mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", 2, AssemblerUtils::BasisType::POLY, 3),
-								 mesh, poly_face_to_data, bases, gbases, eps, local_to_global,
-								 collocation_points, kernel_centers, rhs, triangulated_vertices,
-								 triangulated_faces, tmp_quadrature, tmp_mass_quadrature, scaling, translation);
-
-				b.set_quadrature([tmp_quadrature](Quadrature &quad) { quad = tmp_quadrature; });
-				b.set_mass_quadrature([tmp_mass_quadrature](Quadrature &quad) { quad = tmp_mass_quadrature; });
-				// b.scaling_ = scaling;
-				// b.translation_ = translation;
-
-				// igl::opengl::glfw::Viewer & viewer = UIState::ui_state().viewer;
-				// viewer.data().clear();
-				// viewer.data().set_mesh(triangulated_vertices, triangulated_faces);
-				// viewer.data().add_points(kernel_centers, Eigen::Vector3d(0,1,1).transpose());
-				// add_spheres(viewer, kernel_centers, 0.005);
-
-				// Eigen::MatrixXd pts = triangulated_vertices, normals;
-				// Eigen::MatrixXi tris = triangulated_faces;
-				// igl::per_corner_normals(pts, tris, 20, normals);
-				// viewer.data().set_normals(normals);
-				// viewer.data().set_face_based(false);
-				// viewer.launch();
-
-				// for(int a = 0; rhs.cols();++a)
-				// 	{
-				// 	igl::opengl::glfw::Viewer viewer;
-				// 	Eigen::MatrixXd asd(collocation_points.rows(), 3);
-				// 	asd.col(0)=collocation_points.col(0);
-				// 	asd.col(1)=collocation_points.col(1);
-				// 	asd.col(2)=collocation_points.col(2);
-				// 	Eigen::VectorXd S = rhs.col(a);
-				// 	Eigen::MatrixXd C;
-				// 	igl::colormap(igl::COLOR_MAP_TYPE_VIRIDIS, S, true, C);
-				// 	viewer.data().add_points(asd, C);
-				// 	viewer.launch();
-				// }
-
-				// for(int asd = 0; asd < collocation_points.rows(); ++asd) {
-				//     viewer.data().add_label(collocation_points.row(asd), std::to_string(asd));
-				// }
+			}
 
-				// Compute the weights of the RBF kernels
-				Eigen::MatrixXd local_basis_integrals(rhs.cols(), basis_integrals.cols());
-				for (long k = 0; k < rhs.cols(); ++k)
-				{
-					local_basis_integrals.row(k) = -basis_integrals.row(local_to_global[k]);
-				}
-				auto set_rbf = [&b](auto rbf) {
-					b.set_bases_func([rbf](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) {
-						Eigen::MatrixXd tmp;
-						rbf->bases_values(uv, tmp);
-						val.resize(tmp.cols());
-						assert(tmp.rows() == uv.rows());
-
-						for (size_t i = 0; i < tmp.cols(); ++i)
-						{
-							val[i].val = tmp.col(i);
-						}
-					});
-					b.set_grads_func([rbf](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) {
-						Eigen::MatrixXd tmpx, tmpy, tmpz;
-
-						rbf->bases_grads(0, uv, tmpx);
-						rbf->bases_grads(1, uv, tmpy);
-						rbf->bases_grads(2, uv, tmpz);
-
-						val.resize(tmpx.cols());
-						assert(tmpx.cols() == tmpy.cols());
-						assert(tmpx.cols() == tmpz.cols());
-						assert(tmpx.rows() == uv.rows());
-						for (size_t i = 0; i < tmpx.cols(); ++i)
-						{
-							val[i].grad.resize(uv.rows(), uv.cols());
-							val[i].grad.col(0) = tmpx.col(i);
-							val[i].grad.col(1) = tmpy.col(i);
-							val[i].grad.col(2) = tmpz.col(i);
-						}
-					});
-				};
-				if (integral_constraints == 0)
-				{
-					set_rbf(std::make_shared<RBFWithLinear>(
-						kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs, false));
-				}
-				else if (integral_constraints == 1)
-				{
-					set_rbf(std::make_shared<RBFWithLinear>(
-						kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs));
-				}
-				else if (integral_constraints == 2)
+			utils::maybe_parallel_for(int(polytopes.size()), [&](int start, int end, int thread_id) {
+				for (int p = start; p < end; ++p)
 				{
-					set_rbf(std::make_shared<RBFWithQuadratic>(
-						// set_rbf(std::make_shared<RBFWithQuadraticLagrange>(
-						assembler, kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs));
-				}
-				else
-				{
-					throw std::runtime_error(fmt::format("Unsupported constraint order: {:d}", integral_constraints));
-				}
+					const int e = polytopes[p];
+					// No boundary polytope
+					// assert(element_type[e] != ElementType::BOUNDARY_POLYTOPE);
+
+					// Kernel distance to polygon boundary
+					const double eps = compute_epsilon(mesh, e);
+
+					std::vector<int> local_to_global; // map local basis id (the ones that are nonzero on the polygon boundary) to global basis id
+					Eigen::MatrixXd collocation_points, kernel_centers, triangulated_vertices;
+					Eigen::MatrixXi triangulated_faces;
+					Eigen::MatrixXd rhs; // 1 row per collocation point, 1 column per basis that is nonzero on the polygon boundary
+
+					ElementBases &b = bases[e];
+					b.has_parameterization = false;
+
+					Quadrature tmp_quadrature, tmp_mass_quadrature;
+					double scaling;
+					Eigen::RowVector3d translation;
+					sample_polyhedra(e, 2, n_kernels_per_edge, n_samples_per_edge,
+									 quadrature_order > 0 ? quadrature_order : AssemblerUtils::quadrature_order(assembler.name(), 2, AssemblerUtils::BasisType::POLY, 3),
+									 mass_quadrature_order > 0 ? mass_quadrature_order : AssemblerUtils::quadrature_order("Mass", 2, AssemblerUtils::BasisType::POLY, 3),
+									 mesh, poly_face_to_data, bases, gbases, eps, local_to_global,
+									 collocation_points, kernel_centers, rhs, triangulated_vertices,
+									 triangulated_faces, tmp_quadrature, tmp_mass_quadrature, scaling, translation);
+
+					b.set_quadrature([tmp_quadrature](Quadrature &quad) { quad = tmp_quadrature; });
+					b.set_mass_quadrature([tmp_mass_quadrature](Quadrature &quad) { quad = tmp_mass_quadrature; });
+					// b.scaling_ = scaling;
+					// b.translation_ = translation;
+
+					// igl::opengl::glfw::Viewer & viewer = UIState::ui_state().viewer;
+					// viewer.data().clear();
+					// viewer.data().set_mesh(triangulated_vertices, triangulated_faces);
+					// viewer.data().add_points(kernel_centers, Eigen::Vector3d(0,1,1).transpose());
+					// add_spheres(viewer, kernel_centers, 0.005);
+
+					// Eigen::MatrixXd pts = triangulated_vertices, normals;
+					// Eigen::MatrixXi tris = triangulated_faces;
+					// igl::per_corner_normals(pts, tris, 20, normals);
+					// viewer.data().set_normals(normals);
+					// viewer.data().set_face_based(false);
+					// viewer.launch();
+
+					// for(int a = 0; rhs.cols();++a)
+					// 	{
+					// 	igl::opengl::glfw::Viewer viewer;
+					// 	Eigen::MatrixXd asd(collocation_points.rows(), 3);
+					// 	asd.col(0)=collocation_points.col(0);
+					// 	asd.col(1)=collocation_points.col(1);
+					// 	asd.col(2)=collocation_points.col(2);
+					// 	Eigen::VectorXd S = rhs.col(a);
+					// 	Eigen::MatrixXd C;
+					// 	igl::colormap(igl::COLOR_MAP_TYPE_VIRIDIS, S, true, C);
+					// 	viewer.data().add_points(asd, C);
+					// 	viewer.launch();
+					// }
+
+					// for(int asd = 0; asd < collocation_points.rows(); ++asd) {
+					//     viewer.data().add_label(collocation_points.row(asd), std::to_string(asd));
+					// }
+
+					// Compute the weights of the RBF kernels
+					Eigen::MatrixXd local_basis_integrals(rhs.cols(), basis_integrals.cols());
+					for (long k = 0; k < rhs.cols(); ++k)
+					{
+						local_basis_integrals.row(k) = -basis_integrals.row(local_to_global[k]);
+					}
+					auto set_rbf = [&b](auto rbf) {
+						b.set_bases_func([rbf](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) {
+							Eigen::MatrixXd tmp;
+							rbf->bases_values(uv, tmp);
+							val.resize(tmp.cols());
+							assert(tmp.rows() == uv.rows());
+
+							for (size_t i = 0; i < tmp.cols(); ++i)
+							{
+								val[i].val = tmp.col(i);
+							}
+						});
+						b.set_grads_func([rbf](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) {
+							Eigen::MatrixXd tmpx, tmpy, tmpz;
+
+							rbf->bases_grads(0, uv, tmpx);
+							rbf->bases_grads(1, uv, tmpy);
+							rbf->bases_grads(2, uv, tmpz);
+
+							val.resize(tmpx.cols());
+							assert(tmpx.cols() == tmpy.cols());
+							assert(tmpx.cols() == tmpz.cols());
+							assert(tmpx.rows() == uv.rows());
+							for (size_t i = 0; i < tmpx.cols(); ++i)
+							{
+								val[i].grad.resize(uv.rows(), uv.cols());
+								val[i].grad.col(0) = tmpx.col(i);
+								val[i].grad.col(1) = tmpy.col(i);
+								val[i].grad.col(2) = tmpz.col(i);
+							}
+						});
+					};
+					const PolygonalBasisCache::Key key = cache ? cache->key(integral_constraints, kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs) : PolygonalBasisCache::Key();
+					if (integral_constraints == 0)
+					{
+						set_rbf(PolygonalBasisCache::get_or_build<RBFWithLinear>(cache, key, kernel_centers, [&]() {
+							return std::make_shared<RBFWithLinear>(
+								kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs, false);
+						}));
+					}
+					else if (integral_constraints == 1)
+					{
+						set_rbf(PolygonalBasisCache::get_or_build<RBFWithLinear>(cache, key, kernel_centers, [&]() {
+							return std::make_shared<RBFWithLinear>(
+								kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs);
+						}));
+					}
+					else if (integral_constraints == 2)
+					{
+						set_rbf(PolygonalBasisCache::get_or_build<RBFWithQuadratic>(cache, key, kernel_centers, [&]() {
+							// return std::make_shared<RBFWithQuadraticLagrange>(
+							return std::make_shared<RBFWithQuadratic>(
+								assembler, kernel_centers, collocation_points, local_basis_integrals, tmp_quadrature, rhs);
+						}));
+					}
 
-				// Set the bases which are nonzero inside the polygon
-				const int n_poly_bases = int(local_to_global.size());
-				b.bases.resize(n_poly_bases);
-				for (int i = 0; i < n_poly_bases; ++i)
-				{
-					b.bases[i].init(-2, local_to_global[i], i, Eigen::MatrixXd::Constant(1, 3, std::nan("")));
-				}
+					// Set the bases which are nonzero inside the polygon
+					const int n_poly_bases = int(local_to_global.size());
+					b.bases.resize(n_poly_bases);
+					for (int i = 0; i < n_poly_bases; ++i)
+					{
+						b.bases[i].init(-2, local_to_global[i], i, Eigen::MatrixXd::Constant(1, 3, std::nan("")));
+					}
 
-				// Polygon boundary after geometric mapping from neighboring elements
-				orient_closed_surface(triangulated_vertices, triangulated_faces, false); // stupid viewer is flipping all the faces
-				mapped_boundary[e].first = triangulated_vertices;
-				mapped_boundary[e].second = triangulated_faces;
-			}
+					// Polygon boundary after geometric mapping from neighboring elements
+					orient_closed_surface(triangulated_vertices, triangulated_faces, false); // stupid viewer is flipping all the faces
+					polytope_boundaries[p]->first = triangulated_vertices;
+					polytope_boundaries[p]->second = triangulated_faces;
+				}
+			});
 
 			return 0;
 		}
@@ -5,6 +5,7 @@
 #include <polyfem/basis/ElementBases.hpp>
 #include <polyfem/assembler/ElementAssemblyValues.hpp>
 #include <polyfem/basis/InterfaceData.hpp>
+#include <polyfem/basis/PolygonalBasisCache.hpp>
 
 #include <Eigen/Dense>
 #include <vector>
@@ -49,6 +50,7 @@ namespace polyfem
 			/// @param[in]     gbases                List of the different basis used to discretize the geometry of the mesh
 			/// @param[in]     poly_face_to_data     Additional data computed for faces at the interface with a polygon
 			/// @param         mapped_boundary       Map element id > (V, E) triangle mesh surface formed by the image of the collocation points trough the geometric mapping of the boundary faces
+			/// @param[in,out] cache                 Optional cache of the RBF weights, filled with the missing polytopes
 			/// @param[in]  element_types   Per-element tag indicating the type of each element (see Mesh.hpp)
 			/// @param[in]  values         Per-element shape functions for the PDE, evaluated over the element,  used for the system matrix assembly (used for linear reproduction)
 			/// @param[in]  gvalues        Per-element shape functions for the geometric mapping, evaluated over  the element (get boundary of the polygon)
@@ -64,7 +66,8 @@ namespace polyfem
 				std::vector<ElementBases> &bases,
 				const std::vector<ElementBases> &gbases,
 				const std::map<int, InterfaceData> &poly_face_to_data,
-				std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &mapped_boundary);
+				std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &mapped_boundary,
+				PolygonalBasisCache *cache = nullptr);
 		};
 	} // namespace basis
 } // namespace polyfem
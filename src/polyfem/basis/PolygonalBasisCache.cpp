@@ -0,0 +1,226 @@
+#include "PolygonalBasisCache.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace polyfem
+{
+	namespace basis
+	{
+		namespace
+		{
+			constexpr char MAGIC[8] = {'P', 'F', 'P', 'O', 'L', 'Y', 'B', 'C'};
+			constexpr uint32_t VERSION = 1;
+
+			/// Two independent 64-bit hashes (FNV-1a and splitmix64-combined words) of a byte stream
+			class Hasher
+			{
+			public:
+				void add(const void *data, const size_t size)
+				{
+					const unsigned char *bytes = static_cast<const unsigned char *>(data);
+					for (size_t i = 0; i < size; ++i)
+					{
+						fnv_ ^= bytes[i];
+						fnv_ *= 0x100000001b3ull;
+					}
+
+					for (size_t i = 0; i < size; i += 8)
+					{
+						uint64_t word = 0;
+						std::memcpy(&word, bytes + i, std::min<size_t>(8, size - i));
+						mix_ = splitmix(mix_ ^ word);
+					}
+				}
+
+				void add(const int value) { add(&value, sizeof(value)); }
+
+				void add(const std::string &value)
+				{
+					add(int(value.size()));
+					add(value.data(), value.size());
+				}
+
+				template <typename Derived>
+				void add(const Eigen::MatrixBase<Derived> &mat)
+				{
+					add(int(mat.rows()));
+					add(int(mat.cols()));
+					const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> tmp = mat;
+					add(tmp.data(), tmp.size() * sizeof(double));
+				}
+
+				PolygonalBasisCache::Key key() const { return {{fnv_, mix_}}; }
+
+			private:
+				static uint64_t splitmix(uint64_t x)
+				{
+					x += 0x9e3779b97f4a7c15ull;
+					x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+					x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+					return x ^ (x >> 31);
+				}
+
+				uint64_t fnv_ = 0xcbf29ce484222325ull;
+				uint64_t mix_ = 0;
+			};
+
+			template <typename T>
+			void write_value(std::ostream &out, const T &value)
+			{
+				out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+			}
+
+			template <typename T>
+			bool read_value(std::istream &in, T &value)
+			{
+				in.read(reinterpret_cast<char *>(&value), sizeof(T));
+				return bool(in);
+			}
+		} // namespace
+
+		PolygonalBasisCache::Key PolygonalBasisCache::key(
+			const int integral_constraints,
+			const Eigen::MatrixXd &centers,
+			const Eigen::MatrixXd &collocation_points,
+			const Eigen::MatrixXd &local_basis_integral,
+			const quadrature::Quadrature &quadr,
+			const Eigen::MatrixXd &rhs) const
+		{
+			Hasher hasher;
+			hasher.add(context_);
+			hasher.add(integral_constraints);
+			hasher.add(centers);
+			hasher.add(collocation_points);
+			hasher.add(local_basis_integral);
+			hasher.add(quadr.points);
+			hasher.add(quadr.weights);
+			hasher.add(rhs);
+			return hasher.key();
+		}
+
+		bool PolygonalBasisCache::find(const Key &key, Eigen::MatrixXd &weights) const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			const auto it = entries_.find(key);
+			if (it == entries_.end())
+			{
+				++misses_;
+				return false;
+			}
+
+			++hits_;
+			weights = it->second;
+			return true;
+		}
+
+		void PolygonalBasisCache::insert(const Key &key, const Eigen::MatrixXd &weights)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			entries_[key] = weights;
+		}
+
+		void PolygonalBasisCache::clear()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			entries_.clear();
+			hits_ = 0;
+			misses_ = 0;
+		}
+
+		size_t PolygonalBasisCache::size() const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return entries_.size();
+		}
+
+		bool PolygonalBasisCache::load(const std::string &path)
+		{
+			std::ifstream in(path, std::ios::binary);
+			if (!in.is_open())
+				return false;
+
+			char magic[sizeof(MAGIC)];
+			uint32_t version;
+			uint64_t context_size;
+			in.read(magic, sizeof(magic));
+			if (!in || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+				|| !read_value(in, version) || version != VERSION
+				|| !read_value(in, context_size))
+			{
+				logger().warn("Invalid polygonal basis cache {}, ignoring it", path);
+				return false;
+			}
+
+			std::string context(context_size, '\0');
+			in.read(context.data(), context_size);
+			if (!in || context != context_)
+			{
+				logger().debug("Polygonal basis cache {} was computed for a different discretization, ignoring it", path);
+				return false;
+			}
+
+			uint64_t n_entries;
+			if (!read_value(in, n_entries))
+				return false;
+
+			std::unordered_map<Key, Eigen::MatrixXd, KeyHash> entries;
+			entries.reserve(n_entries);
+			for (uint64_t i = 0; i < n_entries; ++i)
+			{
+				Key key;
+				int64_t rows, cols;
+				if (!read_value(in, key) || !read_value(in, rows) || !read_value(in, cols) || rows < 0 || cols < 0)
+				{
+					logger().warn("Truncated polygonal basis cache {}, ignoring it", path);
+					return false;
+				}
+
+				Eigen::MatrixXd weights(rows, cols);
+				in.read(reinterpret_cast<char *>(weights.data()), weights.size() * sizeof(double));
+				if (!in)
+				{
+					logger().warn("Truncated polygonal basis cache {}, ignoring it", path);
+					return false;
+				}
+				entries.emplace(key, std::move(weights));
+			}
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			entries_ = std::move(entries);
+			logger().debug("Loaded {} polygonal bases from {}", entries_.size(), path);
+			return true;
+		}
+
+		bool PolygonalBasisCache::save(const std::string &path) const
+		{
+			std::ofstream out(path, std::ios::binary);
+			if (!out.is_open())
+			{
+				logger().error("Unable to save polygonal basis cache to {}", path);
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			out.write(MAGIC, sizeof(MAGIC));
+			write_value(out, VERSION);
+			write_value(out, uint64_t(context_.size()));
+			out.write(context_.data(), context_.size());
+
+			write_value(out, uint64_t(entries_.size()));
+			for (const auto &[key, weights] : entries_)
+			{
+				write_value(out, key);
+				write_value(out, int64_t(weights.rows()));
+				write_value(out, int64_t(weights.cols()));
+				out.write(reinterpret_cast<const char *>(weights.data()), weights.size() * sizeof(double));
+			}
+
+			return bool(out);
+		}
+	} // namespace basis
+} // namespace polyfem
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <polyfem/quadrature/Quadrature.hpp>
+
+#include <Eigen/Dense>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace polyfem
+{
+	namespace basis
+	{
+		///
+		/// @brief      Content-addressed cache of the RBF weights of the polygonal/polyhedral bases.
+		///
+		/// The key of a polytope is a 128-bit hash of the exact inputs of the weight computation
+		/// (kernel centers, collocation points, boundary values, integral constraints, and quadrature)
+		/// together with a context describing everything else the weights depend on (PDE, materials).
+		/// The cache can be saved to and loaded from disk to reuse the bases across runs on the same
+		/// mesh; find and insert are thread-safe.
+		///
+		class PolygonalBasisCache
+		{
+		public:
+			using Key = std::array<uint64_t, 2>;
+
+			///
+			/// @brief      Creates an empty cache
+			///
+			/// @param[in]  context  Description of the discretization the weights depend on,
+			///                      a cache is only loaded if its context matches
+			///
+			explicit PolygonalBasisCache(const std::string &context = "") : context_(context) {}
+
+			///
+			/// @brief      Computes the key of a polytope from the inputs of its RBF weights
+			///
+			/// @param[in]  integral_constraints   Order of the integral constraints
+			/// @param[in]  centers                #C x dim positions of the kernels
+			/// @param[in]  collocation_points     #S x dim collocation points
+			/// @param[in]  local_basis_integral   Integral constraints of the local bases
+			/// @param[in]  quadr                  Quadrature of the polytope
+			/// @param[in]  rhs                    Values of the local bases at the collocation points
+			///
+			/// @return     The key
+			///
+			Key key(const int integral_constraints,
+					const Eigen::MatrixXd &centers,
+					const Eigen::MatrixXd &collocation_points,
+					const Eigen::MatrixXd &local_basis_integral,
+					const quadrature::Quadrature &quadr,
+					const Eigen::MatrixXd &rhs) const;
+
+			/// @brief      Looks up the weights of a key, returns false if not cached
+			bool find(const Key &key, Eigen::MatrixXd &weights) const;
+			/// @brief      Stores the weights of a key
+			void insert(const Key &key, const Eigen::MatrixXd &weights);
+
+			///
+			/// @brief      Returns the RBF of a polytope from the cache, or builds and caches it
+			///
+			/// @param[in]  cache    Cache, can be null
+			/// @param[in]  key      Key of the polytope (unused if cache is null)
+			/// @param[in]  centers  #C x dim positions of the kernels
+			/// @param[in]  build    Function building the RBF from scratch
+			///
+			template <typename RBF, typename BuildFunction>
+			static std::shared_ptr<RBF> get_or_build(
+				PolygonalBasisCache *cache, const Key &key,
+				const Eigen::MatrixXd &centers, BuildFunction &&build)
+			{
+				if (cache == nullptr)
+					return build();
+
+				Eigen::MatrixXd weights;
+				if (cache->find(key, weights))
+					return std::make_shared<RBF>(centers, weights);
+
+				std::shared_ptr<RBF> rbf = build();
+				cache->insert(key, rbf->weights());
+				return rbf;
+			}
+
+			/// @brief      Removes all the entries and resets the statistics
+			void clear();
+
+			size_t size() const;
+			size_t hits() const { return hits_; }
+			size_t misses() const { return misses_; }
+			const std::string &context() const { return context_; }
+
+			///
+			/// @brief      Loads the entries of a cache file, replacing the current ones
+			///
+			/// @param[in]  path  Path of the file
+			///
+			/// @return     False if the file cannot be read or has a different context
+			///
+			bool load(const std::string &path);
+
+			///
+			/// @brief      Saves the entries to a binary file
+			///
+			/// @param[in]  path  Path of the file
+			///
+			/// @return     False if the file cannot be written
+			///
+			bool save(const std::string &path) const;
+
+		private:
+			struct KeyHash
+			{
+				size_t operator()(const Key &key) const { return key[0]; }
+			};
+
+			std::string context_;
+
+			mutable std::mutex mutex_;
+			std::unordered_map<Key, Eigen::MatrixXd, KeyHash> entries_;
+			mutable size_t hits_ = 0;
+			mutable size_t misses_ = 0;
+		};
+	} // namespace basis
+} // namespace polyfem
@@ -35,6 +35,18 @@ namespace polyfem
 							 const Eigen::MatrixXd &local_basis_integral, const quadrature::Quadrature &quadr,
 							 Eigen::MatrixXd &rhs, bool with_constraints = true);
 
+			///
+			/// @brief      Initialize RBF functions from precomputed weights (e.g., from a cache).
+			///
+			/// @param[in]  centers   #C x dim positions of the kernels
+			/// @param[in]  weights   weights as returned by weights()
+			///
+			RBFWithQuadratic(const Eigen::MatrixXd &centers, const Eigen::MatrixXd &weights)
+				: centers_(centers), weights_(weights) {}
+
+			/// @brief      Weights of the kernels and polynomial terms, one column per basis
+			const Eigen::MatrixXd &weights() const { return weights_; }
+
 			///
 			/// @brief      Evaluates one RBF function over a list of coordinates
 			///
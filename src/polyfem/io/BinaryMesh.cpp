@@ -0,0 +1,306 @@
+#include "BinaryMesh.hpp"
+
+#include <polyfem/io/MshReader.hpp>
+#include <polyfem/mesh/Mesh.hpp>
+#include <polyfem/utils/Logger.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace polyfem::io
+{
+	namespace
+	{
+		static_assert(sizeof(int) == sizeof(int32_t), "ids are stored as 32 bit integers");
+
+		constexpr char MAGIC[8] = {'P', 'F', 'B', 'M', 'E', 'S', 'H', '\0'};
+		constexpr uint32_t VERSION = 1;
+
+		struct Header
+		{
+			char magic[8];
+			uint32_t version;
+			int32_t dim;
+			int32_t cell_size;
+			int32_t face_size;
+			int64_t n_vertices;
+			int64_t n_cells;
+			int64_t n_body_ids;
+			int64_t n_boundary_ids;
+			int64_t n_edges;
+			int64_t n_faces;
+		};
+		static_assert(sizeof(Header) == 72, "the header must not be padded");
+
+		enum Section
+		{
+			VERTICES = 0,
+			CELLS,
+			BODY_IDS,
+			BOUNDARY_IDS,
+			EDGES,
+			FACES,
+			N_SECTIONS
+		};
+
+		size_t align(const size_t offset) { return (offset + 7) / 8 * 8; }
+
+		/// start of every section, the last entry is the size of the file
+		std::array<size_t, N_SECTIONS + 1> section_offsets(const Header &h)
+		{
+			const std::array<size_t, N_SECTIONS> sizes = {{
+				size_t(h.n_vertices) * h.dim * sizeof(double),
+				size_t(h.n_cells) * h.cell_size * sizeof(int32_t),
+				size_t(h.n_body_ids) * sizeof(int32_t),
+				size_t(h.n_boundary_ids) * sizeof(int32_t),
+				size_t(h.n_edges) * 2 * sizeof(int32_t),
+				size_t(h.n_faces) * h.face_size * sizeof(int32_t),
+			}};
+
+			std::array<size_t, N_SECTIONS + 1> offsets;
+			offsets[0] = align(sizeof(Header));
+			for (int i = 0; i < N_SECTIONS; ++i)
+				offsets[i + 1] = align(offsets[i] + sizes[i]);
+			return offsets;
+		}
+
+		bool is_valid(const Header &h, const size_t file_size)
+		{
+			if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION)
+				return false;
+			if ((h.dim != 2 && h.dim != 3) || h.cell_size <= 0 || h.face_size < 0)
+				return false;
+
+			// bound the counts by the file size before computing the offsets, to avoid overflows
+			for (const int64_t n : {h.n_vertices, h.n_cells, h.n_body_ids, h.n_boundary_ids, h.n_edges, h.n_faces})
+				if (n < 0 || size_t(n) > file_size)
+					return false;
+			if (h.n_body_ids != 0 && h.n_body_ids != h.n_cells)
+				return false;
+
+			return section_offsets(h).back() <= file_size;
+		}
+
+		void write_section(std::ostream &out, const void *data, const size_t size)
+		{
+			static const char padding[8] = {0};
+			out.write(reinterpret_cast<const char *>(data), size);
+			out.write(padding, align(size) - size);
+		}
+	} // namespace
+
+	BinaryMeshReader::~BinaryMeshReader()
+	{
+		close();
+	}
+
+	bool BinaryMeshReader::open(const std::string &path)
+	{
+		close();
+
+#ifndef _WIN32
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header))
+		{
+			::close(fd);
+			return false;
+		}
+
+		size_ = st.st_size;
+		void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (data == MAP_FAILED)
+		{
+			size_ = 0;
+			return false;
+		}
+		data_ = static_cast<const char *>(data);
+		mapped_ = true;
+#else
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in.is_open())
+			return false;
+
+		size_ = in.tellg();
+		if (size_ < sizeof(Header))
+			return false;
+
+		buffer_.resize((size_ + 7) / 8);
+		in.seekg(0);
+		in.read(reinterpret_cast<char *>(buffer_.data()), size_);
+		if (!in)
+		{
+			buffer_.clear();
+			return false;
+		}
+		data_ = reinterpret_cast<const char *>(buffer_.data());
+#endif
+
+		Header h;
+		std::memcpy(&h, data_, sizeof(Header));
+		if (!is_valid(h, size_))
+		{
+			logger().error("Invalid binary mesh {}", path);
+			close();
+			return false;
+		}
+
+		dim_ = h.dim;
+		cell_size_ = h.cell_size;
+		face_size_ = h.face_size;
+		n_vertices_ = h.n_vertices;
+		n_cells_ = h.n_cells;
+		n_body_ids_ = h.n_body_ids;
+		n_boundary_ids_ = h.n_boundary_ids;
+		n_edges_ = h.n_edges;
+		n_faces_ = h.n_faces;
+		offsets_ = section_offsets(h);
+
+		return true;
+	}
+
+	void BinaryMeshReader::close()
+	{
+#ifndef _WIN32
+		if (mapped_)
+			munmap(const_cast<char *>(data_), size_);
+#endif
+		buffer_.clear();
+		buffer_.shrink_to_fit();
+		data_ = nullptr;
+		size_ = 0;
+		mapped_ = false;
+		dim_ = 0;
+	}
+
+	Eigen::Map<const Eigen::MatrixXd> BinaryMeshReader::vertices() const
+	{
+		assert(is_open());
+		return Eigen::Map<const Eigen::MatrixXd>(section<double>(VERTICES), n_vertices_, dim_);
+	}
+
+	Eigen::Map<const Eigen::MatrixXi> BinaryMeshReader::cells() const
+	{
+		assert(is_open());
+		return Eigen::Map<const Eigen::MatrixXi>(section<int>(CELLS), n_cells_, cell_size_);
+	}
+
+	Eigen::Map<const Eigen::MatrixXi> BinaryMeshReader::edges() const
+	{
+		assert(is_open());
+		return Eigen::Map<const Eigen::MatrixXi>(section<int>(EDGES), n_edges_, 2);
+	}
+
+	Eigen::Map<const Eigen::MatrixXi> BinaryMeshReader::faces() const
+	{
+		assert(is_open());
+		return Eigen::Map<const Eigen::MatrixXi>(section<int>(FACES), n_faces_, face_size_);
+	}
+
+	std::vector<int> BinaryMeshReader::body_ids() const
+	{
+		assert(is_open());
+		const int *ids = section<int>(BODY_IDS);
+		return std::vector<int>(ids, ids + n_body_ids_);
+	}
+
+	std::vector<int> BinaryMeshReader::boundary_ids() const
+	{
+		assert(is_open());
+		const int *ids = section<int>(BOUNDARY_IDS);
+		return std::vector<int>(ids, ids + n_boundary_ids_);
+	}
+
+	bool BinaryMeshWriter::write(
+		const std::string &path,
+		const Eigen::MatrixXd &vertices,
+		const Eigen::MatrixXi &cells,
+		const std::vector<int> &body_ids,
+		const std::vector<int> &boundary_ids)
+	{
+		const int dim = vertices.cols();
+		if (dim != 2 && dim != 3)
+		{
+			logger().error("Binary meshes must be 2D or 3D, the vertices have {} columns", dim);
+			return false;
+		}
+		if (!body_ids.empty() && body_ids.size() != cells.rows())
+		{
+			logger().error("Binary meshes need one body id per cell ({} ids for {} cells)", body_ids.size(), cells.rows());
+			return false;
+		}
+
+		Eigen::MatrixXi edges, faces;
+		mesh::Mesh::build_in_ordered_primitives(dim, cells, edges, faces);
+
+		Header h;
+		std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+		h.version = VERSION;
+		h.dim = dim;
+		h.cell_size = cells.cols();
+		h.face_size = faces.cols();
+		h.n_vertices = vertices.rows();
+		h.n_cells = cells.rows();
+		h.n_body_ids = body_ids.size();
+		h.n_boundary_ids = boundary_ids.size();
+		h.n_edges = edges.rows();
+		h.n_faces = faces.rows();
+
+		std::ofstream out(path, std::ios::binary);
+		if (!out.is_open())
+		{
+			logger().error("Unable to save binary mesh to {}", path);
+			return false;
+		}
+
+		write_section(out, &h, sizeof(Header));
+		write_section(out, vertices.data(), vertices.size() * sizeof(double));
+		write_section(out, cells.data(), cells.size() * sizeof(int32_t));
+		write_section(out, body_ids.data(), body_ids.size() * sizeof(int32_t));
+		write_section(out, boundary_ids.data(), boundary_ids.size() * sizeof(int32_t));
+		write_section(out, edges.data(), edges.size() * sizeof(int32_t));
+		write_section(out, faces.data(), faces.size() * sizeof(int32_t));
+
+		assert(!out || size_t(out.tellp()) == section_offsets(h).back());
+		return bool(out);
+	}
+
+	bool BinaryMeshWriter::convert_msh(const std::string &msh_path, const std::string &path)
+	{
+		Eigen::MatrixXd vertices;
+		Eigen::MatrixXi cells;
+		std::vector<std::vector<int>> elements;
+		std::vector<std::vector<double>> weights;
+		std::vector<int> body_ids;
+
+		if (!MshReader::load(msh_path, vertices, cells, elements, weights, body_ids))
+		{
+			logger().error("Failed to load MSH mesh: {}", msh_path);
+			return false;
+		}
+
+		for (int c = 0; c < cells.rows(); ++c)
+		{
+			if (elements[c].size() != cells.cols() || !weights[c].empty())
+			{
+				logger().error("Only linear meshes can be converted to the binary format: {}", msh_path);
+				return false;
+			}
+		}
+
+		logger().info("Converting {} ({} vertices, {} cells) to {}", msh_path, vertices.rows(), cells.rows(), path);
+		return write(path, vertices, cells, body_ids);
+	}
+} // namespace polyfem::io
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace polyfem::io
+{
+	/// @brief Reader of the native binary mesh format (.pfm)
+	///
+	/// A .pfm file stores, in column-major order and aligned to 8 bytes, the vertices, the cells,
+	/// the body and boundary ids, and the unique edges and faces of the mesh (in the order of
+	/// Mesh::in_ordered_edges and Mesh::in_ordered_faces). The file is memory mapped and the
+	/// arrays are exposed as maps on the mapped memory, they are valid while the reader is open.
+	class BinaryMeshReader
+	{
+	public:
+		BinaryMeshReader() = default;
+		~BinaryMeshReader();
+
+		BinaryMeshReader(const BinaryMeshReader &) = delete;
+		BinaryMeshReader &operator=(const BinaryMeshReader &) = delete;
+
+		/// @brief maps the file
+		/// @param[in] path path of the .pfm file
+		/// @return false if the file cannot be read or is not a valid binary mesh
+		bool open(const std::string &path);
+
+		/// @brief unmaps the file, the maps returned before are invalidated
+		void close();
+
+		bool is_open() const { return data_ != nullptr; }
+
+		/// @brief dimension of the mesh, 2 or 3
+		int dimension() const { return dim_; }
+
+		/// @brief #V x dim vertices
+		Eigen::Map<const Eigen::MatrixXd> vertices() const;
+		/// @brief #C x n cells
+		Eigen::Map<const Eigen::MatrixXi> cells() const;
+		/// @brief #E x 2 unique edges
+		Eigen::Map<const Eigen::MatrixXi> edges() const;
+		/// @brief #F x 3 unique faces, empty for 2D and hex meshes
+		Eigen::Map<const Eigen::MatrixXi> faces() const;
+
+		/// @brief one id per cell, empty if the file has none
+		std::vector<int> body_ids() const;
+		/// @brief one id per boundary primitive, empty if the file has none
+		std::vector<int> boundary_ids() const;
+
+	private:
+		/// @brief pointer to the i-th section of the file
+		template <typename T>
+		const T *section(const int i) const { return reinterpret_cast<const T *>(data_ + offsets_[i]); }
+
+		const char *data_ = nullptr;
+		size_t size_ = 0;
+		bool mapped_ = false;
+		/// content of the file when memory mapping is not available
+		std::vector<uint64_t> buffer_;
+
+		int dim_ = 0;
+		int cell_size_ = 0;
+		int face_size_ = 0;
+		int64_t n_vertices_ = 0;
+		int64_t n_cells_ = 0;
+		int64_t n_body_ids_ = 0;
+		int64_t n_boundary_ids_ = 0;
+		int64_t n_edges_ = 0;
+		int64_t n_faces_ = 0;
+		std::array<size_t, 7> offsets_;
+	};
+
+	/// @brief Writer of the native binary mesh format (.pfm), see BinaryMeshReader
+	class BinaryMeshWriter
+	{
+	public:
+		BinaryMeshWriter() = delete;
+
+		/// @brief saves the mesh, the unique edges and faces are computed here
+		/// @param[in] path output path
+		/// @param[in] vertices #V x dim vertices
+		/// @param[in] cells #C x n cells (triangles, quads, tets, or hexes)
+		/// @param[in] body_ids one per cell, or empty
+		/// @param[in] boundary_ids one per boundary primitive of the mesh built from vertices and cells, or empty
+		/// @return if success
+		static bool write(
+			const std::string &path,
+			const Eigen::MatrixXd &vertices,
+			const Eigen::MatrixXi &cells,
+			const std::vector<int> &body_ids,
+			const std::vector<int> &boundary_ids = {});
+
+		/// @brief converts a linear MSH mesh to the binary format
+		/// @param[in] msh_path input MSH path
+		/// @param[in] path output path
+		/// @return if success
+		static bool convert_msh(const std::string &msh_path, const std::string &path);
+	};
+} // namespace polyfem::io
@@ -14,10 +14,14 @@
 #include <polyfem/autogen/auto_q_bases.hpp>
 
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 
 #include <igl/AABB.h>
 #include <igl/per_face_normals.h>
 
+#include <atomic>
+#include <functional>
+
 namespace polyfem::io
 {
 	using namespace mesh;
@@ -51,6 +55,167 @@ namespace polyfem::io
 				logger().error("Invalid tensor dimensions.");
 			}
 		}
+
+		/// per thread temporaries of the element loops
+		struct LocalThreadStorage
+		{
+			Eigen::MatrixXd local_pts;
+			std::vector<AssemblyValues> basis_values;
+			std::vector<Assembler::NamedMatrix> values;
+		};
+
+		/// points of element i where the output is sampled
+		/// @param[in] poly_pts sampled polygons, see output_layout
+		/// @return false if element i is not exported
+		bool output_points(
+			const Mesh &mesh,
+			const int i,
+			const Eigen::VectorXi &disc_orders,
+			const utils::RefElementSampler &sampler,
+			const std::map<int, Eigen::MatrixXd> &poly_pts,
+			const bool use_sampler,
+			const bool boundary_only,
+			Eigen::MatrixXd &local_pts)
+		{
+			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
+				return false;
+
+			if (use_sampler)
+			{
+				if (mesh.is_simplex(i))
+					local_pts = sampler.simplex_points();
+				else if (mesh.is_cube(i))
+					local_pts = sampler.cube_points();
+				else
+					local_pts = poly_pts.at(i);
+			}
+			else
+			{
+				if (mesh.is_volume())
+				{
+					if (mesh.is_simplex(i))
+						autogen::p_nodes_3d(disc_orders(i), local_pts);
+					else if (mesh.is_cube(i))
+						autogen::q_nodes_3d(disc_orders(i), local_pts);
+					else
+						return false;
+				}
+				else
+				{
+					if (mesh.is_simplex(i))
+						autogen::p_nodes_2d(disc_orders(i), local_pts);
+					else if (mesh.is_cube(i))
+						autogen::q_nodes_2d(disc_orders(i), local_pts);
+					else
+						return false;
+				}
+			}
+
+			return true;
+		}
+
+		/// samples the polygons and computes where the output of every element starts, element i writes
+		/// the rows [offsets[i], offsets[i+1]). The polygons are sampled here, serially, since the
+		/// triangulation is not thread safe, so that the element loops can run in parallel.
+		void output_layout(
+			const Mesh &mesh,
+			const int n_elements,
+			const Eigen::VectorXi &disc_orders,
+			const std::map<int, Eigen::MatrixXd> &polys,
+			const std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &polys_3d,
+			const utils::RefElementSampler &sampler,
+			const bool use_sampler,
+			const bool boundary_only,
+			std::map<int, Eigen::MatrixXd> &poly_pts,
+			std::vector<int> &offsets)
+		{
+			Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
+			Eigen::MatrixXd local_pts;
+
+			poly_pts.clear();
+			offsets.assign(n_elements + 1, 0);
+			for (int i = 0; i < n_elements; ++i)
+			{
+				const bool skip = boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i);
+				if (use_sampler && !skip && !mesh.is_simplex(i) && !mesh.is_cube(i))
+				{
+					if (mesh.is_volume())
+						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, poly_pts[i], vis_faces_poly, vis_edges_poly);
+					else
+						sampler.sample_polygon(polys.at(i), poly_pts[i], vis_faces_poly, vis_edges_poly);
+				}
+
+				offsets[i + 1] = offsets[i];
+				if (output_points(mesh, i, disc_orders, sampler, poly_pts, use_sampler, boundary_only, local_pts))
+					offsets[i + 1] += local_pts.rows();
+			}
+		}
+
+		/// evaluates values of the assembler at the output points of every element, in parallel
+		/// @param[in] n_cols number of columns of the values
+		/// @param[in] evaluate computes the values of element i at the local points
+		/// @param[out] result values, named as the ones of the first exported element
+		void compute_output_values(
+			const Mesh &mesh,
+			const int n_elements,
+			const Eigen::VectorXi &disc_orders,
+			const std::map<int, Eigen::MatrixXd> &polys,
+			const std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &polys_3d,
+			const utils::RefElementSampler &sampler,
+			const int n_points,
+			const int n_cols,
+			const std::function<void(const int, const Eigen::MatrixXd &, std::vector<Assembler::NamedMatrix> &)> &evaluate,
+			std::vector<Assembler::NamedMatrix> &result,
+			const bool use_sampler,
+			const bool boundary_only)
+		{
+			std::map<int, Eigen::MatrixXd> poly_pts;
+			std::vector<int> offsets;
+			output_layout(mesh, n_elements, disc_orders, polys, polys_3d, sampler, use_sampler, boundary_only, poly_pts, offsets);
+			assert(offsets.back() <= n_points);
+
+			const auto store = [&](const int i, const std::vector<Assembler::NamedMatrix> &values) {
+				for (int k = 0; k < values.size(); ++k)
+				{
+					assert(offsets[i + 1] - offsets[i] == values[k].second.rows());
+					result[k].second.block(offsets[i], 0, values[k].second.rows(), values[k].second.cols()) = values[k].second;
+				}
+			};
+
+			// the names of the values are known once the first exported element is evaluated
+			int first = 0;
+			while (first < n_elements && offsets[first + 1] == offsets[first])
+				++first;
+			if (first == n_elements)
+				return;
+
+			LocalThreadStorage first_storage;
+			output_points(mesh, first, disc_orders, sampler, poly_pts, use_sampler, boundary_only, first_storage.local_pts);
+			evaluate(first, first_storage.local_pts, first_storage.values);
+
+			result.resize(first_storage.values.size());
+			for (int k = 0; k < result.size(); ++k)
+			{
+				result[k].first = first_storage.values[k].first;
+				result[k].second.resize(n_points, n_cols);
+			}
+			store(first, first_storage.values);
+
+			// every element writes its own rows, the result does not depend on the number of threads
+			auto storage = utils::create_thread_storage(LocalThreadStorage());
+			utils::maybe_parallel_for(n_elements - first - 1, [&](int start, int end, int thread_id) {
+				LocalThreadStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+
+				for (int i = first + 1 + start; i < first + 1 + end; ++i)
+				{
+					if (!output_points(mesh, i, disc_orders, sampler, poly_pts, use_sampler, boundary_only, local_storage.local_pts))
+						continue;
+
+					evaluate(i, local_storage.local_pts, local_storage.values);
+					store(i, local_storage.values);
+				}
+			});
+		}
 	} // namespace
 
 	void Evaluator::get_sidesets(
@@ -168,9 +333,6 @@ namespace polyfem::io
 
 		const Mesh3D &mesh3d = dynamic_cast<const Mesh3D &>(mesh);
 
-		Eigen::MatrixXd points, uv;
-		Eigen::VectorXd weights;
-
 		int actual_dim = 1;
 		if (!is_problem_scalar)
 			actual_dim = 3;
@@ -181,62 +343,77 @@ namespace polyfem::io
 		result.resize(faces.rows(), actual_dim);
 		result.setConstant(std::numeric_limits<double>::quiet_NaN());
 
-		int counter = 0;
+		// the faces are evaluated in parallel and written serially, in the order of the elements
+		std::vector<std::vector<std::pair<int, RowVectorNd>>> el_values(mesh3d.n_elements());
 
-		for (int e = 0; e < mesh3d.n_elements(); ++e)
-		{
-			const basis::ElementBases &gbs = gbases[e];
-			const basis::ElementBases &bs = bases[e];
+		utils::maybe_parallel_for(mesh3d.n_elements(), [&](int start, int end, int thread_id) {
+			Eigen::MatrixXd points, uv;
+			Eigen::VectorXd weights;
+			ElementAssemblyValues vals;
 
-			for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+			for (int e = start; e < end; ++e)
 			{
-				const int face_id = mesh3d.cell_face(e, lf);
-				if (!mesh3d.is_boundary_face(face_id))
-					continue;
+				const basis::ElementBases &gbs = gbases[e];
+				const basis::ElementBases &bs = bases[e];
 
-				if (mesh3d.is_simplex(e))
-					utils::BoundarySampler::quadrature_for_tri_face(lf, 4, face_id, mesh3d, uv, points, weights);
-				else if (mesh3d.is_cube(e))
-					utils::BoundarySampler::quadrature_for_quad_face(lf, 4, face_id, mesh3d, uv, points, weights);
-				else
-					assert(false);
+				for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+				{
+					const int face_id = mesh3d.cell_face(e, lf);
+					if (!mesh3d.is_boundary_face(face_id))
+						continue;
 
-				ElementAssemblyValues vals;
-				vals.compute(e, true, points, bs, gbs);
-				RowVectorNd loc_val(actual_dim);
-				loc_val.setZero();
+					if (mesh3d.is_simplex(e))
+						utils::BoundarySampler::quadrature_for_tri_face(lf, 4, face_id, mesh3d, uv, points, weights);
+					else if (mesh3d.is_cube(e))
+						utils::BoundarySampler::quadrature_for_quad_face(lf, 4, face_id, mesh3d, uv, points, weights);
+					else
+						assert(false);
 
-				// UIEvaluator::ui_state().debug_data().add_points(vals.val, Eigen::RowVector3d(1,0,0));
+					vals.compute(e, true, points, bs, gbs);
+					RowVectorNd loc_val(actual_dim);
+					loc_val.setZero();
 
-				// const auto nodes = bs.local_nodes_for_primitive(face_id, mesh3d);
+					// UIEvaluator::ui_state().debug_data().add_points(vals.val, Eigen::RowVector3d(1,0,0));
 
-				// for(long n = 0; n < nodes.size(); ++n)
-				for (size_t j = 0; j < bs.bases.size(); ++j)
-				{
-					// const auto &b = bs.bases[nodes(n)];
-					// const AssemblyValues &v = vals.basis_values[nodes(n)];
-					const AssemblyValues &v = vals.basis_values[j];
-					for (int d = 0; d < actual_dim; ++d)
+					// const auto nodes = bs.local_nodes_for_primitive(face_id, mesh3d);
+
+					// for(long n = 0; n < nodes.size(); ++n)
+					for (size_t j = 0; j < bs.bases.size(); ++j)
 					{
-						for (size_t g = 0; g < v.global.size(); ++g)
+						// const auto &b = bs.bases[nodes(n)];
+						// const AssemblyValues &v = vals.basis_values[nodes(n)];
+						const AssemblyValues &v = vals.basis_values[j];
+						for (int d = 0; d < actual_dim; ++d)
 						{
-							loc_val(d) += (v.global[g].val * v.val.array() * fun(v.global[g].index * actual_dim + d) * weights.array()).sum();
+							for (size_t g = 0; g < v.global.size(); ++g)
+							{
+								loc_val(d) += (v.global[g].val * v.val.array() * fun(v.global[g].index * actual_dim + d) * weights.array()).sum();
+							}
 						}
 					}
-				}
 
-				int I;
-				Eigen::RowVector3d C;
-				const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
+					int I;
+					Eigen::RowVector3d C;
+					const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
 
-				const double dist = tree.squared_distance(pts, faces, bary, I, C);
-				assert(dist < 1e-16);
+					const double dist = tree.squared_distance(pts, faces, bary, I, C);
+					assert(dist < 1e-16);
+
+					if (compute_avg)
+						el_values[e].emplace_back(I, loc_val / weights.sum());
+					else
+						el_values[e].emplace_back(I, loc_val);
+				}
+			}
+		});
 
+		int counter = 0;
+		for (const auto &values : el_values)
+		{
+			for (const auto &[I, loc_val] : values)
+			{
 				assert(std::isnan(result(I, 0)));
-				if (compute_avg)
-					result.row(I) = loc_val / weights.sum();
-				else
-					result.row(I) = loc_val;
+				result.row(I) = loc_val;
 				++counter;
 			}
 		}
@@ -269,8 +446,6 @@ namespace polyfem::io
 
 		const Mesh3D &mesh3d = dynamic_cast<const Mesh3D &>(mesh);
 
-		Eigen::MatrixXd points;
-
 		int actual_dim = 1;
 		if (!is_problem_scalar)
 			actual_dim = 3;
@@ -281,72 +456,84 @@ namespace polyfem::io
 		result.resize(pts.rows(), actual_dim);
 		result.setZero();
 
-		for (int e = 0; e < mesh3d.n_elements(); ++e)
-		{
-			const ElementBases &gbs = gbases[e];
-			const ElementBases &bs = bases[e];
+		// the faces are evaluated in parallel and written serially, in the order of the elements,
+		// so that the vertices shared by several faces get the value of the last one as in serial
+		std::vector<std::vector<std::pair<int, RowVectorNd>>> el_values(mesh3d.n_elements());
+
+		utils::maybe_parallel_for(mesh3d.n_elements(), [&](int start, int end, int thread_id) {
+			Eigen::MatrixXd points;
+			ElementAssemblyValues vals;
 
-			for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+			for (int e = start; e < end; ++e)
 			{
-				const int face_id = mesh3d.cell_face(e, lf);
-				// if (!mesh3d.is_boundary_face(face_id))
-				//     continue;
-				int I;
-				Eigen::RowVector3d C;
-				const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
-
-				const double dist = tree.squared_distance(pts, faces, bary, I, C);
-				if (dist > 1e-15)
-					continue;
+				const ElementBases &gbs = gbases[e];
+				const ElementBases &bs = bases[e];
 
-				if (mesh3d.is_simplex(e))
-					autogen::p_nodes_3d(1, points);
-				else if (mesh3d.is_cube(e))
-					autogen::q_nodes_3d(1, points);
-				else
-					assert(false);
+				for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+				{
+					const int face_id = mesh3d.cell_face(e, lf);
+					// if (!mesh3d.is_boundary_face(face_id))
+					//     continue;
+					int I;
+					Eigen::RowVector3d C;
+					const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
+
+					const double dist = tree.squared_distance(pts, faces, bary, I, C);
+					if (dist > 1e-15)
+						continue;
 
-				ElementAssemblyValues vals;
-				vals.compute(e, true, points, bs, gbs);
-				Eigen::MatrixXd loc_val(points.rows(), actual_dim);
-				loc_val.setZero();
+					if (mesh3d.is_simplex(e))
+						autogen::p_nodes_3d(1, points);
+					else if (mesh3d.is_cube(e))
+						autogen::q_nodes_3d(1, points);
+					else
+						assert(false);
 
-				// UIEvaluator::ui_state().debug_data().add_points(vals.val, Eigen::RowVector3d(1,0,0));
+					vals.compute(e, true, points, bs, gbs);
+					Eigen::MatrixXd loc_val(points.rows(), actual_dim);
+					loc_val.setZero();
 
-				for (size_t j = 0; j < bs.bases.size(); ++j)
-				{
-					const Basis &b = bs.bases[j];
-					const AssemblyValues &v = vals.basis_values[j];
+					// UIEvaluator::ui_state().debug_data().add_points(vals.val, Eigen::RowVector3d(1,0,0));
 
-					for (int d = 0; d < actual_dim; ++d)
+					for (size_t j = 0; j < bs.bases.size(); ++j)
 					{
-						for (size_t ii = 0; ii < b.global().size(); ++ii)
-							loc_val.col(d) += b.global()[ii].val * v.val * fun(b.global()[ii].index * actual_dim + d);
+						const Basis &b = bs.bases[j];
+						const AssemblyValues &v = vals.basis_values[j];
+
+						for (int d = 0; d < actual_dim; ++d)
+						{
+							for (size_t ii = 0; ii < b.global().size(); ++ii)
+								loc_val.col(d) += b.global()[ii].val * v.val * fun(b.global()[ii].index * actual_dim + d);
+						}
 					}
-				}
 
-				for (int lv_id = 0; lv_id < faces.cols(); ++lv_id)
-				{
-					const int v_id = faces(I, lv_id);
-					const auto p = pts.row(v_id);
-					const auto &mapped = vals.val;
+					for (int lv_id = 0; lv_id < faces.cols(); ++lv_id)
+					{
+						const int v_id = faces(I, lv_id);
+						const auto p = pts.row(v_id);
+						const auto &mapped = vals.val;
 
-					bool found = false;
+						bool found = false;
 
-					for (int n = 0; n < mapped.rows(); ++n)
-					{
-						if ((p - mapped.row(n)).norm() < 1e-10)
+						for (int n = 0; n < mapped.rows(); ++n)
 						{
-							result.row(v_id) = loc_val.row(n);
-							found = true;
-							break;
+							if ((p - mapped.row(n)).norm() < 1e-10)
+							{
+								el_values[e].emplace_back(v_id, loc_val.row(n));
+								found = true;
+								break;
+							}
 						}
-					}
 
-					assert(found);
+						assert(found);
+					}
 				}
 			}
-		}
+		});
+
+		for (const auto &values : el_values)
+			for (const auto &[v_id, loc_val] : values)
+				result.row(v_id) = loc_val;
 	}
 
 	void Evaluator::interpolate_boundary_tensor_function(
@@ -410,8 +597,6 @@ namespace polyfem::io
 			return;
 		}
 
-		std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_t, tmp_s;
-
 		assert(mesh.is_volume());
 		assert(!is_problem_scalar);
 
@@ -420,9 +605,6 @@ namespace polyfem::io
 		Eigen::MatrixXd normals;
 		igl::per_face_normals((pts + disp).eval(), faces, normals);
 
-		Eigen::MatrixXd points, uv, tmp_n, loc_v;
-		Eigen::VectorXd weights;
-
 		const int actual_dim = 3;
 
 		igl::AABB<Eigen::MatrixXd, 3> tree;
@@ -437,120 +619,143 @@ namespace polyfem::io
 		mises.resize(faces.rows(), 1);
 		mises.setConstant(std::numeric_limits<double>::quiet_NaN());
 
-		int counter = 0;
-
-		for (int e = 0; e < mesh3d.n_elements(); ++e)
+		struct FaceValues
 		{
-			const ElementBases &gbs = gbases[e];
-			const ElementBases &bs = bases[e];
-
-			for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
+			int face;
+			Eigen::RowVector3d traction;
+			Eigen::VectorXd stress;
+			double mises;
+		};
+
+		// the faces are evaluated in parallel and written serially, in the order of the elements
+		std::vector<std::vector<FaceValues>> el_values(mesh3d.n_elements());
+
+		utils::maybe_parallel_for(mesh3d.n_elements(), [&](int start, int end, int thread_id) {
+			std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_t, tmp_s;
+			Eigen::MatrixXd points, uv, tmp_n, loc_v;
+			Eigen::VectorXd weights;
+			ElementAssemblyValues vals;
+
+			for (int e = start; e < end; ++e)
 			{
-				const int face_id = mesh3d.cell_face(e, lf);
-				// if (!mesh3d.is_boundary_face(face_id))
-				//     continue;
+				const ElementBases &gbs = gbases[e];
+				const ElementBases &bs = bases[e];
 
-				int I;
-				Eigen::RowVector3d C;
-				const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
-
-				const double dist = tree.squared_distance(pts, faces, bary, I, C);
-				if (dist > 1e-15)
-					continue;
-
-				int lfid = 0;
-				for (; lfid < mesh3d.n_cell_faces(e); ++lfid)
+				for (int lf = 0; lf < mesh3d.n_cell_faces(e); ++lf)
 				{
-					if (mesh.is_simplex(e))
-						loc_v = utils::BoundarySampler::tet_local_node_coordinates_from_face(lfid);
-					else if (mesh.is_cube(e))
-						loc_v = utils::BoundarySampler::hex_local_node_coordinates_from_face(lfid);
-					else
-						assert(false);
+					const int face_id = mesh3d.cell_face(e, lf);
+					// if (!mesh3d.is_boundary_face(face_id))
+					//     continue;
 
-					ElementAssemblyValues vals;
-					vals.compute(e, true, loc_v, bs, gbs);
+					int I;
+					Eigen::RowVector3d C;
+					const Eigen::RowVector3d bary = mesh3d.face_barycenter(face_id);
 
-					int count = 0;
+					const double dist = tree.squared_distance(pts, faces, bary, I, C);
+					if (dist > 1e-15)
+						continue;
 
-					for (int lv_id = 0; lv_id < faces.cols(); ++lv_id)
+					int lfid = 0;
+					for (; lfid < mesh3d.n_cell_faces(e); ++lfid)
 					{
-						const int v_id = faces(I, lv_id);
-						const auto p = pts.row(v_id);
-						const auto &mapped = vals.val;
-						assert(mapped.rows() == faces.cols());
+						if (mesh.is_simplex(e))
+							loc_v = utils::BoundarySampler::tet_local_node_coordinates_from_face(lfid);
+						else if (mesh.is_cube(e))
+							loc_v = utils::BoundarySampler::hex_local_node_coordinates_from_face(lfid);
+						else
+							assert(false);
 
-						for (int n = 0; n < mapped.rows(); ++n)
+						vals.compute(e, true, loc_v, bs, gbs);
+
+						int count = 0;
+
+						for (int lv_id = 0; lv_id < faces.cols(); ++lv_id)
 						{
-							if ((p - mapped.row(n)).norm() < 1e-10)
+							const int v_id = faces(I, lv_id);
+							const auto p = pts.row(v_id);
+							const auto &mapped = vals.val;
+							assert(mapped.rows() == faces.cols());
+
+							for (int n = 0; n < mapped.rows(); ++n)
 							{
-								count++;
-								break;
+								if ((p - mapped.row(n)).norm() < 1e-10)
+								{
+									count++;
+									break;
+								}
 							}
 						}
-					}
 
-					if (count == faces.cols())
-						break;
-				}
-				assert(lfid < mesh3d.n_cell_faces(e));
-
-				if (mesh.is_simplex(e))
-				{
-					utils::BoundarySampler::quadrature_for_tri_face(lfid, 4, face_id, mesh3d, uv, points, weights);
-					utils::BoundarySampler::normal_for_tri_face(lfid, tmp_n);
-				}
-				else if (mesh.is_cube(e))
-				{
-					utils::BoundarySampler::quadrature_for_quad_face(lfid, 4, face_id, mesh3d, uv, points, weights);
-					utils::BoundarySampler::normal_for_quad_face(lfid, tmp_n);
-				}
-				else
-					assert(false);
+						if (count == faces.cols())
+							break;
+					}
+					assert(lfid < mesh3d.n_cell_faces(e));
 
-				Eigen::RowVector3d tet_n;
-				tet_n.setZero();
-				ElementAssemblyValues vals;
-				vals.compute(e, true, points, bs, gbs);
-				for (int n = 0; n < vals.jac_it.size(); ++n)
-				{
-					Eigen::RowVector3d tmp = tmp_n * vals.jac_it[n];
-					tmp.normalize();
-					tet_n += tmp;
-				}
+					if (mesh.is_simplex(e))
+					{
+						utils::BoundarySampler::quadrature_for_tri_face(lfid, 4, face_id, mesh3d, uv, points, weights);
+						utils::BoundarySampler::normal_for_tri_face(lfid, tmp_n);
+					}
+					else if (mesh.is_cube(e))
+					{
+						utils::BoundarySampler::quadrature_for_quad_face(lfid, 4, face_id, mesh3d, uv, points, weights);
+						utils::BoundarySampler::normal_for_quad_face(lfid, tmp_n);
+					}
+					else
+						assert(false);
 
-				assembler.compute_scalar_value(OutputData(t, e, bs, gbs, points, fun), tmp_s);
-				assembler.compute_tensor_value(OutputData(t, e, bs, gbs, points, fun), tmp_t);
+					Eigen::RowVector3d tet_n;
+					tet_n.setZero();
+					vals.compute(e, true, points, bs, gbs);
+					for (int n = 0; n < vals.jac_it.size(); ++n)
+					{
+						Eigen::RowVector3d tmp = tmp_n * vals.jac_it[n];
+						tmp.normalize();
+						tet_n += tmp;
+					}
 
-				Eigen::MatrixXd loc_val = tmp_t[0].second, local_mises = tmp_s[0].second;
-				Eigen::VectorXd tmp(loc_val.cols());
-				const double tmp_mises = (local_mises.array() * weights.array()).sum();
+					assembler.compute_scalar_value(OutputData(t, e, bs, gbs, points, fun), tmp_s);
+					assembler.compute_tensor_value(OutputData(t, e, bs, gbs, points, fun), tmp_t);
 
-				for (int d = 0; d < loc_val.cols(); ++d)
-					tmp(d) = (loc_val.col(d).array() * weights.array()).sum();
-				const Eigen::MatrixXd tensor = Eigen::Map<Eigen::MatrixXd>(tmp.data(), 3, 3);
+					const Eigen::MatrixXd &loc_val = tmp_t[0].second, &local_mises = tmp_s[0].second;
+					Eigen::VectorXd tmp(loc_val.cols());
+					double tmp_mises = (local_mises.array() * weights.array()).sum();
 
-				const Eigen::RowVector3d tmpn = normals.row(I);
-				const Eigen::RowVector3d tmptf = tmpn * tensor;
-				if (skip_orientation || tmpn.dot(tet_n) > 0)
-				{
-					assert(std::isnan(result(I, 0)));
-					assert(std::isnan(stresses(I, 0)));
-					assert(std::isnan(mises(I)));
+					for (int d = 0; d < loc_val.cols(); ++d)
+						tmp(d) = (loc_val.col(d).array() * weights.array()).sum();
+					const Eigen::MatrixXd tensor = Eigen::Map<Eigen::MatrixXd>(tmp.data(), 3, 3);
 
-					result.row(I) = tmptf;
-					stresses.row(I) = tmp;
-					mises(I) = tmp_mises;
-
-					if (compute_avg)
+					const Eigen::RowVector3d tmpn = normals.row(I);
+					Eigen::RowVector3d tmptf = tmpn * tensor;
+					if (skip_orientation || tmpn.dot(tet_n) > 0)
 					{
-						result.row(I) /= weights.sum();
-						stresses.row(I) /= weights.sum();
-						mises(I) /= weights.sum();
+						if (compute_avg)
+						{
+							tmptf /= weights.sum();
+							tmp /= weights.sum();
+							tmp_mises /= weights.sum();
+						}
+
+						el_values[e].push_back({I, tmptf, tmp, tmp_mises});
 					}
-					++counter;
 				}
 			}
+		});
+
+		int counter = 0;
+		for (const auto &values : el_values)
+		{
+			for (const FaceValues &v : values)
+			{
+				assert(std::isnan(result(v.face, 0)));
+				assert(std::isnan(stresses(v.face, 0)));
+				assert(std::isnan(mises(v.face)));
+
+				result.row(v.face) = v.traction;
+				stresses.row(v.face) = v.stress;
+				mises(v.face) = v.mises;
+				++counter;
+			}
 		}
 
 		assert(counter == result.rows());
@@ -592,49 +797,60 @@ namespace polyfem::io
 		assert(!is_problem_scalar);
 		const int actual_dim = mesh.dimension();
 
+		// the element values are computed in parallel and accumulated serially, in the order of the elements
+		std::vector<double> el_areas(bases.size(), 0);
+		std::vector<std::vector<Assembler::NamedMatrix>> el_values(bases.size());
+
+		auto storage = utils::create_thread_storage(ElementAssemblyValues());
+		utils::maybe_parallel_for(int(bases.size()), [&](int start, int end, int thread_id) {
+			ElementAssemblyValues &vals = utils::get_local_thread_storage(storage, thread_id);
+			Eigen::MatrixXd local_pts;
+
+			for (int i = start; i < end; ++i)
+			{
+				if (mesh.is_simplex(i))
+				{
+					if (mesh.dimension() == 3)
+						autogen::p_nodes_3d(disc_orders(i), local_pts);
+					else
+						autogen::p_nodes_2d(disc_orders(i), local_pts);
+				}
+				else if (mesh.is_cube(i))
+				{
+					if (mesh.dimension() == 3)
+						autogen::q_nodes_3d(disc_orders(i), local_pts);
+					else
+						autogen::q_nodes_2d(disc_orders(i), local_pts);
+				}
+				else
+				{
+					// not supported for polys
+					continue;
+				}
+
+				vals.compute(i, actual_dim == 3, bases[i], gbases[i]);
+				const quadrature::Quadrature &quadrature = vals.quadrature;
+				el_areas[i] = (vals.det.array() * quadrature.weights.array()).sum();
+
+				assembler.compute_scalar_value(OutputData(t, i, bases[i], gbases[i], local_pts, fun), el_values[i]);
+			}
+		});
+
 		std::vector<Eigen::MatrixXd> avg_scalar;
 
 		Eigen::MatrixXd areas(n_bases, 1);
 		areas.setZero();
 
 		std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_s;
-		Eigen::MatrixXd local_val;
 
-		ElementAssemblyValues vals;
 		for (int i = 0; i < int(bases.size()); ++i)
 		{
-			const ElementBases &bs = bases[i];
-			const ElementBases &gbs = gbases[i];
-			Eigen::MatrixXd local_pts;
-
-			if (mesh.is_simplex(i))
-			{
-				if (mesh.dimension() == 3)
-					autogen::p_nodes_3d(disc_orders(i), local_pts);
-				else
-					autogen::p_nodes_2d(disc_orders(i), local_pts);
-			}
-			else if (mesh.is_cube(i))
-			{
-				if (mesh.dimension() == 3)
-					autogen::q_nodes_3d(disc_orders(i), local_pts);
-				else
-					autogen::q_nodes_2d(disc_orders(i), local_pts);
-			}
-			else
-			{
-				// not supported for polys
+			if (!mesh.is_simplex(i) && !mesh.is_cube(i))
 				continue;
-			}
-
-			vals.compute(i, actual_dim == 3, bases[i], gbases[i]);
-			const quadrature::Quadrature &quadrature = vals.quadrature;
-			const double area = (vals.det.array() * quadrature.weights.array()).sum();
-
-			assembler.compute_scalar_value(OutputData(t, i, bs, gbs, local_pts, fun), tmp_s);
 
-			// assembler.compute_tensor_value(i, bs, gbs, local_pts, fun, local_val);
-			// MatrixXd avg_tensor(n_points * actual_dim*actual_dim, 1);
+			const ElementBases &bs = bases[i];
+			const double area = el_areas[i];
+			tmp_s = std::move(el_values[i]);
 
 			for (size_t j = 0; j < bs.bases.size(); ++j)
 			{
@@ -658,7 +874,7 @@ namespace polyfem::io
 
 			for (int k = 0; k < tmp_s.size(); ++k)
 			{
-				local_val = tmp_s[k].second;
+				const Eigen::MatrixXd &local_val = tmp_s[k].second;
 
 				for (size_t j = 0; j < bs.bases.size(); ++j)
 				{
@@ -719,41 +935,60 @@ namespace polyfem::io
 		// std::array<int, 8> get_ordered_vertices_from_hex(const int element_index) const;
 		// std::array<int, 4> get_ordered_vertices_from_tet(const int element_index) const;
 
-		std::vector<AssemblyValues> tmp;
-		std::vector<bool> marked(mesh3d.n_vertices(), false);
-		for (int i = 0; i < int(basis.size()); ++i)
-		{
-			const ElementBases &bs = basis[i];
-			Eigen::MatrixXd local_pts;
-			std::vector<int> vertices;
+		// the first element touching a vertex sets its value, so the element values are computed
+		// in parallel and assigned serially, in the order of the elements
+		std::vector<std::vector<int>> el_vertices(basis.size());
+		std::vector<Eigen::MatrixXd> el_res(basis.size());
 
-			if (mesh.is_simplex(i))
-			{
-				local_pts = sampler.simplex_corners();
-				auto vtx = mesh3d.get_ordered_vertices_from_tet(i);
-				vertices.assign(vtx.begin(), vtx.end());
-			}
-			else if (mesh.is_cube(i))
-			{
-				local_pts = sampler.cube_corners();
-				auto vtx = mesh3d.get_ordered_vertices_from_hex(i);
-				vertices.assign(vtx.begin(), vtx.end());
-			}
-			// TODO poly?
-			assert((int)vertices.size() == (int)local_pts.rows());
+		auto storage = utils::create_thread_storage(LocalThreadStorage());
+		utils::maybe_parallel_for(int(basis.size()), [&](int start, int end, int thread_id) {
+			LocalThreadStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+			Eigen::MatrixXd &local_pts = local_storage.local_pts;
+			std::vector<AssemblyValues> &tmp = local_storage.basis_values;
 
-			Eigen::MatrixXd local_res = Eigen::MatrixXd::Zero(local_pts.rows(), actual_dim);
-			bs.evaluate_bases(local_pts, tmp);
-			for (size_t j = 0; j < bs.bases.size(); ++j)
+			for (int i = start; i < end; ++i)
 			{
-				const Basis &b = bs.bases[j];
+				const ElementBases &bs = basis[i];
+				std::vector<int> &vertices = el_vertices[i];
 
-				for (int d = 0; d < actual_dim; ++d)
+				if (mesh.is_simplex(i))
+				{
+					local_pts = sampler.simplex_corners();
+					auto vtx = mesh3d.get_ordered_vertices_from_tet(i);
+					vertices.assign(vtx.begin(), vtx.end());
+				}
+				else if (mesh.is_cube(i))
 				{
-					for (size_t ii = 0; ii < b.global().size(); ++ii)
-						local_res.col(d) += b.global()[ii].val * tmp[j].val * fun(b.global()[ii].index * actual_dim + d);
+					local_pts = sampler.cube_corners();
+					auto vtx = mesh3d.get_ordered_vertices_from_hex(i);
+					vertices.assign(vtx.begin(), vtx.end());
+				}
+				// TODO poly?
+				else
+					continue;
+				assert((int)vertices.size() == (int)local_pts.rows());
+
+				Eigen::MatrixXd &local_res = el_res[i];
+				local_res.setZero(local_pts.rows(), actual_dim);
+				bs.evaluate_bases(local_pts, tmp);
+				for (size_t j = 0; j < bs.bases.size(); ++j)
+				{
+					const Basis &b = bs.bases[j];
+
+					for (int d = 0; d < actual_dim; ++d)
+					{
+						for (size_t ii = 0; ii < b.global().size(); ++ii)
+							local_res.col(d) += b.global()[ii].val * tmp[j].val * fun(b.global()[ii].index * actual_dim + d);
+					}
 				}
 			}
+		});
+
+		std::vector<bool> marked(mesh3d.n_vertices(), false);
+		for (int i = 0; i < int(basis.size()); ++i)
+		{
+			const std::vector<int> &vertices = el_vertices[i];
+			const Eigen::MatrixXd &local_res = el_res[i];
 
 			for (size_t lv = 0; lv < vertices.size(); ++lv)
 			{
@@ -802,70 +1037,77 @@ namespace polyfem::io
 		const int actual_dim = mesh.dimension();
 		assert(!is_problem_scalar);
 
-		Eigen::MatrixXd local_val, local_stress, local_mises;
+		// the element values are computed in parallel and concatenated serially, in the order of the elements
+		std::vector<Eigen::MatrixXd> el_stress(mesh.n_elements()), el_mises(mesh.n_elements());
 
-		int num_quadr_pts = 0;
-		result.resize(disc_orders.sum(), actual_dim == 2 ? 3 : 6);
-		result.setZero();
-		von_mises.resize(disc_orders.sum(), 1);
-		von_mises.setZero();
-		for (int e = 0; e < mesh.n_elements(); ++e)
-		{
-			// Compute quadrature points for element
-			quadrature::Quadrature quadr;
-			if (mesh.is_simplex(e))
+		auto storage = utils::create_thread_storage(LocalThreadStorage());
+		utils::maybe_parallel_for(mesh.n_elements(), [&](int start, int end, int thread_id) {
+			LocalThreadStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+			std::vector<Assembler::NamedMatrix> &tmp_s = local_storage.values;
+			std::vector<Assembler::NamedMatrix> tmp_t;
+
+			for (int e = start; e < end; ++e)
 			{
-				if (mesh.is_volume())
-				{
-					quadrature::TetQuadrature f;
-					f.get_quadrature(disc_orders(e), quadr);
-				}
-				else
+				// Compute quadrature points for element
+				quadrature::Quadrature quadr;
+				if (mesh.is_simplex(e))
 				{
-					quadrature::TriQuadrature f;
-					f.get_quadrature(disc_orders(e), quadr);
+					if (mesh.is_volume())
+					{
+						quadrature::TetQuadrature f;
+						f.get_quadrature(disc_orders(e), quadr);
+					}
+					else
+					{
+						quadrature::TriQuadrature f;
+						f.get_quadrature(disc_orders(e), quadr);
+					}
 				}
-			}
-			else if (mesh.is_cube(e))
-			{
-				if (mesh.is_volume())
+				else if (mesh.is_cube(e))
 				{
-					quadrature::HexQuadrature f;
-					f.get_quadrature(disc_orders(e), quadr);
+					if (mesh.is_volume())
+					{
+						quadrature::HexQuadrature f;
+						f.get_quadrature(disc_orders(e), quadr);
+					}
+					else
+					{
+						quadrature::QuadQuadrature f;
+						f.get_quadrature(disc_orders(e), quadr);
+					}
 				}
 				else
 				{
-					quadrature::QuadQuadrature f;
-					f.get_quadrature(disc_orders(e), quadr);
+					continue;
 				}
+
+				assembler.compute_scalar_value(OutputData(t, e, bases[e], gbases[e], quadr.points, fun), tmp_s);
+				assembler.compute_tensor_value(OutputData(t, e, bases[e], gbases[e], quadr.points, fun), tmp_t);
+
+				el_mises[e] = tmp_s[0].second;
+				flattened_tensor_coeffs(tmp_t[0].second, el_stress[e]);
 			}
-			else
-			{
-				continue;
-			}
+		});
 
-			std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_s, tmp_t;
+		int num_quadr_pts = 0;
+		for (const Eigen::MatrixXd &local_stress : el_stress)
+			num_quadr_pts += local_stress.rows();
 
-			assembler.compute_scalar_value(OutputData(t, e, bases[e], gbases[e], quadr.points, fun), tmp_s);
-			assembler.compute_tensor_value(OutputData(t, e, bases[e], gbases[e], quadr.points, fun), tmp_t);
+		result.resize(num_quadr_pts, actual_dim == 2 ? 3 : 6);
+		von_mises.resize(num_quadr_pts, 1);
 
-			local_mises = tmp_s[0].second;
-			local_val = tmp_t[0].second;
+		num_quadr_pts = 0;
+		for (int e = 0; e < mesh.n_elements(); ++e)
+		{
+			const Eigen::MatrixXd &local_stress = el_stress[e];
+			const Eigen::MatrixXd &local_mises = el_mises[e];
+			if (local_stress.size() == 0)
+				continue;
 
-			if (num_quadr_pts + local_val.rows() >= result.rows())
-			{
-				result.conservativeResize(
-					std::max(num_quadr_pts + local_val.rows() + 1, 2 * result.rows()),
-					result.cols());
-				von_mises.conservativeResize(result.rows(), von_mises.cols());
-			}
-			flattened_tensor_coeffs(local_val, local_stress);
 			result.block(num_quadr_pts, 0, local_stress.rows(), local_stress.cols()) = local_stress;
 			von_mises.block(num_quadr_pts, 0, local_mises.rows(), local_mises.cols()) = local_mises;
-			num_quadr_pts += local_val.rows();
+			num_quadr_pts += local_stress.rows();
 		}
-		result.conservativeResize(num_quadr_pts, result.cols());
-		von_mises.conservativeResize(num_quadr_pts, von_mises.cols());
 	}
 
 	void Evaluator::interpolate_function(
@@ -910,74 +1152,42 @@ namespace polyfem::io
 			return;
 		}
 
-		std::vector<AssemblyValues> tmp;
+		std::map<int, Eigen::MatrixXd> poly_pts;
+		std::vector<int> offsets;
+		output_layout(mesh, basis.size(), disc_orders, polys, polys_3d, sampler, use_sampler, boundary_only, poly_pts, offsets);
+		assert(offsets.back() <= n_points);
 
 		result.resize(n_points, actual_dim);
 
-		int index = 0;
-
-		Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
-
-		for (int i = 0; i < int(basis.size()); ++i)
-		{
-			const ElementBases &bs = basis[i];
-			Eigen::MatrixXd local_pts;
-
-			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
-				continue;
-
-			if (use_sampler)
-			{
-				if (mesh.is_simplex(i))
-					local_pts = sampler.simplex_points();
-				else if (mesh.is_cube(i))
-					local_pts = sampler.cube_points();
-				else
-				{
-					if (mesh.is_volume())
-						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts, vis_faces_poly, vis_edges_poly);
-					else
-						sampler.sample_polygon(polys.at(i), local_pts, vis_faces_poly, vis_edges_poly);
-				}
-			}
-			else
-			{
-				if (mesh.is_volume())
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_3d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_3d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-				else
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_2d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_2d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-			}
+		// every element writes its own rows, the result does not depend on the number of threads
+		auto storage = utils::create_thread_storage(LocalThreadStorage());
+		utils::maybe_parallel_for(int(basis.size()), [&](int start, int end, int thread_id) {
+			LocalThreadStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+			const Eigen::MatrixXd &local_pts = local_storage.local_pts;
+			std::vector<AssemblyValues> &tmp = local_storage.basis_values;
 
-			Eigen::MatrixXd local_res = Eigen::MatrixXd::Zero(local_pts.rows(), actual_dim);
-			bs.evaluate_bases(local_pts, tmp);
-			for (size_t j = 0; j < bs.bases.size(); ++j)
+			for (int i = start; i < end; ++i)
 			{
-				const Basis &b = bs.bases[j];
+				if (!output_points(mesh, i, disc_orders, sampler, poly_pts, use_sampler, boundary_only, local_storage.local_pts))
+					continue;
 
-				for (int d = 0; d < actual_dim; ++d)
+				const ElementBases &bs = basis[i];
+				Eigen::MatrixXd local_res = Eigen::MatrixXd::Zero(local_pts.rows(), actual_dim);
+				bs.evaluate_bases(local_pts, tmp);
+				for (size_t j = 0; j < bs.bases.size(); ++j)
 				{
-					for (size_t ii = 0; ii < b.global().size(); ++ii)
-						local_res.col(d) += b.global()[ii].val * tmp[j].val * fun(b.global()[ii].index * actual_dim + d);
+					const Basis &b = bs.bases[j];
+
+					for (int d = 0; d < actual_dim; ++d)
+					{
+						for (size_t ii = 0; ii < b.global().size(); ++ii)
+							local_res.col(d) += b.global()[ii].val * tmp[j].val * fun(b.global()[ii].index * actual_dim + d);
+					}
 				}
-			}
 
-			result.block(index, 0, local_res.rows(), actual_dim) = local_res;
-			index += local_res.rows();
-		}
+				result.block(offsets[i], 0, local_res.rows(), actual_dim) = local_res;
+			}
+		});
 	}
 
 	void Evaluator::interpolate_at_local_vals(
@@ -1103,63 +1313,29 @@ namespace polyfem::io
 
 		assert(!is_problem_scalar);
 
-		Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
-
-		std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_s;
-
-		for (int i = 0; i < int(bases.size()); ++i)
-		{
-			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
-				continue;
+		std::map<int, Eigen::MatrixXd> poly_pts;
+		std::vector<int> offsets;
+		output_layout(mesh, bases.size(), disc_orders, polys, polys_3d, sampler, use_sampler, boundary_only, poly_pts, offsets);
 
-			const ElementBases &bs = bases[i];
-			const ElementBases &gbs = gbases[i];
-			Eigen::MatrixXd local_pts;
+		std::atomic<bool> valid(true);
+		auto storage = utils::create_thread_storage(LocalThreadStorage());
+		utils::maybe_parallel_for(int(bases.size()), [&](int start, int end, int thread_id) {
+			LocalThreadStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
 
-			if (use_sampler)
+			for (int i = start; i < end && valid; ++i)
 			{
-				if (mesh.is_simplex(i))
-					local_pts = sampler.simplex_points();
-				else if (mesh.is_cube(i))
-					local_pts = sampler.cube_points();
-				else
-				{
-					if (mesh.is_volume())
-						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts, vis_faces_poly, vis_edges_poly);
-					else
-						sampler.sample_polygon(polys.at(i), local_pts, vis_faces_poly, vis_edges_poly);
-				}
-			}
-			else
-			{
-				if (mesh.is_volume())
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_3d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_3d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-				else
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_2d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_2d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-			}
+				if (!output_points(mesh, i, disc_orders, sampler, poly_pts, use_sampler, boundary_only, local_storage.local_pts))
+					continue;
 
-			assembler.compute_scalar_value(OutputData(t, i, bs, gbs, local_pts, fun), tmp_s);
+				assembler.compute_scalar_value(OutputData(t, i, bases[i], gbases[i], local_storage.local_pts, fun), local_storage.values);
 
-			for (const auto &s : tmp_s)
-				if (std::isnan(s.second.norm()))
-					return false;
-		}
+				for (const auto &s : local_storage.values)
+					if (std::isnan(s.second.norm()))
+						valid = false;
+			}
+		});
 
-		return true;
+		return valid;
 	}
 
 	void Evaluator::compute_scalar_value(
@@ -1189,75 +1365,12 @@ namespace polyfem::io
 
 		assert(!is_problem_scalar);
 
-		int index = 0;
-
-		Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
-		std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_s;
-
-		for (int i = 0; i < int(bases.size()); ++i)
-		{
-			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
-				continue;
-
-			const ElementBases &bs = bases[i];
-			const ElementBases &gbs = gbases[i];
-			Eigen::MatrixXd local_pts;
-
-			if (use_sampler)
-			{
-				if (mesh.is_simplex(i))
-					local_pts = sampler.simplex_points();
-				else if (mesh.is_cube(i))
-					local_pts = sampler.cube_points();
-				else
-				{
-					if (mesh.is_volume())
-						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts, vis_faces_poly, vis_edges_poly);
-					else
-						sampler.sample_polygon(polys.at(i), local_pts, vis_faces_poly, vis_edges_poly);
-				}
-			}
-			else
-			{
-				if (mesh.is_volume())
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_3d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_3d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-				else
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_2d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_2d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-			}
-
-			assembler.compute_scalar_value(OutputData(t, i, bs, gbs, local_pts, fun), tmp_s);
-
-			if (result.empty())
-			{
-				result.resize(tmp_s.size());
-				for (int k = 0; k < tmp_s.size(); ++k)
-				{
-					result[k].first = tmp_s[k].first;
-					result[k].second.resize(n_points, 1);
-				}
-			}
-
-			for (int k = 0; k < tmp_s.size(); ++k)
-			{
-				assert(local_pts.rows() == tmp_s[k].second.rows());
-				result[k].second.block(index, 0, tmp_s[k].second.rows(), 1) = tmp_s[k].second;
-			}
-			index += local_pts.rows();
-		}
+		compute_output_values(
+			mesh, bases.size(), disc_orders, polys, polys_3d, sampler, n_points, 1,
+			[&](const int i, const Eigen::MatrixXd &local_pts, std::vector<Assembler::NamedMatrix> &values) {
+				assembler.compute_scalar_value(OutputData(t, i, bases[i], gbases[i], local_pts, fun), values);
+			},
+			result, use_sampler, boundary_only);
 	}
 
 	void Evaluator::compute_tensor_value(
@@ -1288,75 +1401,12 @@ namespace polyfem::io
 		const int actual_dim = mesh.dimension();
 		assert(!is_problem_scalar);
 
-		int index = 0;
-
-		Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
-		std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_t;
-
-		for (int i = 0; i < int(bases.size()); ++i)
-		{
-			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
-				continue;
-
-			const ElementBases &bs = bases[i];
-			const ElementBases &gbs = gbases[i];
-			Eigen::MatrixXd local_pts;
-
-			if (use_sampler)
-			{
-				if (mesh.is_simplex(i))
-					local_pts = sampler.simplex_points();
-				else if (mesh.is_cube(i))
-					local_pts = sampler.cube_points();
-				else
-				{
-					if (mesh.is_volume())
-						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts, vis_faces_poly, vis_edges_poly);
-					else
-						sampler.sample_polygon(polys.at(i), local_pts, vis_faces_poly, vis_edges_poly);
-				}
-			}
-			else
-			{
-				if (mesh.is_volume())
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_3d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_3d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-				else
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_2d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_2d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-			}
-
-			assembler.compute_tensor_value(OutputData(t, i, bs, gbs, local_pts, fun), tmp_t);
-
-			if (result.empty())
-			{
-				result.resize(tmp_t.size());
-				for (int k = 0; k < tmp_t.size(); ++k)
-				{
-					result[k].first = tmp_t[k].first;
-					result[k].second.resize(n_points, actual_dim * actual_dim);
-				}
-			}
-
-			for (int k = 0; k < tmp_t.size(); ++k)
-			{
-				assert(local_pts.rows() == tmp_t[k].second.rows());
-				result[k].second.block(index, 0, tmp_t[k].second.rows(), tmp_t[k].second.cols()) = tmp_t[k].second;
-			}
-			index += local_pts.rows();
-		}
+		compute_output_values(
+			mesh, bases.size(), disc_orders, polys, polys_3d, sampler, n_points, actual_dim * actual_dim,
+			[&](const int i, const Eigen::MatrixXd &local_pts, std::vector<Assembler::NamedMatrix> &values) {
+				assembler.compute_tensor_value(OutputData(t, i, bases[i], gbases[i], local_pts, fun), values);
+			},
+			result, use_sampler, boundary_only);
 	}
 
 	Eigen::MatrixXd Evaluator::get_bases_position(
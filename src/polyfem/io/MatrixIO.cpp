@@ -7,6 +7,7 @@
 #include <iostream>
 #include <h5pp/h5pp.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip> // setprecision
 #include <vector>
@@ -217,6 +218,60 @@ namespace polyfem::io
 		return true;
 	}
 
+	bool write_sparse_matrix(const std::string &path, const std::string &key, const StiffnessMatrix &mat, const bool replace)
+	{
+		StiffnessMatrix compressed = mat;
+		compressed.makeCompressed();
+
+		using IndexVector = Eigen::Matrix<int64_t, Eigen::Dynamic, 1>;
+		const IndexVector outer = Eigen::Map<const Eigen::Matrix<StiffnessMatrix::StorageIndex, Eigen::Dynamic, 1>>(
+									  compressed.outerIndexPtr(), compressed.outerSize() + 1)
+									  .cast<int64_t>();
+		const IndexVector inner = Eigen::Map<const Eigen::Matrix<StiffnessMatrix::StorageIndex, Eigen::Dynamic, 1>>(
+									  compressed.innerIndexPtr(), compressed.nonZeros())
+									  .cast<int64_t>();
+		const Eigen::VectorXd values = Eigen::Map<const Eigen::VectorXd>(compressed.valuePtr(), compressed.nonZeros());
+
+		h5pp::File hdf5_file(path, replace ? h5pp::FileAccess::REPLACE : h5pp::FileAccess::READWRITE);
+		hdf5_file.writeDataset(int64_t(compressed.rows()), key + "/rows");
+		hdf5_file.writeDataset(int64_t(compressed.cols()), key + "/cols");
+		hdf5_file.writeDataset(outer, key + "/outer");
+		hdf5_file.writeDataset(inner, key + "/inner");
+		hdf5_file.writeDataset(values, key + "/values");
+
+		return true;
+	}
+
+	bool read_sparse_matrix(const std::string &path, const std::string &key, StiffnessMatrix &mat)
+	{
+		h5pp::File hdf5_file(path, h5pp::FileAccess::READONLY);
+		if (!hdf5_file.linkExists(key + "/values"))
+			return false;
+
+		using IndexVector = Eigen::Matrix<int64_t, Eigen::Dynamic, 1>;
+		const int64_t rows = hdf5_file.readDataset<int64_t>(key + "/rows");
+		const int64_t cols = hdf5_file.readDataset<int64_t>(key + "/cols");
+		const IndexVector outer = hdf5_file.readDataset<IndexVector>(key + "/outer");
+		const IndexVector inner = hdf5_file.readDataset<IndexVector>(key + "/inner");
+		const Eigen::VectorXd values = hdf5_file.readDataset<Eigen::VectorXd>(key + "/values");
+
+		if (outer.size() != cols + 1 || inner.size() != values.size() || outer[cols] != values.size())
+		{
+			logger().error("Invalid sparse matrix {} in {}", key, path);
+			return false;
+		}
+
+		mat.resize(rows, cols);
+		mat.resizeNonZeros(values.size());
+		for (int64_t i = 0; i < outer.size(); ++i)
+			mat.outerIndexPtr()[i] = outer[i];
+		for (int64_t i = 0; i < inner.size(); ++i)
+			mat.innerIndexPtr()[i] = inner[i];
+		std::copy(values.data(), values.data() + values.size(), mat.valuePtr());
+
+		return true;
+	}
+
 	template <typename T>
 	bool import_matrix(
 		const std::string &path, const json &import, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> &mat)
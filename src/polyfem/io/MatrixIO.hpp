@@ -38,6 +38,12 @@ namespace polyfem::io
 
 	bool write_sparse_matrix_csv(const std::string &path, const Eigen::SparseMatrix<double> &mat);
 
+	/// Writes a sparse matrix to a hdf5 file as a group key with its compressed column storage.
+	bool write_sparse_matrix(const std::string &path, const std::string &key, const StiffnessMatrix &mat, const bool replace = true);
+
+	/// Reads a sparse matrix written by write_sparse_matrix, returns false if the file does not contain key.
+	bool read_sparse_matrix(const std::string &path, const std::string &key, StiffnessMatrix &mat);
+
 	template <typename T>
 	bool import_matrix(const std::string &path, const json &import, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> &mat);
 } // namespace polyfem::io
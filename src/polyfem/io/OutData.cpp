@@ -990,6 +990,16 @@ namespace polyfem::io
 					out << std::endl;
 				}
 			}
+			else if (state.node_reordering.size() > 0)
+			{
+				const int problem_dim = (problem.is_scalar() ? 1 : mesh.dimension());
+				const Eigen::MatrixXd tmp_sol = utils::unflatten(sol, problem_dim);
+				Eigen::MatrixXd tmp = tmp_sol;
+				for (int i = 0; i < state.node_reordering.size(); ++i)
+					tmp.row(state.node_reordering[i]) = tmp_sol.row(i);
+
+				out << utils::flatten(tmp) << std::endl;
+			}
 			else
 				out << sol << std::endl;
 			out.close();
@@ -1021,6 +1031,12 @@ namespace polyfem::io
 					}
 				}
 			}
+			if (state.node_reordering.size() > 0)
+			{
+				const Eigen::MatrixXd tmp = nodes;
+				for (int i = 0; i < state.node_reordering.size(); ++i)
+					nodes.row(state.node_reordering[i]) = tmp.row(i);
+			}
 			std::ofstream out(nodes_path);
 			out.precision(100);
 			out << nodes;
@@ -1,4 +1,6 @@
 #include <filesystem>
+#include <iostream>
+#include <sstream>
 
 #include <CLI/CLI.hpp>
 
@@ -6,6 +8,10 @@
 
 #include <polyfem/State.hpp>
 #include <polyfem/OptState.hpp>
+#include <polyfem/SimulationServer.hpp>
+
+#include <polyfem/refinement/APosteriori.hpp>
+#include <polyfem/io/BinaryMesh.hpp>
 
 #include <polyfem/utils/JSONUtils.hpp>
 #include <polyfem/utils/Logger.hpp>
@@ -52,6 +58,14 @@ int optimization_simulation(const CLI::App &command_line,
 							const spdlog::level::level_enum &log_level,
 							json &opt_args);
 
+int server_simulation(const CLI::App &command_line,
+					  const std::string output_dir,
+					  const size_t max_threads,
+					  const bool is_strict,
+					  const bool fallback_solver,
+					  const spdlog::level::level_enum &log_level,
+					  const json &in_args);
+
 int main(int argc, char **argv)
 {
 	using namespace polyfem;
@@ -80,6 +94,14 @@ int main(int argc, char **argv)
 	bool fallback_solver = false;
 	command_line.add_flag("--enable_overwrite_solver", fallback_solver, "If solver in json is not present, falls back to default");
 
+	bool server = false;
+	command_line.add_flag("--server", server, "Keep the simulation alive and run the JSON patches read from stdin, one per line");
+
+	std::vector<std::string> convert_mesh;
+	command_line.add_option("--convert_mesh", convert_mesh, "Convert a linear MSH mesh to the binary .pfm format and exit")
+		->expected(2)
+		->type_name("MSH PFM");
+
 	const std::vector<std::pair<std::string, spdlog::level::level_enum>>
 		SPDLOG_LEVEL_NAMES_TO_LEVELS = {
 			{"trace", spdlog::level::trace},
@@ -95,6 +117,9 @@ int main(int argc, char **argv)
 
 	CLI11_PARSE(command_line, argc, argv);
 
+	if (!convert_mesh.empty())
+		return io::BinaryMeshWriter::convert_msh(convert_mesh[0], convert_mesh[1]) ? EXIT_SUCCESS : EXIT_FAILURE;
+
 	json in_args = json({});
 
 	if (!json_file.empty())
@@ -103,7 +128,14 @@ int main(int argc, char **argv)
 
 		if (!ok)
 			log_and_throw_error(fmt::format("unable to open {} file", json_file));
+	}
+
+	if (server)
+		return server_simulation(command_line, output_dir, max_threads,
+								 is_strict, fallback_solver, log_level, in_args);
 
+	if (!json_file.empty())
+	{
 		if (in_args.contains("states"))
 			return optimization_simulation(command_line, max_threads, is_strict, log_level, in_args);
 		else
@@ -142,9 +174,12 @@ int forward_simulation(const CLI::App &command_line,
 		std::string json_string = file.readDataset<std::string>("json");
 
 		in_args = json::parse(json_string);
-		in_args["root_path"] = hdf5_file;
+		// checkpoints keep the root path of the simulation they restart
+		if (!in_args.contains("root_path"))
+			in_args["root_path"] = hdf5_file;
 
-		names = file.findGroups("", "/meshes");
+		if (file.linkExists("/meshes"))
+			names = file.findGroups("", "/meshes");
 		cells.resize(names.size());
 		vertices.resize(names.size());
 
@@ -170,7 +205,8 @@ int forward_simulation(const CLI::App &command_line,
 
 	State state;
 	state.init(in_args, is_strict);
-	state.load_mesh(/*non_conforming=*/false, names, cells, vertices);
+	const bool adaptive_refinement = state.args["space"]["adaptive_refinement"]["enabled"];
+	state.load_mesh(/*non_conforming=*/adaptive_refinement, names, cells, vertices);
 
 	// Mesh was not loaded successfully; load_mesh() logged the error.
 	if (state.mesh == nullptr)
@@ -181,15 +217,22 @@ int forward_simulation(const CLI::App &command_line,
 
 	state.stats.compute_mesh_stats(*state.mesh);
 
-	state.build_basis();
-
-	state.assemble_rhs();
-	state.assemble_mass_mat();
-
 	Eigen::MatrixXd sol;
 	Eigen::MatrixXd pressure;
 
-	state.solve_problem(sol, pressure);
+	if (adaptive_refinement)
+	{
+		refinement::APosteriori::solve(state, sol, pressure);
+	}
+	else
+	{
+		state.build_basis();
+
+		state.assemble_rhs();
+		state.assemble_mass_mat();
+
+		state.solve_problem(sol, pressure);
+	}
 
 	state.compute_errors(sol);
 
@@ -201,6 +244,39 @@ int forward_simulation(const CLI::App &command_line,
 	return EXIT_SUCCESS;
 }
 
+int server_simulation(const CLI::App &command_line,
+					  const std::string output_dir,
+					  const size_t max_threads,
+					  const bool is_strict,
+					  const bool fallback_solver,
+					  const spdlog::level::level_enum &log_level,
+					  const json &in_args)
+{
+	json tmp = json::object();
+	if (has_arg(command_line, "log_level"))
+		tmp["/output/log/level"_json_pointer] = int(log_level);
+	if (has_arg(command_line, "max_threads"))
+		tmp["/solver/max_threads"_json_pointer] = max_threads;
+	if (has_arg(command_line, "output_dir"))
+		tmp["/output/directory"_json_pointer] = std::filesystem::absolute(output_dir);
+	if (has_arg(command_line, "enable_overwrite_solver"))
+		tmp["/solver/linear/enable_overwrite_solver"_json_pointer] = fallback_solver;
+
+	SimulationServer server(tmp, is_strict);
+
+	// the --json file, if any, is the first job
+	if (!in_args.empty())
+	{
+		std::stringstream first_job;
+		first_job << in_args.dump() << std::endl;
+		server.serve(first_job, std::cout);
+	}
+
+	server.serve(std::cin, std::cout);
+
+	return EXIT_SUCCESS;
+}
+
 int optimization_simulation(const CLI::App &command_line,
 							const size_t max_threads,
 							const bool is_strict,
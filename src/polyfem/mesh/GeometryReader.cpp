@@ -441,6 +441,7 @@ namespace polyfem::mesh
 		const std::vector<json> &displacements,
 		const std::vector<json> &dirichlets,
 		const std::string &root_path,
+		const std::string &output_dir,
 		const int dim,
 		const std::vector<std::string> &_names,
 		const std::vector<Eigen::MatrixXd> &_vertices,
@@ -639,39 +640,39 @@ namespace polyfem::mesh
 					});
 				}
 
-				std::vector<Eigen::MatrixXd> vertices(mesh_files.size());
-				Eigen::VectorXi codim_vertices;
-				Eigen::MatrixXi codim_edges;
-				Eigen::MatrixXi faces;
+				if (mesh_files.empty())
+					continue;
 
-				for (int i = 0; i < mesh_files.size(); ++i)
-				{
+				const auto read_frame = [&](const int i, Eigen::MatrixXd &vertices, Eigen::VectorXi &codim_vertices, Eigen::MatrixXi &codim_edges, Eigen::MatrixXi &faces) {
 					json jmesh = geometry;
 					jmesh["mesh"] = mesh_files[i];
 					jmesh["n_refs"] = 0;
 
-					Eigen::VectorXi tmp_codim_vertices;
-					Eigen::MatrixXi tmp_codim_edges;
-					Eigen::MatrixXi tmp_faces;
 					read_obstacle_mesh(units,
-									   jmesh, root_path, dim, vertices[i],
-									   tmp_codim_vertices, tmp_codim_edges, tmp_faces);
-					if (i == 0)
-					{
-						codim_vertices = tmp_codim_vertices;
-						codim_edges = tmp_codim_edges;
-						faces = tmp_faces;
-					}
-					else
-					{
+									   jmesh, root_path, dim, vertices,
+									   codim_vertices, codim_edges, faces);
+				};
+
+				Eigen::MatrixXd vertices;
+				Eigen::VectorXi codim_vertices;
+				Eigen::MatrixXi codim_edges;
+				Eigen::MatrixXi faces;
+				read_frame(0, vertices, codim_vertices, codim_edges, faces);
+
+				// the frames are read one at a time, only the displacements are kept (on disk)
+				obstacle.append_mesh_sequence(
+					vertices, codim_vertices, codim_edges, faces, geometry["fps"], mesh_files.size(),
+					[&](const int i, Eigen::MatrixXd &frame) {
+						Eigen::VectorXi tmp_codim_vertices;
+						Eigen::MatrixXi tmp_codim_edges;
+						Eigen::MatrixXi tmp_faces;
+						read_frame(i, frame, tmp_codim_vertices, tmp_codim_edges, tmp_faces);
+
 						assert((codim_vertices.array() == tmp_codim_vertices.array()).all());
 						assert((codim_edges.array() == tmp_codim_edges.array()).all());
 						assert((faces.array() == tmp_faces.array()).all());
-					}
-				}
-
-				obstacle.append_mesh_sequence(
-					vertices, codim_vertices, codim_edges, faces, geometry["fps"]);
+					},
+					output_dir);
 			}
 			else
 			{
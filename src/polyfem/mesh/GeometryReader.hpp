@@ -67,6 +67,7 @@ namespace polyfem::mesh
 	/// @param[in]  displacements   displacements JSON object(s)
 	/// @param[in]  dirichlets    	dirichlet bc JSON object(s)
 	/// @param[in]  root_path       root path of JSON
+	/// @param[in]  output_dir      output directory, holds the displacements of the mesh sequences while they are used
 	///
 	/// @return created Obstacle object
 	///
@@ -76,6 +77,7 @@ namespace polyfem::mesh
 		const std::vector<json> &displacements,
 		const std::vector<json> &dirichlets,
 		const std::string &root_path,
+		const std::string &output_dir,
 		const int dim,
 		const std::vector<std::string> &names = std::vector<std::string>(),
 		const std::vector<Eigen::MatrixXd> &vertices = std::vector<Eigen::MatrixXd>(),
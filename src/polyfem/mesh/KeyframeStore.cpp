@@ -0,0 +1,163 @@
+#include "KeyframeStore.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace polyfem::mesh
+{
+	namespace
+	{
+		std::string unique_temporary_path(const std::string &directory)
+		{
+			static std::atomic<int> counter(0);
+			const std::filesystem::path name = fmt::format("polyfem-keyframes-{:x}-{}.bin", std::random_device()(), counter++);
+			return (std::filesystem::path(directory.empty() ? "." : directory) / name).string();
+		}
+	} // namespace
+
+	KeyframeStore::KeyframeStore(const int n_values, const double fps, const std::string &directory)
+		: n_values_(n_values), fps_(fps), path_(unique_temporary_path(directory))
+	{
+		assert(n_values >= 0);
+		out_.open(path_, std::ios::binary);
+		if (!out_.is_open())
+			log_and_throw_error("Unable to create the keyframe file {}", path_);
+	}
+
+	KeyframeStore::~KeyframeStore()
+	{
+		out_.close();
+#ifndef _WIN32
+		if (data_)
+			munmap(const_cast<char *>(data_), size_);
+#endif
+		if (!path_.empty())
+		{
+			std::error_code ec;
+			std::filesystem::remove(path_, ec);
+		}
+	}
+
+	void KeyframeStore::append(const Eigen::VectorXd &frame)
+	{
+		assert(out_.is_open());
+		assert(frame.size() == n_values_);
+
+		out_.write(reinterpret_cast<const char *>(frame.data()), frame_size());
+		if (!out_)
+			log_and_throw_error("Unable to write frame {} to the keyframe file {}", n_frames_, path_);
+		++n_frames_;
+	}
+
+	void KeyframeStore::finalize()
+	{
+		assert(out_.is_open());
+		out_.close();
+
+		size_ = size_t(n_frames_) * frame_size();
+		if (size_ == 0)
+			return;
+
+#ifndef _WIN32
+		const int fd = ::open(path_.c_str(), O_RDONLY);
+		if (fd < 0)
+			log_and_throw_error("Unable to open the keyframe file {}", path_);
+
+		void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (data == MAP_FAILED)
+			log_and_throw_error("Unable to map the keyframe file {}", path_);
+		data_ = static_cast<const char *>(data);
+
+		// the mapping keeps the content alive, removing the file now also cleans it up if the process crashes
+		std::error_code ec;
+		std::filesystem::remove(path_, ec);
+		path_.clear();
+
+		prefetch(0);
+		prefetch(1);
+#endif
+	}
+
+	void KeyframeStore::read_frame(const int i, Eigen::VectorXd &frame) const
+	{
+		assert(i >= 0 && i < n_frames_);
+		frame.resize(n_values_);
+
+		if (data_)
+		{
+			std::memcpy(frame.data(), data_ + i * frame_size(), frame_size());
+			return;
+		}
+
+		std::ifstream in(path_, std::ios::binary);
+		in.seekg(i * frame_size());
+		in.read(reinterpret_cast<char *>(frame.data()), frame_size());
+		if (!in)
+			log_and_throw_error("Unable to read frame {} from the keyframe file {}", i, path_);
+	}
+
+	void KeyframeStore::prefetch(const int i) const
+	{
+#ifndef _WIN32
+		if (!data_ || i < 0 || i >= n_frames_)
+			return;
+
+		// madvise needs a page aligned address, the read ahead is asynchronous
+		static const size_t page_size = sysconf(_SC_PAGESIZE);
+		const size_t offset = i * frame_size();
+		const size_t aligned_offset = offset / page_size * page_size;
+		madvise(const_cast<char *>(data_ + aligned_offset), offset - aligned_offset + frame_size(), MADV_WILLNEED);
+#endif
+	}
+
+	void KeyframeStore::interpolate(const double t, Eigen::VectorXd &values) const
+	{
+		assert(!out_.is_open());
+
+		if (n_frames_ == 0)
+		{
+			values.setZero(n_values_);
+			return;
+		}
+
+		const double frame = std::max(t, 0.0) * fps_;
+		const double interp = frame - floor(frame);
+		const int frame0 = (int)floor(frame);
+		const int frame1 = (int)ceil(frame);
+		if (frame1 >= n_frames_)
+		{
+			read_frame(n_frames_ - 1, values);
+			return;
+		}
+
+		if (data_)
+		{
+			const Eigen::Map<const Eigen::VectorXd> u0(reinterpret_cast<const double *>(data_ + frame0 * frame_size()), n_values_);
+			const Eigen::Map<const Eigen::VectorXd> u1(reinterpret_cast<const double *>(data_ + frame1 * frame_size()), n_values_);
+			values = (u1 - u0) * interp + u0;
+		}
+		else
+		{
+			Eigen::VectorXd u0, u1;
+			read_frame(frame0, u0);
+			read_frame(frame1, u1);
+			values = (u1 - u0) * interp + u0;
+		}
+
+		// time steps usually move forward, the next frame is read while this step is solved
+		prefetch(frame1 + 1);
+	}
+} // namespace polyfem::mesh
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <fstream>
+#include <string>
+
+namespace polyfem::mesh
+{
+	/// @brief Frames of a mesh sequence (e.g., the displacements of an animated obstacle) stored in a temporary file
+	///
+	/// The file is created in the given directory (usually the output directory) rather than in the system temporary
+	/// directory, which is often a RAM-backed tmpfs and would defeat the purpose of keeping the frames on disk.
+	///
+	/// The frames are appended one at a time, so the sequence never needs to fit in memory. Once finalized,
+	/// the file is memory mapped and an interpolation only touches the two frames bracketing the queried time,
+	/// while the following frame is prefetched by the operating system in the background.
+	class KeyframeStore
+	{
+	public:
+		/// @param[in] n_values number of values of every frame
+		/// @param[in] fps frames per second
+		/// @param[in] directory directory of the temporary file, the current directory if empty
+		KeyframeStore(const int n_values, const double fps, const std::string &directory = "");
+		~KeyframeStore();
+
+		KeyframeStore(const KeyframeStore &) = delete;
+		KeyframeStore &operator=(const KeyframeStore &) = delete;
+
+		/// @brief writes a frame at the end of the sequence
+		/// @param[in] frame n_values values
+		void append(const Eigen::VectorXd &frame);
+
+		/// @brief closes the file and maps it, no frame can be appended afterwards
+		void finalize();
+
+		int n_frames() const { return n_frames_; }
+		int n_values() const { return n_values_; }
+
+		/// @brief linear interpolation of the frames at time t, the last frame is held after the end of the sequence
+		/// @param[in] t time
+		/// @param[out] values n_values interpolated values
+		void interpolate(const double t, Eigen::VectorXd &values) const;
+
+	private:
+		/// @brief reads the i-th frame
+		void read_frame(const int i, Eigen::VectorXd &frame) const;
+		/// @brief asks the operating system to start reading the i-th frame
+		void prefetch(const int i) const;
+
+		size_t frame_size() const { return size_t(n_values_) * sizeof(double); }
+
+		const int n_values_;
+		const double fps_;
+		int n_frames_ = 0;
+
+		std::string path_;
+		std::ofstream out_;
+
+		const char *data_ = nullptr;
+		size_t size_ = 0;
+	};
+} // namespace polyfem::mesh
@@ -8,6 +8,7 @@
 #include <polyfem/mesh/MeshUtils.hpp>
 #include <polyfem/utils/StringUtils.hpp>
 #include <polyfem/io/MshReader.hpp>
+#include <polyfem/io/BinaryMesh.hpp>
 
 #include <polyfem/utils/Logger.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
@@ -228,6 +229,36 @@ namespace polyfem::mesh
 
 			return mesh;
 		}
+		else if (StringUtils::endswith(lowername, ".pfm"))
+		{
+			// the mesh is built directly from the mapped file, the edges and faces are precomputed
+			BinaryMeshReader reader;
+			if (!reader.open(path))
+			{
+				logger().error("Failed to load binary mesh: {}", path);
+				return nullptr;
+			}
+
+			const auto vertices = reader.vertices();
+			std::unique_ptr<Mesh> mesh = create(reader.dimension(), non_conforming);
+			mesh->build_from_matrices(vertices, reader.cells());
+
+			mesh->in_ordered_vertices_ = Eigen::VectorXi::LinSpaced(vertices.rows(), 0, vertices.rows() - 1);
+			mesh->in_ordered_edges_ = reader.edges();
+			mesh->in_ordered_faces_ = reader.faces();
+
+			const std::vector<int> body_ids = reader.body_ids();
+			if (!body_ids.empty())
+				mesh->set_body_ids(body_ids);
+
+			const std::vector<int> boundary_ids = reader.boundary_ids();
+			if (boundary_ids.size() == mesh->n_boundary_elements())
+				mesh->set_boundary_ids(boundary_ids);
+			else if (!boundary_ids.empty())
+				logger().warn("Ignoring the {} boundary ids of {}, the mesh has {} boundary primitives", boundary_ids.size(), path, mesh->n_boundary_elements());
+
+			return mesh;
+		}
 		else
 		{
 			GEO::Mesh tmp;
@@ -255,6 +286,13 @@ namespace polyfem::mesh
 		assert(mesh->in_ordered_vertices_[2] == 2);
 		assert(mesh->in_ordered_vertices_[mesh->in_ordered_vertices_.size() - 1] == vertices.rows() - 1);
 
+		build_in_ordered_primitives(dim, cells, mesh->in_ordered_edges_, mesh->in_ordered_faces_);
+
+		return mesh;
+	}
+
+	void Mesh::build_in_ordered_primitives(const int dim, const Eigen::MatrixXi &cells, Eigen::MatrixXi &in_edges, Eigen::MatrixXi &in_faces)
+	{
 		if (dim == 2)
 		{
 			std::unordered_set<std::pair<int, int>, HashPair> edges;
@@ -267,30 +305,28 @@ namespace polyfem::mesh
 					edges.emplace(std::pair<int, int>(std::min(v0, v1), std::max(v0, v1)));
 				}
 			}
-			mesh->in_ordered_edges_.resize(edges.size(), 2);
+			in_edges.resize(edges.size(), 2);
 			int index = 0;
 			for (auto it = edges.begin(); it != edges.end(); ++it)
 			{
-				mesh->in_ordered_edges_(index, 0) = it->first;
-				mesh->in_ordered_edges_(index, 1) = it->second;
+				in_edges(index, 0) = it->first;
+				in_edges(index, 1) = it->second;
 				++index;
 			}
 
-			assert(mesh->in_ordered_edges_.size() > 0);
+			assert(in_edges.size() > 0);
 
-			mesh->in_ordered_faces_.resize(0, 0);
+			in_faces.resize(0, 0);
 		}
 		else
 		{
 			if (cells.cols() == 4)
 			{
-				get_faces(cells, mesh->in_ordered_faces_);
-				igl::edges(mesh->in_ordered_faces_, mesh->in_ordered_edges_);
+				get_faces(cells, in_faces);
+				igl::edges(in_faces, in_edges);
 			}
 			// else TODO
 		}
-
-		return mesh;
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
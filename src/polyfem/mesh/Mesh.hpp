@@ -96,6 +96,15 @@ namespace polyfem
 			/// @return pointer to the mesh
 			static std::unique_ptr<Mesh> create(const int dim, const bool non_conforming = false);
 
+			///
+			/// computes the unique edges and faces of a list of cells, in the order of in_ordered_edges and in_ordered_faces
+			///
+			/// @param[in] dim dimension of the mesh
+			/// @param[in] cells list of cells
+			/// @param[out] edges unique edges, one per row
+			/// @param[out] faces unique faces, one per row (only for tets)
+			static void build_in_ordered_primitives(const int dim, const Eigen::MatrixXi &cells, Eigen::MatrixXi &edges, Eigen::MatrixXi &faces);
+
 			/// @brief Create a copy of the mesh
 			/// @return pointer to the new copy mesh
 			virtual std::unique_ptr<Mesh> copy() const = 0;
@@ -253,7 +262,7 @@ namespace polyfem
 			/// @param[in] V vertices
 			/// @param[in] F connectivity
 			/// @return if success
-			virtual bool build_from_matrices(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F) = 0;
+			virtual bool build_from_matrices(const Eigen::Ref<const Eigen::MatrixXd> &V, const Eigen::Ref<const Eigen::MatrixXi> &F) = 0;
 
 		public:
 			/// @brief attach high order nodes
@@ -174,6 +174,27 @@ namespace polyfem::mesh
 		return primitive_to_node_[primitive_id];
 	}
 
+	void MeshNodes::reorder_nodes(const Eigen::VectorXi &new_node_ids)
+	{
+		assert(new_node_ids.size() == n_nodes());
+
+		for (int &node : primitive_to_node_)
+		{
+			if (node >= 0)
+				node = new_node_ids[node];
+		}
+
+		std::vector<int> node_to_primitive(n_nodes());
+		std::vector<int> node_to_primitive_gid(n_nodes());
+		for (int i = 0; i < n_nodes(); ++i)
+		{
+			node_to_primitive[new_node_ids[i]] = node_to_primitive_[i];
+			node_to_primitive_gid[new_node_ids[i]] = node_to_primitive_gid_[i];
+		}
+		node_to_primitive_ = std::move(node_to_primitive);
+		node_to_primitive_gid_ = std::move(node_to_primitive_gid);
+	}
+
 	std::vector<int> MeshNodes::node_ids_from_edge(const Navigation::Index &index, const int n_new_nodes)
 	{
 		std::vector<int> res;
@@ -4,6 +4,7 @@
 #include <polyfem/utils/JSONUtils.hpp>
 #include <polyfem/utils/StringUtils.hpp>
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MatrixUtils.hpp>
 
 #include <igl/edges.h>
 #include <ipc/utils/eigen_ext.hpp>
@@ -31,6 +32,7 @@ namespace polyfem
 			in_v_.resize(0);
 
 			displacements_.clear();
+			keyframes_.clear();
 
 			endings_.clear();
 
@@ -103,6 +105,7 @@ namespace polyfem
 			append_mesh(vertices, codim_vertices, codim_edges, faces);
 
 			displacements_.emplace_back();
+			keyframes_.emplace_back();
 			for (size_t d = 0; d < dim_; ++d)
 			{
 				assert(displacement["value"].is_array());
@@ -126,38 +129,48 @@ namespace polyfem
 			const Eigen::VectorXi &codim_vertices,
 			const Eigen::MatrixXi &codim_edges,
 			const Eigen::MatrixXi &faces,
-			const int fps)
+			const int fps,
+			const std::string &keyframes_dir)
 		{
-			if (vertices.size() == 0 || vertices[0].size() == 0)
+			if (vertices.size() == 0)
+				return;
+
+			append_mesh_sequence(
+				vertices[0], codim_vertices, codim_edges, faces, fps, vertices.size(),
+				[&](const int i, Eigen::MatrixXd &frame) { frame = vertices[i]; }, keyframes_dir);
+		}
+
+		void Obstacle::append_mesh_sequence(
+			const Eigen::MatrixXd &vertices,
+			const Eigen::VectorXi &codim_vertices,
+			const Eigen::MatrixXi &codim_edges,
+			const Eigen::MatrixXi &faces,
+			const int fps,
+			const int n_frames,
+			const std::function<void(const int i, Eigen::MatrixXd &vertices)> &load_frame,
+			const std::string &keyframes_dir)
+		{
+			if (vertices.size() == 0)
 				return;
 
-			append_mesh(vertices[0], codim_vertices, codim_edges, faces);
+			append_mesh(vertices, codim_vertices, codim_edges, faces);
 
-			std::array<std::vector<Eigen::MatrixXd>, 3> displacements_xyz;
-			for (size_t i = 0; i < vertices.size(); ++i)
+			// frames are stored flattened per vertex, as the obstacle part of the solution
+			auto keyframes = std::make_shared<KeyframeStore>(vertices.size(), fps, keyframes_dir);
+			keyframes->append(Eigen::VectorXd::Zero(vertices.size()));
+
+			Eigen::MatrixXd frame;
+			for (int i = 1; i < n_frames; ++i)
 			{
-				Eigen::MatrixXd displacement = vertices[i] - vertices[0];
-				for (size_t d = 0; d < dim_; ++d)
-					displacements_xyz[d].push_back(displacement.col(d));
+				load_frame(i, frame);
+				if (frame.rows() != vertices.rows() || frame.cols() != vertices.cols())
+					log_and_throw_error("Frame {} of the mesh sequence has {} vertices instead of {}!", i, frame.rows(), vertices.rows());
+				keyframes->append(utils::flatten(frame - vertices));
 			}
+			keyframes->finalize();
 
 			displacements_.emplace_back();
-			for (size_t d = 0; d < dim_; ++d)
-			{
-				const std::vector<Eigen::MatrixXd> displacements = displacements_xyz[d];
-				displacements_.back().value[d].init(
-					[displacements, fps](double x, double y, double z, double t, int index) -> double {
-						const double frame = t * fps;
-						const double interp = frame - floor(frame);
-						const int frame0 = (int)floor(frame);
-						const int frame1 = (int)ceil(frame);
-						if (frame1 >= displacements.size())
-							return displacements.back()(index);
-						const double u0 = displacements[frame0](index);
-						const double u1 = displacements[frame1](index);
-						return (u1 - u0) * interp + u0;
-					});
-			}
+			keyframes_.push_back(keyframes);
 		}
 
 		void Obstacle::append_plane(const VectorNd &origin, const VectorNd &normal)
@@ -184,6 +197,7 @@ namespace polyfem
 
 		void Obstacle::change_displacement(const int oid, const Eigen::RowVector3d &val, const std::shared_ptr<Interpolation> &interp)
 		{
+			keyframes_[oid] = nullptr;
 			for (size_t k = 0; k < val.size(); ++k)
 				displacements_[oid].value[k].init(val[k]);
 
@@ -193,6 +207,7 @@ namespace polyfem
 
 		void Obstacle::change_displacement(const int oid, const std::function<Eigen::MatrixXd(double x, double y, double z, double t)> &func, const std::shared_ptr<Interpolation> &interp)
 		{
+			keyframes_[oid] = nullptr;
 			for (size_t k = 0; k < displacements_.back().value.size(); ++k)
 				displacements_[oid].value[k].init(func, k);
 
@@ -202,6 +217,7 @@ namespace polyfem
 
 		void Obstacle::change_displacement(const int oid, const json &val, const std::shared_ptr<Interpolation> &interp)
 		{
+			keyframes_[oid] = nullptr;
 			for (size_t k = 0; k < val.size(); ++k)
 				displacements_[oid].value[k].init(val[k]);
 
@@ -221,6 +237,19 @@ namespace polyfem
 				const int to = endings_[k];
 				const auto &disp = displacements_[k];
 
+				if (keyframes_[k])
+				{
+					Eigen::VectorXd frame;
+					keyframes_[k]->interpolate(t, frame);
+					if (sol.cols() == 1)
+						sol.middleRows(offset + start * dim_, frame.size()) = frame;
+					else
+						sol.middleRows(offset + start, to - start) = utils::unflatten(frame, dim_);
+
+					start = to;
+					continue;
+				}
+
 				for (int i = start; i < to; ++i)
 				{
 					for (int d = 0; d < dim_; ++d)
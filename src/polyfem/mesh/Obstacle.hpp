@@ -6,9 +6,13 @@
 #include <polyfem/utils/Types.hpp>
 
 #include <polyfem/assembler/GenericProblem.hpp>
+#include <polyfem/mesh/KeyframeStore.hpp>
 
 #include <Eigen/Dense>
 
+#include <functional>
+#include <memory>
+
 namespace polyfem
 {
 	namespace mesh
@@ -30,7 +34,22 @@ namespace polyfem
 				const Eigen::VectorXi &codim_vertices,
 				const Eigen::MatrixXi &codim_edges,
 				const Eigen::MatrixXi &faces,
-				const int fps);
+				const int fps,
+				const std::string &keyframes_dir = "");
+			/// @brief appends a mesh sequence loading one frame at a time, the displacements are kept on disk (see KeyframeStore)
+			/// @param[in] vertices vertices of the first frame
+			/// @param[in] n_frames number of frames, including the first one
+			/// @param[in] load_frame loads the vertices of the i-th frame, for i > 0
+			/// @param[in] keyframes_dir directory of the file holding the displacements, the current directory if empty
+			void append_mesh_sequence(
+				const Eigen::MatrixXd &vertices,
+				const Eigen::VectorXi &codim_vertices,
+				const Eigen::MatrixXi &codim_edges,
+				const Eigen::MatrixXi &faces,
+				const int fps,
+				const int n_frames,
+				const std::function<void(const int i, Eigen::MatrixXd &vertices)> &load_frame,
+				const std::string &keyframes_dir = "");
 			void append_plane(const VectorNd &point, const VectorNd &normal);
 
 			inline int n_vertices() const { return v_.rows(); }
@@ -83,6 +102,8 @@ namespace polyfem
 			Eigen::MatrixXi in_e_;
 
 			std::vector<assembler::TensorBCValue> displacements_;
+			/// displacements of the mesh sequences, null for the other meshes
+			std::vector<std::shared_ptr<const KeyframeStore>> keyframes_;
 
 			std::vector<int> endings_;
 
@@ -170,7 +170,7 @@ namespace polyfem
 			return true;
 		}
 
-		bool CMesh2D::build_from_matrices(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F)
+		bool CMesh2D::build_from_matrices(const Eigen::Ref<const Eigen::MatrixXd> &V, const Eigen::Ref<const Eigen::MatrixXi> &F)
 		{
 			edge_nodes_.clear();
 			face_nodes_.clear();
@@ -55,7 +55,7 @@ namespace polyfem
 
 			bool save(const std::string &path) const override;
 
-			bool build_from_matrices(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F) override;
+			bool build_from_matrices(const Eigen::Ref<const Eigen::MatrixXd> &V, const Eigen::Ref<const Eigen::MatrixXi> &F) override;
 
 			void attach_higher_order_nodes(const Eigen::MatrixXd &V, const std::vector<std::vector<int>> &nodes) override;
 			RowVectorNd edge_node(const Navigation::Index &index, const int n_new_nodes, const int i) const override;
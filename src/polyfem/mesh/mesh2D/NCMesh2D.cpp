@@ -36,7 +36,7 @@ namespace polyfem
 			refine(n_refinement - 1, t);
 		}
 
-		bool NCMesh2D::build_from_matrices(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F)
+		bool NCMesh2D::build_from_matrices(const Eigen::Ref<const Eigen::MatrixXd> &V, const Eigen::Ref<const Eigen::MatrixXi> &F)
 		{
 			GEO::Mesh mesh_;
 			mesh_.clear(false, false);
@@ -247,10 +247,32 @@ namespace polyfem
 			for (int i = 0; i < ids.size(); i++)
 				full_ids[i] = valid_to_all_elem(ids[i]);
 
+			prev_valid_to_all_elemMap = valid_to_all_elemMap;
+
 			for (int i : full_ids)
 				refine_element(i);
 		}
 
+		std::vector<int> NCMesh2D::elements_before_refinement() const
+		{
+			assert(index_prepared);
+
+			std::vector<int> all_to_prev(elements.size(), -1);
+			for (int i = 0; i < prev_valid_to_all_elemMap.size(); i++)
+				all_to_prev[prev_valid_to_all_elemMap[i]] = i;
+
+			std::vector<int> ancestors(n_elements, -1);
+			for (int e = 0; e < n_elements; e++)
+			{
+				int id = valid_to_all_elem(e);
+				while (id >= 0 && all_to_prev[id] < 0)
+					id = elements[id].parent;
+				ancestors[e] = id >= 0 ? all_to_prev[id] : -1;
+			}
+
+			return ancestors;
+		}
+
 		void NCMesh2D::coarsen_element(int id_full)
 		{
 			const int parent_id = elements[id_full].parent;
@@ -466,7 +466,7 @@ namespace polyfem
 			return true;
 		}
 
-		bool CMesh3D::build_from_matrices(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F)
+		bool CMesh3D::build_from_matrices(const Eigen::Ref<const Eigen::MatrixXd> &V, const Eigen::Ref<const Eigen::MatrixXi> &F)
 		{
 			assert(F.cols() == 4 || F.cols() == 8);
 			edge_nodes_.clear();
@@ -1349,12 +1349,13 @@ namespace polyfem
 
 			// boundary flags
 			std::vector<bool> bv_flag(mesh_.vertices.size(), false), be_flag(mesh_.edges.size(), false), bf_flag(mesh_.faces.size(), false);
-			for (auto f : mesh_.faces)
+			const Mesh3DAdjacency &adj = mesh_.adjacency;
+			for (const auto &f : mesh_.faces)
 				if (f.boundary)
 					bf_flag[f.id] = true;
 				else
 				{
-					for (auto nhid : f.neighbor_hs)
+					for (auto nhid : adj.f2h[f.id])
 						if (!mesh_.elements[nhid].hex)
 							bf_flag[f.id] = true;
 				}
@@ -1375,7 +1376,7 @@ namespace polyfem
 					;
 					for (auto vid : ele.vs)
 					{
-						for (auto eleid : mesh_.vertices[vid].neighbor_hs)
+						for (auto eleid : adj.v2h[vid])
 							if (!mesh_.elements[eleid].hex)
 							{
 								attaching_non_hex = true;
@@ -1407,7 +1408,7 @@ namespace polyfem
 							if (be_flag[eid])
 							{
 								boundary_edge = true;
-								for (auto nhid : mesh_.edges[eid].neighbor_hs)
+								for (auto nhid : adj.e2h[eid])
 									if (mesh_.elements[nhid].hex)
 										en++;
 								if (en > 2)
@@ -1415,7 +1416,7 @@ namespace polyfem
 							}
 							else
 							{
-								for (auto nhid : mesh_.edges[eid].neighbor_hs)
+								for (auto nhid : adj.e2h[eid])
 									if (mesh_.elements[nhid].hex)
 										en++;
 								if (en != 4)
@@ -1436,7 +1437,7 @@ namespace polyfem
 							if (bv_flag[vid])
 							{
 								int nh = 0;
-								for (auto nhid : mesh_.vertices[vid].neighbor_hs)
+								for (auto nhid : adj.v2h[vid])
 									if (mesh_.elements[nhid].hex)
 										nh++;
 								if (nh > 4)
@@ -1445,12 +1446,12 @@ namespace polyfem
 							}
 							else
 							{
-								if (mesh_.vertices[vid].neighbor_hs.size() != 8)
+								if (adj.v2h[vid].size() != 8)
 									n_in_irregular_v++;
 								int n_irregular_e = 0;
-								for (auto eid : mesh_.vertices[vid].neighbor_es)
+								for (auto eid : adj.v2e[vid])
 								{
-									if (mesh_.edges[eid].neighbor_hs.size() != 4)
+									if (adj.e2h[eid].size() != 4)
 										n_irregular_e++;
 								}
 								if (n_irregular_e != 0 && n_irregular_e != 2)
@@ -1462,7 +1463,7 @@ namespace polyfem
 						}
 						int n_irregular_e = 0;
 						for (auto eid : ele.es)
-							if (!be_flag[eid] && mesh_.edges[eid].neighbor_hs.size() != 4)
+							if (!be_flag[eid] && adj.e2h[eid].size() != 4)
 								n_irregular_e++;
 						if (has_singular_v)
 							continue;
@@ -1483,7 +1484,7 @@ namespace polyfem
 					// type 1
 					bool has_irregular_v = false;
 					for (auto vid : ele.vs)
-						if (mesh_.vertices[vid].neighbor_hs.size() != 8)
+						if (adj.v2h[vid].size() != 8)
 						{
 							has_irregular_v = true;
 							break;
@@ -1498,12 +1499,12 @@ namespace polyfem
 					int n_irregular_v = 0;
 					for (auto vid : ele.vs)
 					{
-						if (mesh_.vertices[vid].neighbor_hs.size() != 8)
+						if (adj.v2h[vid].size() != 8)
 							n_irregular_v++;
 						int n_irregular_e = 0;
-						for (auto eid : mesh_.vertices[vid].neighbor_es)
+						for (auto eid : adj.v2e[vid])
 						{
-							if (mesh_.edges[eid].neighbor_hs.size() != 4)
+							if (adj.e2h[eid].size() != 4)
 								n_irregular_e++;
 						}
 						if (n_irregular_e != 0 && n_irregular_e != 2)
@@ -54,7 +54,7 @@ namespace polyfem
 
 			bool save(const std::string &path) const override;
 
-			bool build_from_matrices(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F) override;
+			bool build_from_matrices(const Eigen::Ref<const Eigen::MatrixXd> &V, const Eigen::Ref<const Eigen::MatrixXi> &F) override;
 
 			void attach_higher_order_nodes(const Eigen::MatrixXd &V, const std::vector<std::vector<int>> &nodes) override;
 
@@ -80,8 +80,8 @@ namespace polyfem
 			Navigation3D::Index get_index_from_element_edge(int hi, int v0, int v1) const override { return Navigation3D::get_index_from_element_edge(mesh_, hi, v0, v1); }
 			Navigation3D::Index get_index_from_element_face(int hi, int v0, int v1, int v2) const override { return Navigation3D::get_index_from_element_tri(mesh_, hi, v0, v1, v2); }
 
-			inline std::vector<uint32_t> vertex_neighs(const int v_gid) const override { return mesh_.vertices[v_gid].neighbor_hs; }
-			inline std::vector<uint32_t> edge_neighs(const int e_gid) const override { return mesh_.edges[e_gid].neighbor_hs; }
+			inline std::vector<uint32_t> vertex_neighs(const int v_gid) const override { return mesh_.adjacency.v2h.to_vector(v_gid); }
+			inline std::vector<uint32_t> edge_neighs(const int e_gid) const override { return mesh_.adjacency.e2h.to_vector(e_gid); }
 
 			// Navigation in a surface mesh
 			Navigation3D::Index switch_vertex(Navigation3D::Index idx) const override { return Navigation3D::switch_vertex(mesh_, idx); }
@@ -95,13 +95,13 @@ namespace polyfem
 
 			void get_vertex_elements_neighs(const int v_id, std::vector<int> &ids) const override
 			{
-				ids.clear();
-				ids.insert(ids.begin(), mesh_.vertices[v_id].neighbor_hs.begin(), mesh_.vertices[v_id].neighbor_hs.end());
+				const CSRAdjacency::Range neighs = mesh_.adjacency.v2h[v_id];
+				ids.assign(neighs.begin(), neighs.end());
 			}
 			void get_edge_elements_neighs(const int e_id, std::vector<int> &ids) const override
 			{
-				ids.clear();
-				ids.insert(ids.begin(), mesh_.edges[e_id].neighbor_hs.begin(), mesh_.edges[e_id].neighbor_hs.end());
+				const CSRAdjacency::Range neighs = mesh_.adjacency.e2h[e_id];
+				ids.assign(neighs.begin(), neighs.end());
 			}
 
 			void compute_boundary_ids(const double eps) override;
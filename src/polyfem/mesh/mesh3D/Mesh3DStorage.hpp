@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 #include <Eigen/Dense>
 
 namespace polyfem
@@ -50,6 +51,76 @@ namespace polyfem
 			std::vector<double> v_in_Kernel;
 		};
 
+		/// Flat (compressed sparse row) storage of an adjacency relation.
+		/// The neighbors of primitive i are indices[offsets[i]], ..., indices[offsets[i + 1] - 1].
+		struct CSRAdjacency
+		{
+			/// Read-only view over the neighbors of one primitive
+			class Range
+			{
+			public:
+				Range(const uint32_t *first, const uint32_t *last) : first_(first), last_(last) {}
+				Range(const std::vector<uint32_t> &v) : first_(v.data()), last_(v.data() + v.size()) {}
+
+				inline const uint32_t *begin() const { return first_; }
+				inline const uint32_t *end() const { return last_; }
+				inline size_t size() const { return last_ - first_; }
+				inline bool empty() const { return first_ == last_; }
+				inline uint32_t operator[](const size_t i) const { return first_[i]; }
+
+			private:
+				const uint32_t *first_;
+				const uint32_t *last_;
+			};
+
+			std::vector<uint32_t> offsets;
+			std::vector<uint32_t> indices;
+
+			inline size_t n_rows() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+			inline bool empty() const { return n_rows() == 0; }
+			inline uint32_t degree(const int i) const { return offsets[i + 1] - offsets[i]; }
+			inline Range operator[](const int i) const { return Range(indices.data() + offsets[i], indices.data() + offsets[i + 1]); }
+
+			inline void clear()
+			{
+				offsets.clear();
+				indices.clear();
+			}
+
+			inline std::vector<uint32_t> to_vector(const int i) const
+			{
+				return std::vector<uint32_t>(indices.begin() + offsets[i], indices.begin() + offsets[i + 1]);
+			}
+		};
+
+		/// Flat incidence relations of a Mesh3DStorage, built once the connectivity is final
+		/// (see MeshProcessing3D::build_flat_connectivity) and used by the navigation queries.
+		/// Navigation3D::prepare_mesh then frees the neighbor_* lists, the refinement refills them
+		/// from here (MeshProcessing3D::restore_neighbors).
+		struct Mesh3DAdjacency
+		{
+			CSRAdjacency v2v; // vertex -> vertices
+			CSRAdjacency v2e; // vertex -> edges
+			CSRAdjacency v2f; // vertex -> faces
+			CSRAdjacency v2h; // vertex -> elements
+			CSRAdjacency e2f; // edge -> faces
+			CSRAdjacency e2h; // edge -> elements
+			CSRAdjacency f2h; // face -> elements
+
+			inline bool empty() const { return f2h.empty(); }
+
+			inline void clear()
+			{
+				v2v.clear();
+				v2e.clear();
+				v2f.clear();
+				v2h.clear();
+				e2f.clear();
+				e2h.clear();
+				f2h.clear();
+			}
+		};
+
 		enum class MeshType
 		{
 			TRI = 0,
@@ -74,6 +145,8 @@ namespace polyfem
 			Eigen::MatrixXi FV, FE, FH, FHi; // FV (3, nf), FE(3, nf), FH (2, nf), FHi(2, nf)
 			Eigen::MatrixXi HV, HF;          // HV(4, nh), HE(6, nh), HF(4, nh)
 
+			Mesh3DAdjacency adjacency; // neighbor relations of a prepared mesh
+
 			void append(const Mesh3DStorage &other)
 			{
 				if (other.type != type)
@@ -160,6 +233,8 @@ namespace polyfem
 					elements.push_back(tmp);
 				}
 				assert(elements.size() == n_c + other.elements.size());
+				// rebuilt by Navigation3D::prepare_mesh
+				adjacency.clear();
 				EV.resize(0, 0);
 				// assert(EV.size() == 0 || EV.rows() == other.EV.rows());
 				// EV.conservativeResize(std::max(EV.rows(), other.EV.rows()), other.EV.cols() + EV.cols());
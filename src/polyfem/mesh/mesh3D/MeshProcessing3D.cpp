@@ -1,9 +1,11 @@
 #include "MeshProcessing3D.hpp"
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 
 #include <Eigen/Dense>
 
 #include <algorithm>
+#include <array>
 #include <map>
 #include <set>
 #include <queue>
@@ -15,6 +17,144 @@ using namespace polyfem;
 using namespace std;
 using namespace Eigen;
 
+namespace
+{
+	// Counting transpose of the relation i -> rows(i), where rows(i) lists indices in [0, n_cols).
+	// The neighbors of every column come out sorted by row index, i.e., in the same order as
+	// pushing back the rows one after the other.
+	template <typename Rows>
+	void transpose_relation(const int n_rows, const int n_cols, const Rows &rows, CSRAdjacency &out)
+	{
+		out.offsets.assign(n_cols + 1, 0);
+		for (int i = 0; i < n_rows; ++i)
+			for (const uint32_t j : rows(i))
+				++out.offsets[j + 1];
+		for (int j = 0; j < n_cols; ++j)
+			out.offsets[j + 1] += out.offsets[j];
+
+		std::vector<uint32_t> next(out.offsets.begin(), out.offsets.end() - 1);
+		out.indices.resize(out.offsets.back());
+		for (int i = 0; i < n_rows; ++i)
+			for (const uint32_t j : rows(i))
+				out.indices[next[j]++] = i;
+	}
+
+	// Flattens the per-primitive lists prims[i].*member into out
+	template <typename T>
+	void flatten_neighbors(const std::vector<T> &prims, std::vector<uint32_t> T::*member, CSRAdjacency &out)
+	{
+		out.offsets.resize(prims.size() + 1);
+		out.offsets[0] = 0;
+		for (size_t i = 0; i < prims.size(); ++i)
+			out.offsets[i + 1] = out.offsets[i] + (prims[i].*member).size();
+
+		out.indices.resize(out.offsets.back());
+		utils::maybe_parallel_for(int(prims.size()), [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+				std::copy((prims[i].*member).begin(), (prims[i].*member).end(), out.indices.begin() + out.offsets[i]);
+		});
+	}
+
+	// Copies the rows of adj into the per-primitive lists prims[i].*member
+	template <typename T>
+	void assign_neighbors(const CSRAdjacency &adj, std::vector<T> &prims, std::vector<uint32_t> T::*member)
+	{
+		assert(adj.n_rows() == prims.size());
+		utils::maybe_parallel_for(int(prims.size()), [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+				prims[i].*member = adj.to_vector(i);
+		});
+	}
+
+	// v2v is v2e where every edge is replaced by its other endpoint
+	void vertex_vertex_from_edges(const Mesh3DStorage &hmi, const CSRAdjacency &v2e, CSRAdjacency &v2v)
+	{
+		v2v.offsets = v2e.offsets;
+		v2v.indices.resize(v2e.indices.size());
+		utils::maybe_parallel_for(int(v2e.n_rows()), [&](int start, int end, int thread_id) {
+			for (int v = start; v < end; ++v)
+				for (uint32_t k = v2e.offsets[v]; k < v2e.offsets[v + 1]; ++k)
+				{
+					const auto &evs = hmi.edges[v2e.indices[k]].vs;
+					v2v.indices[k] = evs[0] == uint32_t(v) ? evs[1] : evs[0];
+				}
+		});
+	}
+
+	// the edge of the face f joining v0 and v1
+	uint32_t find_face_edge(const Mesh3DStorage &M, const Face &f, const uint32_t v0, const uint32_t v1)
+	{
+		for (const uint32_t e : f.es)
+		{
+			const auto &evs = M.edges[e].vs;
+			if ((evs[0] == v0 && evs[1] == v1) || (evs[0] == v1 && evs[1] == v0))
+				return e;
+		}
+		assert(false);
+		return -1;
+	}
+
+	// the edge of the tet ele joining v0 and v1
+	uint32_t find_tet_edge(const Mesh3DStorage &M, const Element &ele, const uint32_t v0, const uint32_t v1)
+	{
+		for (const uint32_t f : ele.fs)
+		{
+			const auto &fvs = M.faces[f].vs;
+			if (std::find(fvs.begin(), fvs.end(), v0) != fvs.end() && std::find(fvs.begin(), fvs.end(), v1) != fvs.end())
+				return find_face_edge(M, M.faces[f], v0, v1);
+		}
+		assert(false);
+		return -1;
+	}
+} // namespace
+
+void MeshProcessing3D::build_flat_connectivity(Mesh3DStorage &hmi)
+{
+	// build_connectivity already computed every relation, they only need to be packed
+	Mesh3DAdjacency &adj = hmi.adjacency;
+	flatten_neighbors(hmi.vertices, &Vertex::neighbor_vs, adj.v2v);
+	flatten_neighbors(hmi.vertices, &Vertex::neighbor_es, adj.v2e);
+	flatten_neighbors(hmi.vertices, &Vertex::neighbor_fs, adj.v2f);
+	flatten_neighbors(hmi.vertices, &Vertex::neighbor_hs, adj.v2h);
+	flatten_neighbors(hmi.edges, &Edge::neighbor_fs, adj.e2f);
+	flatten_neighbors(hmi.edges, &Edge::neighbor_hs, adj.e2h);
+	flatten_neighbors(hmi.faces, &Face::neighbor_hs, adj.f2h);
+}
+
+void MeshProcessing3D::release_neighbors(Mesh3DStorage &hmi)
+{
+	for (auto &v : hmi.vertices)
+	{
+		std::vector<uint32_t>().swap(v.neighbor_vs);
+		std::vector<uint32_t>().swap(v.neighbor_es);
+		std::vector<uint32_t>().swap(v.neighbor_fs);
+		std::vector<uint32_t>().swap(v.neighbor_hs);
+	}
+	for (auto &e : hmi.edges)
+	{
+		std::vector<uint32_t>().swap(e.neighbor_fs);
+		std::vector<uint32_t>().swap(e.neighbor_hs);
+	}
+	for (auto &f : hmi.faces)
+		std::vector<uint32_t>().swap(f.neighbor_hs);
+}
+
+void MeshProcessing3D::restore_neighbors(Mesh3DStorage &hmi)
+{
+	// meshes that did not go through Navigation3D::prepare_mesh still have their lists
+	const Mesh3DAdjacency &adj = hmi.adjacency;
+	if (adj.empty())
+		return;
+
+	assign_neighbors(adj.v2v, hmi.vertices, &Vertex::neighbor_vs);
+	assign_neighbors(adj.v2e, hmi.vertices, &Vertex::neighbor_es);
+	assign_neighbors(adj.v2f, hmi.vertices, &Vertex::neighbor_fs);
+	assign_neighbors(adj.v2h, hmi.vertices, &Vertex::neighbor_hs);
+	assign_neighbors(adj.e2f, hmi.edges, &Edge::neighbor_fs);
+	assign_neighbors(adj.e2h, hmi.edges, &Edge::neighbor_hs);
+	assign_neighbors(adj.f2h, hmi.faces, &Face::neighbor_hs);
+}
+
 void MeshProcessing3D::build_connectivity(Mesh3DStorage &hmi)
 {
 	hmi.edges.clear();
@@ -197,41 +337,28 @@ void MeshProcessing3D::build_connectivity(Mesh3DStorage &hmi)
 					hmi.vertices[hmi.faces[i].vs[j]].boundary = true;
 				}
 	}
-	// f_nhs;
-	for (auto &f : hmi.faces)
-		f.neighbor_hs.clear();
-	for (uint32_t i = 0; i < hmi.elements.size(); i++)
-	{
-		for (uint32_t j = 0; j < hmi.elements[i].fs.size(); j++)
-		{
-			hmi.faces[hmi.elements[i].fs[j]].neighbor_hs.push_back(i);
-		}
-	}
-	// e_nfs, v_nfs
-	for (auto &e : hmi.edges)
-		e.neighbor_fs.clear();
-	for (auto &v : hmi.vertices)
-		v.neighbor_fs.clear();
-	for (uint32_t i = 0; i < hmi.faces.size(); i++)
-	{
-		for (uint32_t j = 0; j < hmi.faces[i].es.size(); j++)
-			hmi.edges[hmi.faces[i].es[j]].neighbor_fs.push_back(i);
-		for (uint32_t j = 0; j < hmi.faces[i].vs.size(); j++)
-			hmi.vertices[hmi.faces[i].vs[j]].neighbor_fs.push_back(i);
-	}
-	// v_nes, v_nvs
-	for (auto &v : hmi.vertices)
+	// f_nhs, e_nfs, v_nfs, v_nes, v_nvs
 	{
-		v.neighbor_es.clear();
-		v.neighbor_vs.clear();
-	}
-	for (uint32_t i = 0; i < hmi.edges.size(); i++)
-	{
-		uint32_t v0 = hmi.edges[i].vs[0], v1 = hmi.edges[i].vs[1];
-		hmi.vertices[v0].neighbor_es.push_back(i);
-		hmi.vertices[v1].neighbor_es.push_back(i);
-		hmi.vertices[v0].neighbor_vs.push_back(v1);
-		hmi.vertices[v1].neighbor_vs.push_back(v0);
+		CSRAdjacency adj;
+		transpose_relation(
+			hmi.elements.size(), hmi.faces.size(), [&](int i) -> const std::vector<uint32_t> & { return hmi.elements[i].fs; }, adj);
+		assign_neighbors(adj, hmi.faces, &Face::neighbor_hs);
+
+		transpose_relation(
+			hmi.faces.size(), hmi.edges.size(), [&](int i) -> const std::vector<uint32_t> & { return hmi.faces[i].es; }, adj);
+		assign_neighbors(adj, hmi.edges, &Edge::neighbor_fs);
+
+		transpose_relation(
+			hmi.faces.size(), hmi.vertices.size(), [&](int i) -> const std::vector<uint32_t> & { return hmi.faces[i].vs; }, adj);
+		assign_neighbors(adj, hmi.vertices, &Vertex::neighbor_fs);
+
+		transpose_relation(
+			hmi.edges.size(), hmi.vertices.size(), [&](int i) -> const std::vector<uint32_t> & { return hmi.edges[i].vs; }, adj);
+		assign_neighbors(adj, hmi.vertices, &Vertex::neighbor_es);
+
+		CSRAdjacency v2v;
+		vertex_vertex_from_edges(hmi, adj, v2v);
+		assign_neighbors(v2v, hmi.vertices, &Vertex::neighbor_vs);
 	}
 	// e_nhs
 	for (auto &e : hmi.edges)
@@ -713,6 +840,7 @@ void MeshProcessing3D::global_orientation_hexes(Mesh3DStorage &hmi)
 }
 void MeshProcessing3D::refine_catmul_clark_polar(Mesh3DStorage &M, int iter, bool reverse, std::vector<int> &Parents)
 {
+	restore_neighbors(M);
 
 	for (int i = 0; i < iter; i++)
 	{
@@ -1121,251 +1249,201 @@ void MeshProcessing3D::refine_catmul_clark_polar(Mesh3DStorage &M, int iter, boo
 }
 void MeshProcessing3D::refine_red_refinement_tet(Mesh3DStorage &M, int iter)
 {
+	restore_neighbors(M);
 
-	// double hmin=10000, hmax=0, havg=0;
-	// for(const auto & e:M.edges){
-	// 	Eigen::Vector3d v0 = M.points.col(e.vs[0]), v1 = M.points.col(e.vs[1]);
-	// 	double len = (v0-v1).norm();
-	// 	if(len<hmin) hmin=len;
-	// 	if(len>hmax) hmax = len;
-	// 	havg+=len;
-	// }
-	// havg/=M.edges.size();
-	// std::cout<<"hmin, hmax, havg: "<<hmin<<" "<<hmax<<" "<<havg<<std::endl;
-
-	for (int i = 0; i < iter; i++)
+	// local edge of a tet joining two of its vertices
+	int local_edge[4][4];
+	for (int k = 0; k < 6; k++)
 	{
+		local_edge[tet_edges[k][0]][tet_edges[k][1]] = k;
+		local_edge[tet_edges[k][1]][tet_edges[k][0]] = k;
+	}
 
+	for (int it = 0; it < iter; it++)
+	{
+		const int n_v = M.vertices.size();
+		const int n_e = M.edges.size();
+		const int n_f = M.faces.size();
+		const int n_h = M.elements.size();
+
+		// every level writes directly at precomputed indices:
+		// vertex i stays i and the midpoint of edge e is n_v + e,
+		// element h is split into 8 * h, ..., 8 * h + 7,
+		// face f is split into 4 * f, ..., 4 * f + 3, and the 8 faces inside element h are 4 * n_f + 8 * h, ...
 		Mesh3DStorage M_;
 		M_.type = MeshType::TET;
 
-		vector<int> E2V(M.edges.size());
-
-		int vn = 0;
-		for (const auto &v : M.vertices)
-		{
-			Vertex v_;
-			v_.id = vn++;
-			v_.v.resize(3);
-			for (int j = 0; j < 3; j++)
-				v_.v[j] = M.points(j, v.id);
-			M_.vertices.push_back(v_);
-		}
+		M_.points.resize(3, n_v + n_e);
+		M_.vertices.resize(n_v + n_e);
+		utils::maybe_parallel_for(n_v + n_e, [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+			{
+				if (i < n_v)
+					M_.points.col(i) = M.points.col(M.vertices[i].id);
+				else
+				{
+					const auto &evs = M.edges[i - n_v].vs;
+					M_.points.col(i) = (M.points.col(evs[0]) + M.points.col(evs[1])) / 2;
+				}
 
-		for (const auto &e : M.edges)
-		{
-			Vertex v;
-			v.id = vn++;
-			v.v.resize(3);
+				Vertex &v = M_.vertices[i];
+				v.id = i;
+				v.v = {M_.points(0, i), M_.points(1, i), M_.points(2, i)};
+			}
+		});
 
-			Vector3d center;
-			center.setZero();
-			for (auto vid : e.vs)
-				center += M.points.col(vid);
-			center /= e.vs.size();
-			for (int j = 0; j < 3; j++)
-				v.v[j] = center[j];
+		// orientation of the input tets
+		const auto &t = M.elements[0].vs;
+		Vector3d c0 = M.points.col(t[0]);
+		Vector3d c1 = M.points.col(t[1]);
+		Vector3d c2 = M.points.col(t[2]);
+		Vector3d c3 = M.points.col(t[3]);
+		const bool signed_volume = a_jacobian(c0, c1, c2, c3) > 0;
 
-			M_.vertices.push_back(v);
-			E2V[e.id] = v.id;
-		}
-		// for (const auto &ele : M.elements) {
-		// 	Element ele_;
-		// 	ele_.id = M_.elements.size();
-		// 	ele_.fs.resize(4, -1);
-		// 	ele_.fs_flag.resize(4, 1);
-		// 	ele_.vs = ele.vs;
-
-		// 	ele_.hex = false;
-		// 	ele_.v_in_Kernel.resize(3);
-
-		// 	Vector3d center;
-		// 	center.setZero();
-		// 	for (const auto &evid : ele_.vs) for (int j = 0; j < 3; j++)center[j] += M_.vertices[evid].v[j];
-		// 	center /= ele_.vs.size();
-		// 	for (int j = 0; j < 3; j++)ele_.v_in_Kernel[j] = center[j];
-
-		// 	M_.elements.push_back(ele_);
-		// }
-
-		auto shared_edge = [&](int v0, int v1, int &e) -> bool {
-			auto &es0 = M.vertices[v0].neighbor_es, &es1 = M.vertices[v1].neighbor_es;
-			std::sort(es0.begin(), es0.end());
-			std::sort(es1.begin(), es1.end());
-			std::vector<uint32_t> es;
-			std::set_intersection(es0.begin(), es0.end(), es1.begin(), es1.end(), back_inserter(es));
-			if (es.size())
+		M_.elements.resize(8 * n_h);
+		utils::maybe_parallel_for(n_h, [&](int start, int end, int thread_id) {
+			for (int h = start; h < end; ++h)
 			{
-				e = es[0];
-				return true;
+				const Element &ele = M.elements[h];
+
+				std::array<uint32_t, 6> edges;
+				for (int k = 0; k < 6; k++)
+					edges[k] = find_tet_edge(M, ele, ele.vs[tet_edges[k][0]], ele.vs[tet_edges[k][1]]);
+
+				for (short i = 0; i < 8; i++)
+				{
+					Element &ele_ = M_.elements[8 * h + i];
+					ele_.id = 8 * h + i;
+					ele_.fs.assign(4, -1);
+					ele_.fs_flag.assign(4, 1);
+					ele_.hex = false;
+					ele_.vs.clear();
+
+					if (i < 4)
+					{
+						// four corners
+						ele_.vs.push_back(ele.vs[i]);
+						for (short j = 0; j < 4; j++)
+							if (j != i)
+								ele_.vs.push_back(n_v + edges[local_edge[i][j]]);
+					}
+					else
+					{
+						// the octahedron is split along the diagonal joining the midpoints of the edges 01 and 23
+						ele_.vs.push_back(n_v + edges[0]);
+						ele_.vs.push_back(n_v + edges[5]);
+						for (const uint32_t c_e : M.faces[ele.fs[i - 4]].es)
+							if (c_e != edges[0] && c_e != edges[5])
+								ele_.vs.push_back(n_v + c_e);
+					}
+					assert(ele_.vs.size() == 4);
+
+					Vector3d v0 = M_.points.col(ele_.vs[0]);
+					Vector3d v1 = M_.points.col(ele_.vs[1]);
+					Vector3d v2 = M_.points.col(ele_.vs[2]);
+					Vector3d v3 = M_.points.col(ele_.vs[3]);
+					if ((a_jacobian(v0, v1, v2, v3) > 0) != signed_volume)
+						std::swap(ele_.vs[1], ele_.vs[3]);
+
+					const Vector3d center = (v0 + v1 + v2 + v3) / 4;
+					ele_.v_in_Kernel = {center[0], center[1], center[2]};
+				}
 			}
-			return false;
+		});
+
+		using Triangle = std::array<uint32_t, 3>;
+		const auto sorted = [](Triangle tri) {
+			std::sort(tri.begin(), tri.end());
+			return tri;
 		};
 
-		std::vector<bool> e_flag(M.edges.size(), false);
+		// the 4 faces on every input face, their vertices are set by the first child that has them
+		M_.faces.resize(4 * n_f + 8 * n_h);
+		std::vector<Triangle> sub_faces(4 * n_f);
+		utils::maybe_parallel_for(n_f, [&](int start, int end, int thread_id) {
+			for (int f = start; f < end; ++f)
+			{
+				const Face &face = M.faces[f];
+				assert(face.vs.size() == 3);
 
-		for (const auto &ele : M.elements)
-		{ // 1 --> 8
+				std::array<uint32_t, 3> mid;
+				for (int k = 0; k < 3; k++)
+					mid[k] = n_v + find_face_edge(M, face, face.vs[k], face.vs[(k + 1) % 3]);
 
-			for (short i = 0; i < 4; i++)
-			{ // four corners
-				Element ele_;
-				ele_.id = M_.elements.size();
-				ele_.fs.resize(4, -1);
-				ele_.fs_flag.resize(4, 1);
+				for (int k = 0; k < 3; k++)
+					sub_faces[4 * f + k] = sorted({face.vs[k], mid[k], mid[(k + 2) % 3]});
+				sub_faces[4 * f + 3] = sorted(mid);
 
-				ele_.hex = false;
-				ele_.v_in_Kernel.resize(3);
-
-				ele_.vs.push_back(ele.vs[i]);
-				for (short j = 0; j < 4; j++)
+				for (int k = 0; k < 4; k++)
 				{
-					if (j == i)
-						continue;
-					int v0 = ele.vs[i], v1 = ele.vs[j];
-					int e = -1;
-					if (shared_edge(v0, v1, e))
-						ele_.vs.push_back(E2V[e]);
+					M_.faces[4 * f + k].id = 4 * f + k;
+					M_.faces[4 * f + k].boundary = face.boundary;
 				}
-				Vector3d center;
-				center.setZero();
-				for (const auto &evid : ele_.vs)
-					for (int j = 0; j < 3; j++)
-						center[j] += M_.vertices[evid].v[j];
-				center /= ele_.vs.size();
-				for (int j = 0; j < 3; j++)
-					ele_.v_in_Kernel[j] = center[j];
-
-				M_.elements.push_back(ele_);
 			}
+		});
 
-			// 6 edges
-			std::vector<int> edges(6);
-			for (int i = 0; i < 6; i++)
+		// faces of the children, as for the input faces the ones inside an element are created by its first child that has them
+		utils::maybe_parallel_for(n_h, [&](int start, int end, int thread_id) {
+			for (int h = start; h < end; ++h)
 			{
-				int v0 = ele.vs[tet_edges[i][0]], v1 = ele.vs[tet_edges[i][1]];
-				int e = -1;
-				if (shared_edge(v0, v1, e))
-					edges[i] = e;
-			}
-			// the longest edge
-			int lv0 = E2V[edges[0]], lv1 = E2V[edges[5]];
-			e_flag[edges[0]] = true;
-			e_flag[edges[5]] = true;
-			for (short i = 0; i < 4; i++)
-			{ // four faces
-				Element ele_;
-				ele_.id = M_.elements.size();
-				ele_.fs.resize(4, -1);
-				ele_.fs_flag.resize(4, 1);
-
-				ele_.hex = false;
-				ele_.v_in_Kernel.resize(3);
+				const Element &ele = M.elements[h];
 
-				ele_.vs.push_back(lv0);
-				ele_.vs.push_back(lv1);
-				for (short j = 0; j < 3; j++)
+				std::array<uint32_t, 16> sub_ids;
+				std::array<bool, 16> owned;
+				for (int i = 0; i < 4; i++)
 				{
-					int c_e = M.faces[ele.fs[i]].es[j];
-					if (e_flag[c_e])
-						continue;
-					ele_.vs.push_back(E2V[c_e]);
+					const auto &hs = M.faces[ele.fs[i]].neighbor_hs;
+					for (int k = 0; k < 4; k++)
+					{
+						sub_ids[4 * i + k] = 4 * ele.fs[i] + k;
+						owned[4 * i + k] = *std::min_element(hs.begin(), hs.end()) == uint32_t(h);
+					}
 				}
-				Vector3d center;
-				center.setZero();
-				for (const auto &evid : ele_.vs)
-					for (int j = 0; j < 3; j++)
-						center[j] += M_.vertices[evid].v[j];
-				center /= ele_.vs.size();
-				for (int j = 0; j < 3; j++)
-					ele_.v_in_Kernel[j] = center[j];
 
-				M_.elements.push_back(ele_);
-			}
-			e_flag[edges[0]] = e_flag[edges[5]] = false;
-		}
+				std::array<Triangle, 8> interior;
+				int n_interior = 0;
 
-		M_.points.resize(3, M_.vertices.size());
-		for (auto v : M_.vertices)
-			for (int j = 0; j < 3; j++)
-				M_.points(j, v.id) = v.v[j];
+				for (int c = 0; c < 8; c++)
+				{
+					Element &ele_ = M_.elements[8 * h + c];
+					for (int i = 0; i < 4; i++)
+					{
+						const Triangle tri = {ele_.vs[tet_faces[i][0]], ele_.vs[tet_faces[i][1]], ele_.vs[tet_faces[i][2]]};
+						const Triangle key = sorted(tri);
 
-		// orient tets
-		const auto &t = M.elements[0].vs;
-		Vector3d c0 = M.points.col(t[0]);
-		Vector3d c1 = M.points.col(t[1]);
-		Vector3d c2 = M.points.col(t[2]);
-		Vector3d c3 = M.points.col(t[3]);
-		bool signed_volume = a_jacobian(c0, c1, c2, c3) > 0 ? true : false;
+						const auto b_it = std::find_if(sub_ids.begin(), sub_ids.end(), [&](const uint32_t sf) { return sub_faces[sf] == key; });
+						if (b_it != sub_ids.end())
+						{
+							if (owned[b_it - sub_ids.begin()])
+								M_.faces[*b_it].vs.assign(tri.begin(), tri.end());
+							ele_.fs[i] = *b_it;
+							continue;
+						}
 
-		for (auto &ele : M_.elements)
-		{
-			c0 = M_.points.col(ele.vs[0]);
-			c1 = M_.points.col(ele.vs[1]);
-			c2 = M_.points.col(ele.vs[2]);
-			c3 = M_.points.col(ele.vs[3]);
-			bool sign = a_jacobian(c0, c1, c2, c3) > 0 ? true : false;
-			if (sign != signed_volume)
-				std::swap(ele.vs[1], ele.vs[3]);
-		}
+						const int j = std::find(interior.begin(), interior.begin() + n_interior, key) - interior.begin();
+						const uint32_t fid = 4 * n_f + 8 * h + j;
+						if (j == n_interior)
+						{
+							assert(n_interior < 8);
+							interior[n_interior++] = key;
 
-		// Fs
-		std::vector<std::vector<uint32_t>> total_fs;
-		total_fs.reserve(M.elements.size() * 4);
-		std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>> tempF;
-		tempF.reserve(M.elements.size() * 4);
-		std::vector<uint32_t> vs(3);
-		for (const auto &ele : M_.elements)
-		{
-			for (int i = 0; i < 4; i++)
-			{
-				vs[0] = ele.vs[tet_faces[i][0]];
-				vs[1] = ele.vs[tet_faces[i][1]];
-				vs[2] = ele.vs[tet_faces[i][2]];
-				total_fs.push_back(vs);
-				std::sort(vs.begin(), vs.end());
-				tempF.push_back(std::make_tuple(vs[0], vs[1], vs[2], ele.id * 4 + i, ele.id, i));
-			}
-		}
-		std::sort(tempF.begin(), tempF.end());
-		M_.faces.reserve(tempF.size() / 3);
-		Face f;
-		f.boundary = true;
-		uint32_t F_num = 0;
-		for (uint32_t i = 0; i < tempF.size(); ++i)
-		{
-			if (i == 0 || (i != 0 && (std::get<0>(tempF[i]) != std::get<0>(tempF[i - 1]) || std::get<1>(tempF[i]) != std::get<1>(tempF[i - 1]) || std::get<2>(tempF[i]) != std::get<2>(tempF[i - 1]))))
-			{
-				f.id = F_num;
-				F_num++;
-				f.vs = total_fs[std::get<3>(tempF[i])];
-				M_.faces.push_back(f);
+							Face &f_ = M_.faces[fid];
+							f_.id = fid;
+							f_.boundary = false;
+							f_.vs.assign(tri.begin(), tri.end());
+						}
+						ele_.fs[i] = fid;
+					}
+				}
+				assert(n_interior == 8);
 			}
-			else if (i != 0 && (std::get<0>(tempF[i]) == std::get<0>(tempF[i - 1]) && std::get<1>(tempF[i]) == std::get<1>(tempF[i - 1]) && std::get<2>(tempF[i]) == std::get<2>(tempF[i - 1])))
-				M_.faces[F_num - 1].boundary = false;
-
-			M_.elements[std::get<4>(tempF[i])].fs[std::get<5>(tempF[i])] = F_num - 1;
-		}
+		});
 
 		build_connectivity(M_);
 		orient_volume_mesh(M_);
 		build_connectivity(M_);
 
-		M = M_;
-
-		double hmin = 10000, hmax = 0, havg = 0;
-		for (const auto &e : M.edges)
-		{
-			Eigen::Vector3d v0 = M.points.col(e.vs[0]), v1 = M.points.col(e.vs[1]);
-			double len = (v0 - v1).norm();
-			if (len < hmin)
-				hmin = len;
-			if (len > hmax)
-				hmax = len;
-			havg += len;
-		}
-		havg /= M.edges.size();
-		// std::cout<<"hmin, hmax, havg: "<<hmin<<" "<<hmax<<" "<<havg<<std::endl;
+		M = std::move(M_);
 	}
 }
 void MeshProcessing3D::straight_sweeping(const Mesh3DStorage &Mi, int sweep_coord, double height, int nlayer, Mesh3DStorage &Mo)
@@ -1735,6 +1813,11 @@ void MeshProcessing3D::ele_subdivison_levels(const Mesh3DStorage &hmi, std::vect
 // template<typename T>
 // void MeshProcessing3D::set_intersection_own(const std::vector<T> &A, const std::vector<T> &B, std::vector<T> &C, const int &num){
 void MeshProcessing3D::set_intersection_own(const std::vector<uint32_t> &A, const std::vector<uint32_t> &B, std::array<uint32_t, 2> &C, int &num)
+{
+	set_intersection_own(CSRAdjacency::Range(A), CSRAdjacency::Range(B), C, num);
+}
+
+void MeshProcessing3D::set_intersection_own(const CSRAdjacency::Range &A, const CSRAdjacency::Range &B, std::array<uint32_t, 2> &C, int &num)
 {
 	// void MeshProcessing3D::set_intersection_own( std::vector<uint32_t> &A,  std::vector<uint32_t> &B, std::vector<uint32_t> &C, int &num)
 	//  C.resize(num);
@@ -46,6 +46,12 @@ namespace polyfem
 				{2, 3}};
 
 			void build_connectivity(Mesh3DStorage &hmi);
+			// Packs the neighbor_* lists computed by build_connectivity into the flat (CSR) adjacency of hmi
+			void build_flat_connectivity(Mesh3DStorage &hmi);
+			// Frees the neighbor_* lists of hmi, the navigation only reads the flat adjacency
+			void release_neighbors(Mesh3DStorage &hmi);
+			// Refills the neighbor_* lists of hmi from its flat adjacency, if they were released
+			void restore_neighbors(Mesh3DStorage &hmi);
 			void reorder_hex_mesh_propogation(Mesh3DStorage &hmi);
 			bool scaled_jacobian(Mesh3DStorage &hmi, Mesh_Quality &mq);
 			double a_jacobian(Eigen::Vector3d &v0, Eigen::Vector3d &v1, Eigen::Vector3d &v2, Eigen::Vector3d &v3);
@@ -62,6 +68,7 @@ namespace polyfem
 
 			// template<typename T>
 			void set_intersection_own(const std::vector<uint32_t> &A, const std::vector<uint32_t> &B, std::array<uint32_t, 2> &C, int &num);
+			void set_intersection_own(const CSRAdjacency::Range &A, const CSRAdjacency::Range &B, std::array<uint32_t, 2> &C, int &num);
 		} // namespace MeshProcessing3D
 	}     // namespace mesh
 } // namespace polyfem
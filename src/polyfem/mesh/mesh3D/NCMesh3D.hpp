@@ -237,7 +237,7 @@ namespace polyfem
 				return false;
 			}
 
-			bool build_from_matrices(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F) override;
+			bool build_from_matrices(const Eigen::Ref<const Eigen::MatrixXd> &V, const Eigen::Ref<const Eigen::MatrixXi> &F) override;
 
 			void attach_higher_order_nodes(const Eigen::MatrixXd &V, const std::vector<std::vector<int>> &nodes) override;
 
@@ -342,6 +342,9 @@ namespace polyfem
 			void refine_element(int id_full);
 			void refine_elements(const std::vector<int> &ids);
 
+			// for every element, the element before the last call of refine_elements it comes from
+			std::vector<int> elements_before_refinement() const;
+
 			void coarsen_element(int id_full);
 
 			void mark_boundary();
@@ -487,6 +490,9 @@ namespace polyfem
 
 			std::vector<int> refineHistory;
 
+			// valid_to_all_elemMap before the last call of refine_elements
+			std::vector<int> prev_valid_to_all_elemMap;
+
 			// elementAdj(i, j) = 1 iff element i touches element j
 			Eigen::SparseMatrix<bool, Eigen::RowMajor> elementAdj;
 		};
@@ -23,6 +23,8 @@ void polyfem::mesh::Navigation3D::prepare_mesh(Mesh3DStorage &M)
 		M.type = MeshType::HYB;
 	MeshProcessing3D::build_connectivity(M);
 	MeshProcessing3D::global_orientation_hexes(M);
+	MeshProcessing3D::build_flat_connectivity(M);
+	MeshProcessing3D::release_neighbors(M);
 }
 
 polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::get_index_from_element_face(const Mesh3DStorage &M, int hi)
@@ -72,7 +74,7 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::get_index_from_e
 		idx.face_corner = find(M.faces[idx.face].vs.begin(), M.faces[idx.face].vs.end(), idx.vertex) - M.faces[idx.face].vs.begin();
 
 		int v0 = idx.vertex, v1 = M.elements[hi].vs[1];
-		const vector<uint32_t> &ves0 = M.vertices[v0].neighbor_es, &ves1 = M.vertices[v1].neighbor_es;
+		const CSRAdjacency::Range ves0 = M.adjacency.v2e[v0], ves1 = M.adjacency.v2e[v1];
 		std::array<uint32_t, 2> sharedes;
 		int num = 1;
 		MeshProcessing3D::set_intersection_own(ves0, ves1, sharedes, num);
@@ -393,10 +395,11 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::switch_face(cons
 	}
 	else
 	{
-		const vector<uint32_t> &efs = M.edges[idx.edge].neighbor_fs, &hfs = M.elements[idx.element].fs;
+		const CSRAdjacency::Range efs = M.adjacency.e2f[idx.edge];
+		const vector<uint32_t> &hfs = M.elements[idx.element].fs;
 		std::array<uint32_t, 2> sharedfs;
 		int num = 2;
-		MeshProcessing3D::set_intersection_own(efs, hfs, sharedfs, num);
+		MeshProcessing3D::set_intersection_own(efs, CSRAdjacency::Range(hfs), sharedfs, num);
 		if (sharedfs[0] == idx.face)
 			idx.face = sharedfs[1];
 		else
@@ -446,17 +449,18 @@ polyfem::mesh::Navigation3D::Index polyfem::mesh::Navigation3D::switch_element(c
 	}
 	else
 	{
-		if (M.faces[idx.face].neighbor_hs.size() == 1)
+		const CSRAdjacency::Range fhs = M.adjacency.f2h[idx.face];
+		if (fhs.size() == 1)
 		{
 			idx.element = -1;
 			return idx;
 		}
 		else
 		{
-			if (M.faces[idx.face].neighbor_hs[0] == idx.element)
-				idx.element = M.faces[idx.face].neighbor_hs[1];
+			if (fhs[0] == idx.element)
+				idx.element = fhs[1];
 			else
-				idx.element = M.faces[idx.face].neighbor_hs[0];
+				idx.element = fhs[0];
 
 			const vector<uint32_t> &fs = M.elements[idx.element].fs;
 			for (int i = 0; i < fs.size(); i++)
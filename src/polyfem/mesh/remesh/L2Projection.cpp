@@ -11,27 +11,79 @@
 
 #include <ipc/ipc.hpp>
 
-#include <polysolve/linear/Solver.hpp>
+#include <algorithm>
 
 namespace polyfem::mesh
 {
-	Eigen::MatrixXd unconstrained_L2_projection(
-		const Eigen::SparseMatrix<double> &M,
-		const Eigen::SparseMatrix<double> &A,
-		const Eigen::Ref<const Eigen::MatrixXd> &y)
+	namespace
 	{
-		// Construct a linear solver for M
-		std::unique_ptr<polysolve::linear::Solver> solver;
+		std::unique_ptr<polysolve::linear::Solver> create_solver()
+		{
 #ifdef POLYSOLVE_WITH_MKL
-		solver = polysolve::linear::Solver::create("Eigen::PardisoLDLT", "");
+			return polysolve::linear::Solver::create("Eigen::PardisoLDLT", "");
 #elif defined(POLYSOLVE_WITH_CHOLMOD)
-		solver = polysolve::linear::Solver::create("Eigen::CholmodSimplicialLDLT", "");
+			return polysolve::linear::Solver::create("Eigen::CholmodSimplicialLDLT", "");
 #else
-		solver = polysolve::linear::Solver::create("Eigen::SimplicialLDLT", "");
+			return polysolve::linear::Solver::create("Eigen::SimplicialLDLT", "");
 #endif
+		}
+
+		std::unique_ptr<polysolve::linear::Solver> factorize(const Eigen::SparseMatrix<double> &M)
+		{
+			std::unique_ptr<polysolve::linear::Solver> solver = create_solver();
+			solver->analyze_pattern(M, 0);
+			solver->factorize(M);
+			return solver;
+		}
+	} // namespace
+
+	polysolve::linear::Solver &FactorizationCache::factorize(const Eigen::SparseMatrix<double> &M)
+	{
+		assert(M.isCompressed());
+		assert(M.nonZeros() <= max_non_zeros_);
+
+		auto it = std::find_if(entries_.begin(), entries_.end(), [&](const Entry &e) { return e.has_pattern(M); });
+		if (it == entries_.end())
+		{
+			// the oldest entries are dropped
+			while (!entries_.empty() && non_zeros_ + M.nonZeros() > max_non_zeros_)
+			{
+				non_zeros_ -= entries_.back().inner.size();
+				entries_.pop_back();
+			}
+
+			Entry e;
+			e.outer = Eigen::Map<const Eigen::VectorXi>(M.outerIndexPtr(), M.outerSize() + 1);
+			e.inner = Eigen::Map<const Eigen::VectorXi>(M.innerIndexPtr(), M.nonZeros());
+			e.solver = create_solver();
+			e.solver->analyze_pattern(M, 0);
+			entries_.push_front(std::move(e));
+			non_zeros_ += M.nonZeros();
+			++n_analyses_;
+		}
+		else if (it != entries_.begin())
+		{
+			entries_.splice(entries_.begin(), entries_, it);
+		}
+
+		entries_.front().solver->factorize(M);
+		return *entries_.front().solver;
+	}
 
-		solver->analyze_pattern(M, 0);
-		solver->factorize(M);
+	bool FactorizationCache::Entry::has_pattern(const Eigen::SparseMatrix<double> &M) const
+	{
+		return outer.size() == M.outerSize() + 1 && inner.size() == M.nonZeros()
+			   && std::equal(outer.begin(), outer.end(), M.outerIndexPtr())
+			   && std::equal(inner.begin(), inner.end(), M.innerIndexPtr());
+	}
+
+	Eigen::MatrixXd unconstrained_L2_projection(
+		const Eigen::SparseMatrix<double> &M,
+		const Eigen::SparseMatrix<double> &A,
+		const Eigen::Ref<const Eigen::MatrixXd> &y)
+	{
+		// the global mass matrix changes with every remeshing, its factorization is not cached
+		const std::unique_ptr<polysolve::linear::Solver> solver = factorize(M);
 
 		const Eigen::MatrixXd rhs = A * y;
 		Eigen::MatrixXd x(rhs.rows(), rhs.cols());
@@ -46,25 +98,59 @@ namespace polyfem::mesh
 	}
 
 	void reduced_L2_projection(
-		const Eigen::MatrixXd &M,
-		const Eigen::MatrixXd &A,
+		const Eigen::SparseMatrix<double> &M,
+		const Eigen::SparseMatrix<double> &A,
 		const Eigen::Ref<const Eigen::MatrixXd> &y,
 		const std::vector<int> &boundary_nodes,
 		Eigen::Ref<Eigen::MatrixXd> x)
 	{
+		assert(std::is_sorted(boundary_nodes.begin(), boundary_nodes.end()));
+
+		// reduced index of every node, -1 for the boundary nodes
 		std::vector<int> free_nodes;
-		for (int i = 0, j = 0; i < y.rows(); ++i)
+		std::vector<int> to_free(x.rows(), -1);
+		for (int i = 0, j = 0; i < x.rows(); ++i)
 		{
-			if (boundary_nodes[j] == i)
+			if (j < boundary_nodes.size() && boundary_nodes[j] == i)
 				++j;
 			else
+			{
+				to_free[i] = free_nodes.size();
 				free_nodes.push_back(i);
+			}
+		}
+		if (free_nodes.empty())
+			return;
+
+		std::vector<Eigen::Triplet<double>> entries;
+		entries.reserve(M.nonZeros());
+		for (int k = 0; k < M.outerSize(); ++k)
+		{
+			for (Eigen::SparseMatrix<double>::InnerIterator it(M, k); it; ++it)
+			{
+				if (to_free[it.row()] >= 0 && to_free[it.col()] >= 0)
+					entries.emplace_back(to_free[it.row()], to_free[it.col()], it.value());
+			}
 		}
+		Eigen::SparseMatrix<double> H(free_nodes.size(), free_nodes.size());
+		H.setFromTriplets(entries.begin(), entries.end());
 
-		const Eigen::MatrixXd H = M(free_nodes, free_nodes);
 		const Eigen::MatrixXd g = -((M * x - A * y)(free_nodes, Eigen::all));
-		const Eigen::MatrixXd sol = H.llt().solve(g);
-		x(free_nodes, Eigen::all) += sol;
+
+		H.makeCompressed();
+
+		// the local patches of the operations often repeat, the remeshing operations can run on several threads
+		thread_local FactorizationCache cache;
+		std::unique_ptr<polysolve::linear::Solver> uncached;
+		polysolve::linear::Solver &solver = H.nonZeros() <= cache.max_non_zeros()
+												? cache.factorize(H)
+												: *(uncached = factorize(H));
+		Eigen::VectorXd sol(g.rows());
+		for (int i = 0; i < g.cols(); ++i)
+		{
+			solver.solve(g.col(i), sol);
+			x(free_nodes, i) += sol;
+		}
 	}
 
 	Eigen::VectorXd constrained_L2_projection(
@@ -4,18 +4,66 @@
 #include <polyfem/solver/NLProblem.hpp>
 #include <polyfem/solver/forms/ContactForm.hpp>
 
+#include <polysolve/linear/Solver.hpp>
 #include <polysolve/nonlinear/Solver.hpp>
 
+#include <list>
+#include <memory>
+
 namespace polyfem::mesh
 {
+	/// @brief Factorizations of the mass matrices of local patches, the symbolic analysis is reused for matrices with the same sparsity pattern
+	class FactorizationCache
+	{
+	public:
+		/// default bound of the total number of non zeros of the cached matrices
+		static constexpr size_t default_max_non_zeros = 1 << 20;
+
+		/// @param max_non_zeros total number of non zeros of the cached matrices, bounds the memory used by the factorizations
+		explicit FactorizationCache(const size_t max_non_zeros = default_max_non_zeros) : max_non_zeros_(max_non_zeros) {}
+
+		/// @brief factorizes M, M must be compressed and have at most max_non_zeros() non zeros
+		/// @return solver valid until the next call
+		polysolve::linear::Solver &factorize(const Eigen::SparseMatrix<double> &M);
+
+		size_t max_non_zeros() const { return max_non_zeros_; }
+		/// number of cached factorizations
+		size_t size() const { return entries_.size(); }
+		/// total number of non zeros of the cached matrices
+		size_t non_zeros() const { return non_zeros_; }
+		/// number of symbolic analyses, i.e., of factorizations not found in the cache
+		size_t n_analyses() const { return n_analyses_; }
+
+	private:
+		struct Entry
+		{
+			Eigen::VectorXi outer;
+			Eigen::VectorXi inner;
+			std::unique_ptr<polysolve::linear::Solver> solver;
+
+			bool has_pattern(const Eigen::SparseMatrix<double> &M) const;
+		};
+
+		const size_t max_non_zeros_;
+		/// most recently used first
+		std::list<Entry> entries_;
+		size_t non_zeros_ = 0;
+		size_t n_analyses_ = 0;
+	};
+
+	/// @brief Solves M x = A y.
 	Eigen::MatrixXd unconstrained_L2_projection(
 		const Eigen::SparseMatrix<double> &M,
 		const Eigen::SparseMatrix<double> &A,
 		const Eigen::Ref<const Eigen::MatrixXd> &y);
 
+	/// @brief Minimizes the L2 distance between x and y with the boundary nodes of x fixed.
+	/// The factorizations of the local patches are cached per thread, a patch with the sparsity pattern
+	/// of a previous one (e.g., the same topology) is only refactorized.
+	/// @param[in] boundary_nodes sorted fixed nodes
 	void reduced_L2_projection(
-		const Eigen::MatrixXd &M,
-		const Eigen::MatrixXd &A,
+		const Eigen::SparseMatrix<double> &M,
+		const Eigen::SparseMatrix<double> &A,
 		const Eigen::Ref<const Eigen::MatrixXd> &y,
 		const std::vector<int> &boundary_nodes,
 		Eigen::Ref<Eigen::MatrixXd> x);
@@ -12,7 +12,9 @@ namespace polyfem::time_integrator
 	class ImplicitTimeIntegrator;
 } // namespace polyfem::time_integrator
 
-#define POLYFEM_REMESHER_SCOPED_TIMER(name) polyfem::utils::Timer __polyfem_timer(Remesher::timings[name])
+#define POLYFEM_REMESHER_SCOPED_TIMER(name) \
+	POLYFEM_PROFILE_SCOPE(name);           \
+	polyfem::utils::Timer __polyfem_timer(Remesher::timings[name])
 
 namespace polyfem::mesh
 {
@@ -6,6 +6,8 @@
 
 #include <wmtk/utils/TupleUtils.hpp>
 
+#include <igl/predicates/predicates.h>
+
 #include <unordered_map>
 
 #define VERTEX_ATTRIBUTE_GETTER(name, attribute)                                                     \
@@ -40,6 +42,8 @@ namespace polyfem::mesh
 		: Remesher(state, obstacle_displacements, obstacle_vals, current_time, starting_energy),
 		  WMTKMesh()
 	{
+		// the inversion checks run for every candidate element of every operation, initialize the predicates once
+		igl::predicates::exactinit();
 	}
 
 	template <typename WMTKMesh>
@@ -107,8 +107,6 @@ namespace polyfem::mesh
 		// Get the vertices ids
 		const std::array<size_t, 4> vids = oriented_tet_vids(loc);
 
-		igl::predicates::exactinit();
-
 		// Use igl for checking orientation
 		const igl::predicates::Orientation orientation = igl::predicates::orient3d(
 			vertex_attrs[vids[0]].rest_position, vertex_attrs[vids[1]].rest_position,
@@ -124,8 +122,6 @@ namespace polyfem::mesh
 		// Get the vertices ids
 		const std::array<size_t, 4> vids = oriented_tet_vids(loc);
 
-		igl::predicates::exactinit();
-
 		for (int i = 0; i < n_quantities() / 3 + 2; ++i)
 		{
 			// Use igl for checking orientation
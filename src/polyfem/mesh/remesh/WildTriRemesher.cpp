@@ -50,8 +50,6 @@ namespace polyfem::mesh
 		// Get the vertices ids
 		const std::array<size_t, 3> vids = oriented_tri_vids(loc);
 
-		igl::predicates::exactinit();
-
 		// Use igl for checking orientation
 		const igl::predicates::Orientation orientation =
 			igl::predicates::orient2d(
@@ -69,8 +67,6 @@ namespace polyfem::mesh
 		// Get the vertices ids
 		const std::array<size_t, 3> vids = oriented_tri_vids(loc);
 
-		igl::predicates::exactinit();
-
 		for (int i = 0; i < n_quantities() / 3 + 2; ++i)
 		{
 			// Use igl for checking orientation
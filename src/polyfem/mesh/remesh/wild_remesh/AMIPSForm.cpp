@@ -15,7 +15,8 @@ namespace polyfem
 
 		bool AMIPSForm::is_step_valid(const Eigen::VectorXd &, const Eigen::VectorXd &x1) const
 		{
-			igl::predicates::exactinit();
+			// the predicates are initialized once, not on every step
+			[[maybe_unused]] static const bool predicates_initialized = (igl::predicates::exactinit(), true);
 
 			// Use igl for checking orientation
 			igl::predicates::Orientation res = igl::predicates::orient2d(
@@ -89,7 +90,7 @@ namespace polyfem
 		void AMIPSForm::second_derivative_unweighted(
 			const Eigen::VectorXd &x, StiffnessMatrix &hessian) const
 		{
-			Eigen::MatrixXd H(x.size(), x.size());
+			Eigen::Matrix2d H;
 			if (x.size() == 2)
 			{
 				// NOTE: it doesnt matter if H is column major or row major because the hessian is symmetric
@@ -0,0 +1,332 @@
+#include "APosteriori.hpp"
+
+#include <polyfem/State.hpp>
+#include <polyfem/assembler/ElementAssemblyValues.hpp>
+#include <polyfem/io/Evaluator.hpp>
+#include <polyfem/mesh/mesh2D/NCMesh2D.hpp>
+#include <polyfem/mesh/mesh3D/NCMesh3D.hpp>
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
+
+#include <igl/Timer.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace polyfem::refinement
+{
+	using namespace mesh;
+	using namespace basis;
+
+	namespace
+	{
+		void refine_elements(Mesh &mesh, const std::vector<int> &ids)
+		{
+			if (NCMesh2D *ncmesh = dynamic_cast<NCMesh2D *>(&mesh))
+				ncmesh->refine_elements(ids);
+			else if (NCMesh3D *ncmesh = dynamic_cast<NCMesh3D *>(&mesh))
+				ncmesh->refine_elements(ids);
+			else
+				log_and_throw_error("Adaptive refinement requires a non-conforming mesh!");
+		}
+
+		std::vector<int> elements_before_refinement(const Mesh &mesh)
+		{
+			if (const NCMesh2D *ncmesh = dynamic_cast<const NCMesh2D *>(&mesh))
+				return ncmesh->elements_before_refinement();
+			return dynamic_cast<const NCMesh3D &>(mesh).elements_before_refinement();
+		}
+
+		/// same condition as the nonlinear tensor solve of State::solve_problem, the only solve using an initial guess
+		bool uses_initial_guess(const State &state)
+		{
+			return state.assembler->name() != "NavierStokes"
+				   && !state.problem->is_scalar()
+				   && (!state.assembler->is_linear() || state.is_contact_enabled());
+		}
+
+		/// solve on the current level, starting the nonlinear solver from initial_guess if it matches the problem size
+		void solve_level(State &state, const Eigen::MatrixXd &initial_guess, Eigen::MatrixXd &sol, Eigen::MatrixXd &pressure)
+		{
+			if (!uses_initial_guess(state) || initial_guess.size() == 0)
+			{
+				state.solve_problem(sol, pressure);
+				return;
+			}
+
+			igl::Timer timer;
+			timer.start();
+			logger().info("Solving {}", state.assembler->name());
+
+			state.init_solve(sol, pressure);
+			if (initial_guess.rows() == sol.rows())
+				sol = initial_guess;
+			state.init_nonlinear_tensor_solve(sol);
+			state.solve_tensor_nonlinear(sol);
+
+			timer.stop();
+			state.timings.solving_time = timer.getElapsedTime();
+			logger().info(" took {}s", state.timings.solving_time);
+		}
+	} // namespace
+
+	void APosteriori::solve(State &state, Eigen::MatrixXd &sol, Eigen::MatrixXd &pressure)
+	{
+		const json &params = state.args["space"]["adaptive_refinement"];
+		const int max_iterations = params["max_iterations"];
+		const double theta = params["theta"];
+		const double tolerance = params["tolerance"];
+		const int max_dofs = params["max_dofs"];
+
+		if (state.problem->is_time_dependent())
+			log_and_throw_error("Adaptive refinement only supports static problems!");
+		if (state.mesh->is_conforming())
+			log_and_throw_error("Adaptive refinement requires a non-conforming mesh!");
+
+		for (int e = 0; e < state.mesh->n_elements(); ++e)
+			if (!state.mesh->is_simplex(e))
+				log_and_throw_error("Adaptive refinement only supports simplicial meshes!");
+
+		const int actual_dim = state.problem->is_scalar() ? 1 : state.mesh->dimension();
+
+		std::vector<ElementBases> old_bases, old_gbases;
+		Eigen::MatrixXd old_sol, initial_guess;
+
+		for (int it = 0;; ++it)
+		{
+			state.build_basis();
+
+			if (it > 0 && uses_initial_guess(state))
+				transfer_solution(
+					*state.mesh, actual_dim, old_bases, old_gbases, old_sol,
+					elements_before_refinement(*state.mesh), state.bases, state.n_bases, initial_guess);
+
+			state.assemble_rhs();
+			state.assemble_mass_mat();
+
+			solve_level(state, initial_guess, sol, pressure);
+
+			Eigen::VectorXd errors;
+			const double norm = zz_estimate(*state.mesh, actual_dim, state.bases, state.geom_bases(), sol, errors);
+			const double error = std::sqrt(errors.sum());
+			const double rel_error = norm > 0 ? error / std::sqrt(norm) : error;
+
+			logger().info(
+				"Adaptive refinement iteration {}: {} elements, {} dofs, estimated error {} (relative {})",
+				it, state.bases.size(), state.ndof(), error, rel_error);
+
+			if (rel_error <= tolerance)
+				break;
+			if (it + 1 >= max_iterations)
+			{
+				logger().warn("Adaptive refinement reached the maximum number of iterations ({})", max_iterations);
+				break;
+			}
+			if (max_dofs > 0 && state.ndof() >= max_dofs)
+			{
+				logger().warn("Adaptive refinement reached the maximum number of dofs ({})", max_dofs);
+				break;
+			}
+
+			const std::vector<int> marked = dorfler_mark(errors, theta);
+			logger().debug("Refining {} elements", marked.size());
+
+			// the bases are rebuilt on the refined mesh, keep the current ones for the transfer
+			if (uses_initial_guess(state))
+			{
+				old_bases = state.bases;
+				old_gbases = state.geom_bases();
+				old_sol = sol.topRows(state.n_bases * actual_dim);
+			}
+
+			refine_elements(*state.mesh, marked);
+		}
+	}
+
+	double APosteriori::zz_estimate(
+		const Mesh &mesh,
+		const int actual_dim,
+		const std::vector<ElementBases> &bases,
+		const std::vector<ElementBases> &gbases,
+		const Eigen::MatrixXd &sol,
+		Eigen::VectorXd &errors)
+	{
+		const int dim = mesh.dimension();
+		const int n_el = int(bases.size());
+		const int n_cols = dim * actual_dim;
+
+		// gradient of the solution at the quadrature points, and its linear fit at the element vertices
+		std::vector<Eigen::MatrixXd> points(n_el), grads(n_el), vertex_grads(n_el);
+		std::vector<Eigen::VectorXd> weights(n_el);
+		Eigen::VectorXd measures(n_el);
+
+		utils::maybe_parallel_for(n_el, [&](int start, int end, int thread_id) {
+			assembler::ElementAssemblyValues vals;
+			for (int e = start; e < end; ++e)
+			{
+				assert(mesh.is_simplex(e));
+				vals.compute(e, mesh.is_volume(), bases[e], gbases[e]);
+
+				Eigen::MatrixXd &grad = grads[e];
+				grad.setZero(vals.val.rows(), n_cols);
+				for (const auto &val : vals.basis_values)
+					for (const auto &g : val.global)
+						for (int d = 0; d < actual_dim; ++d)
+							grad.middleCols(d * dim, dim) += g.val * sol(g.index * actual_dim + d) * val.grad_t_m;
+
+				points[e] = vals.val;
+				weights[e] = vals.det.array() * vals.quadrature.weights.array();
+				measures[e] = weights[e].sum();
+
+				// weighted least squares fit of a linear function, a constant if there are too few points
+				const RowVectorNd center = (weights[e].transpose() * points[e]) / measures[e];
+				Eigen::MatrixXd A(points[e].rows(), dim + 1);
+				A.col(0).setOnes();
+				A.rightCols(dim) = points[e].rowwise() - center;
+				const Eigen::VectorXd sqrt_w = weights[e].array().sqrt();
+
+				const auto qr = (sqrt_w.asDiagonal() * A).colPivHouseholderQr();
+				Eigen::MatrixXd coeffs = Eigen::MatrixXd::Zero(dim + 1, n_cols);
+				if (qr.rank() == dim + 1)
+					coeffs = qr.solve(sqrt_w.asDiagonal() * grad);
+				else
+					coeffs.row(0) = (weights[e].transpose() * grad) / measures[e];
+
+				vertex_grads[e].resize(dim + 1, n_cols);
+				for (int lv = 0; lv <= dim; ++lv)
+				{
+					const RowVectorNd p = mesh.point(mesh.element_vertex(e, lv)) - center;
+					vertex_grads[e].row(lv) = coeffs.row(0) + p * coeffs.bottomRows(dim);
+				}
+			}
+		});
+
+		// recovered gradient, measure-weighted average at the vertices
+		Eigen::MatrixXd recovered = Eigen::MatrixXd::Zero(mesh.n_vertices(), n_cols);
+		Eigen::VectorXd vertex_weights = Eigen::VectorXd::Zero(mesh.n_vertices());
+		for (int e = 0; e < n_el; ++e)
+		{
+			for (int lv = 0; lv <= dim; ++lv)
+			{
+				const int v = mesh.element_vertex(e, lv);
+				recovered.row(v) += measures[e] * vertex_grads[e].row(lv);
+				vertex_weights[v] += measures[e];
+			}
+		}
+		for (int v = 0; v < recovered.rows(); ++v)
+			if (vertex_weights[v] > 0)
+				recovered.row(v) /= vertex_weights[v];
+
+		errors.resize(n_el);
+		Eigen::VectorXd norms(n_el);
+
+		utils::maybe_parallel_for(n_el, [&](int start, int end, int thread_id) {
+			for (int e = start; e < end; ++e)
+			{
+				// linear interpolation of the recovered gradient with the barycentric coordinates of the quadrature points
+				Eigen::MatrixXd V(dim + 1, dim), G(dim + 1, n_cols);
+				for (int lv = 0; lv <= dim; ++lv)
+				{
+					const int v = mesh.element_vertex(e, lv);
+					V.row(lv) = mesh.point(v);
+					G.row(lv) = recovered.row(v);
+				}
+
+				const Eigen::MatrixXd J = (V.bottomRows(dim).rowwise() - V.row(0)).transpose();
+				Eigen::MatrixXd lambda(points[e].rows(), dim + 1);
+				lambda.rightCols(dim) = J.partialPivLu().solve((points[e].rowwise() - V.row(0)).transpose()).transpose();
+				lambda.col(0) = 1 - lambda.rightCols(dim).rowwise().sum().array();
+
+				const Eigen::VectorXd diff = (lambda * G - grads[e]).rowwise().squaredNorm();
+				errors[e] = weights[e].dot(diff);
+				norms[e] = weights[e].dot(grads[e].rowwise().squaredNorm());
+			}
+		});
+
+		return norms.sum();
+	}
+
+	std::vector<int> APosteriori::dorfler_mark(const Eigen::VectorXd &errors, const double theta)
+	{
+		std::vector<int> order(errors.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](const int a, const int b) { return errors[a] > errors[b]; });
+
+		const double target = theta * errors.sum();
+
+		std::vector<int> marked;
+		double sum = 0;
+		for (const int e : order)
+		{
+			if (sum >= target && !marked.empty())
+				break;
+			marked.push_back(e);
+			sum += errors[e];
+		}
+
+		return marked;
+	}
+
+	void APosteriori::transfer_solution(
+		const Mesh &mesh,
+		const int actual_dim,
+		const std::vector<ElementBases> &old_bases,
+		const std::vector<ElementBases> &old_gbases,
+		const Eigen::MatrixXd &old_sol,
+		const std::vector<int> &ancestors,
+		const std::vector<ElementBases> &bases,
+		const int n_bases,
+		Eigen::MatrixXd &sol)
+	{
+		assert(ancestors.size() == bases.size());
+
+		const int dim = mesh.dimension();
+
+		// vertices of the reference simplex
+		Eigen::MatrixXd ref_vertices = Eigen::MatrixXd::Zero(dim + 1, dim);
+		ref_vertices.bottomRows(dim).setIdentity();
+
+		sol.setZero(n_bases * actual_dim, 1);
+		std::vector<bool> is_set(n_bases, false);
+
+		Eigen::MatrixXd mapped, local_pts, vals, grads;
+		std::vector<int> nodes;
+		for (int e = 0; e < bases.size(); ++e)
+		{
+			const int parent = ancestors[e];
+			assert(parent >= 0 && parent < old_bases.size());
+
+			nodes.clear();
+			std::vector<RowVectorNd> positions;
+			for (const Basis &b : bases[e].bases)
+			{
+				for (const Local2Global &g : b.global())
+				{
+					if (is_set[g.index])
+						continue;
+					is_set[g.index] = true;
+					nodes.push_back(g.index);
+					positions.push_back(g.node);
+				}
+			}
+			if (nodes.empty())
+				continue;
+
+			// the nodes lie in the parent element, invert its (affine) geometric map
+			old_gbases[parent].eval_geom_mapping(ref_vertices, mapped);
+			const Eigen::MatrixXd J = (mapped.bottomRows(dim).rowwise() - mapped.row(0)).transpose();
+			const auto J_lu = J.partialPivLu();
+
+			local_pts.resize(nodes.size(), dim);
+			for (int i = 0; i < nodes.size(); ++i)
+				local_pts.row(i) = J_lu.solve((positions[i] - mapped.row(0)).transpose()).transpose();
+
+			io::Evaluator::interpolate_at_local_vals(
+				mesh, actual_dim, old_bases, old_gbases, parent, local_pts, old_sol, vals, grads);
+
+			for (int i = 0; i < nodes.size(); ++i)
+				for (int d = 0; d < actual_dim; ++d)
+					sol(nodes[i] * actual_dim + d) = vals(i, d);
+		}
+	}
+} // namespace polyfem::refinement
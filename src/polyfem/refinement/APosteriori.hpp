@@ -0,0 +1,78 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+
+#include <polyfem/basis/ElementBases.hpp>
+#include <polyfem/mesh/Mesh.hpp>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace polyfem
+{
+	class State;
+}
+
+namespace polyfem::refinement
+{
+	/// Class for a posteriori h-refinement on non-conforming simplicial meshes: solve, estimate, mark, and refine
+	class APosteriori
+	{
+	private:
+		APosteriori() {}
+
+	public:
+		/// solve the problem of state, refining the mesh where the estimated error is large.
+		/// The mesh must be loaded as non-conforming, the bases are built and the system is assembled here.
+		/// The solution of every level is transferred to the next one as initial guess of the nonlinear solver.
+		/// @param[in] state state, uses the parameters in args["space"]["adaptive_refinement"]
+		/// @param[out] sol solution on the finest mesh
+		/// @param[out] pressure pressure on the finest mesh
+		static void solve(State &state, Eigen::MatrixXd &sol, Eigen::MatrixXd &pressure);
+
+		/// compute the Zienkiewicz-Zhu error estimator, the difference between the gradient of the solution
+		/// and a continuous gradient recovered by averaging at the mesh vertices a local linear fit of the gradient
+		/// @param[in] mesh simplicial mesh
+		/// @param[in] actual_dim is the size of the problem (e.g., 1 for Laplace, dim for elasticity)
+		/// @param[in] bases bases
+		/// @param[in] gbases geom bases
+		/// @param[in] sol solution
+		/// @param[out] errors squared error estimate per element
+		/// @return squared H1 semi-norm of the solution, to make the estimate relative
+		static double zz_estimate(
+			const mesh::Mesh &mesh,
+			const int actual_dim,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const Eigen::MatrixXd &sol,
+			Eigen::VectorXd &errors);
+
+		/// Dorfler (bulk) marking: the smallest set of elements with the largest errors whose errors sum to theta times the total
+		/// @param[in] errors squared error estimate per element
+		/// @param[in] theta fraction of the total error in (0, 1]
+		/// @return marked elements
+		static std::vector<int> dorfler_mark(const Eigen::VectorXd &errors, const double theta);
+
+		/// interpolate a solution on the refined mesh, every node is evaluated in the element it comes from
+		/// @param[in] mesh refined mesh
+		/// @param[in] actual_dim is the size of the problem (e.g., 1 for Laplace, dim for elasticity)
+		/// @param[in] old_bases bases before refinement
+		/// @param[in] old_gbases geom bases before refinement
+		/// @param[in] old_sol solution before refinement
+		/// @param[in] ancestors for every element, the element before refinement it comes from
+		/// @param[in] bases bases after refinement
+		/// @param[in] n_bases number of bases after refinement
+		/// @param[out] sol interpolated solution
+		static void transfer_solution(
+			const mesh::Mesh &mesh,
+			const int actual_dim,
+			const std::vector<basis::ElementBases> &old_bases,
+			const std::vector<basis::ElementBases> &old_gbases,
+			const Eigen::MatrixXd &old_sol,
+			const std::vector<int> &ancestors,
+			const std::vector<basis::ElementBases> &bases,
+			const int n_bases,
+			Eigen::MatrixXd &sol);
+	};
+} // namespace polyfem::refinement
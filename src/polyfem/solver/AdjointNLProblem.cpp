@@ -2,8 +2,9 @@
 
 #include <polyfem/solver/forms/adjoint_forms/AdjointForm.hpp>
 #include <polyfem/utils/Logger.hpp>
-#include <polyfem/utils/MaybeParallelFor.hpp>
+#include <polyfem/utils/TaskGraph.hpp>
 #include <polyfem/utils/Timer.hpp>
+#include <polyfem/utils/par_for.hpp>
 #include <polyfem/io/OBJWriter.hpp>
 #include <polyfem/State.hpp>
 #include <igl/boundary_facets.h>
@@ -101,18 +102,23 @@ namespace polyfem::solver
 		  variables_to_simulation_(variables_to_simulation),
 		  all_states_(all_states),
 		  save_freq(args["output"]["save_frequency"]),
-		  solve_in_parallel(args["solver"]["advanced"]["solve_in_parallel"])
+		  solve_in_parallel(args["solver"]["advanced"]["solve_in_parallel"]),
+		  threads_per_state(args["solver"]["advanced"]["threads_per_state"])
 	{
 		cur_grad.setZero(0);
 
 		solve_in_order.clear();
+		state_dependencies.assign(all_states.size(), {});
 		{
 			Graph G(all_states.size());
 			for (int k = 0; k < all_states.size(); k++)
 			{
 				auto &arg = args["states"][k];
 				if (arg["initial_guess"].get<int>() >= 0)
+				{
 					G.addEdge(arg["initial_guess"].get<int>(), k);
+					state_dependencies[k].push_back(arg["initial_guess"].get<int>());
+				}
 			}
 
 			solve_in_order = G.topologicalSort();
@@ -160,8 +166,22 @@ namespace polyfem::solver
 
 			{
 				POLYFEM_SCOPED_TIMER("adjoint solve");
-				for (int i = 0; i < all_states_.size(); i++)
-					all_states_[i]->solve_adjoint_cached(form_->compute_adjoint_rhs(x, *all_states_[i])); // caches inside state
+				if (solve_in_parallel)
+				{
+					// the right-hand sides evaluate the shared form, only the adjoint solves run concurrently
+					std::vector<Eigen::MatrixXd> rhs(all_states_.size());
+					for (int i = 0; i < all_states_.size(); i++)
+						rhs[i] = form_->compute_adjoint_rhs(x, *all_states_[i]);
+
+					utils::run_task_graph(
+						std::vector<std::vector<int>>(all_states_.size()), n_threads_per_state(),
+						[&](int i) { all_states_[i]->solve_adjoint_cached(rhs[i]); }); // caches inside state
+				}
+				else
+				{
+					for (int i = 0; i < all_states_.size(); i++)
+						all_states_[i]->solve_adjoint_cached(form_->compute_adjoint_rhs(x, *all_states_[i])); // caches inside state
+				}
 			}
 
 			{
@@ -308,17 +328,15 @@ namespace polyfem::solver
 		{
 			adjoint_logger().info("Run simulations in parallel...");
 
-			utils::maybe_parallel_for(all_states_.size(), [&](int start, int end, int thread_id) {
-				for (int i = start; i < end; i++)
+			// a state starts as soon as the states it takes the initial guess from are solved
+			utils::run_task_graph(state_dependencies, n_threads_per_state(), [&](int i) {
+				auto state = all_states_[i];
+				if (active_state_mask[i] || state->diff_cached.size() == 0)
 				{
-					auto state = all_states_[i];
-					if (active_state_mask[i] || state->diff_cached.size() == 0)
-					{
-						state->assemble_rhs();
-						state->assemble_mass_mat();
-						Eigen::MatrixXd sol, pressure; // solution is also cached in state
-						state->solve_problem(sol, pressure);
-					}
+					state->assemble_rhs();
+					state->assemble_mass_mat();
+					Eigen::MatrixXd sol, pressure; // solution is also cached in state
+					state->solve_problem(sol, pressure);
 				}
 			});
 		}
@@ -341,6 +359,13 @@ namespace polyfem::solver
 		cur_grad.resize(0);
 	}
 
+	int AdjointNLProblem::n_threads_per_state() const
+	{
+		if (threads_per_state > 0)
+			return threads_per_state;
+		return std::max<int>(1, utils::get_n_threads() / std::max<int>(1, all_states_.size()));
+	}
+
 	bool AdjointNLProblem::stop(const TVector &x)
 	{
 		if (stopping_conditions_.size() == 0)
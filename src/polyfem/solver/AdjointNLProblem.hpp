@@ -55,6 +55,12 @@ namespace polyfem::solver
 
 		const bool solve_in_parallel;
 		std::vector<int> solve_in_order;
+		/// for every state, the states that must be solved before it
+		std::vector<std::vector<int>> state_dependencies;
+
+		/// threads used by every state when solving in parallel, 0 to split the threads evenly among the states
+		const int threads_per_state;
+		int n_threads_per_state() const;
 
 		int save_iter = 0;
 
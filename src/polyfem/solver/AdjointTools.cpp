@@ -152,8 +152,98 @@ namespace polyfem::solver
 			normal = normal / normal.norm();
 			return normal;
 		}
+
+		class LocalThreadShapeStorage
+		{
+		public:
+			Eigen::MatrixXd vec;
+			assembler::ElementAssemblyValues vals, mass_vals, gvals;
+			Eigen::MatrixXd density;
+
+			LocalThreadShapeStorage(const int size)
+			{
+				vec.resize(size, 1);
+				vec.setZero();
+			}
+		};
+
+		/// adds weight times the shape derivative of the elastic, damping, inertia, and body forms of one time step to the
+		/// thread storage, in a single pass over the elements, the geometric mapping is evaluated once per element and quadrature
+		template <typename ThreadStorage>
+		void add_volume_forms_shape_derivative(
+			const State &state,
+			const double t,
+			const Eigen::MatrixXd &u,
+			const Eigen::MatrixXd &u_prev,
+			const Eigen::MatrixXd &velocity,
+			const Eigen::MatrixXd &adjoint_nu,
+			const Eigen::MatrixXd &adjoint_p,
+			const double weight,
+			ThreadStorage &storage)
+		{
+			const auto &bases = state.bases;
+			const auto &gbases = state.geom_bases();
+			const bool is_volume = state.mesh->is_volume();
+			const int dim = state.mesh->dimension();
+			const int n_elements = int(bases.size());
+			const SolveData &solve_data = state.solve_data;
+
+			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+				LocalThreadShapeStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+				assembler::ElementAssemblyValues &vals = local_storage.vals;
+				assembler::ElementAssemblyValues &mass_vals = local_storage.mass_vals;
+				assembler::ElementAssemblyValues &gvals = local_storage.gvals;
+				Eigen::MatrixXd &density = local_storage.density;
+
+				for (int e = start; e < end; ++e)
+				{
+					// elastic and damping forms use the stiffness quadrature
+					state.ass_vals_cache.compute(e, is_volume, bases[e], gbases[e], vals);
+					gvals.compute(e, is_volume, vals.quadrature.points, gbases[e], gbases[e]);
+
+					density.setZero(vals.quadrature.weights.size(), dim * dim);
+					solve_data.elastic_form->force_shape_derivative_density(t, e, vals, u, u, adjoint_p, density);
+					if (solve_data.damping_form)
+						solve_data.damping_form->force_shape_derivative_density(t, e, vals, u, u_prev, adjoint_p, density);
+
+					// inertia and body forms use the mass quadrature, usually the same one
+					state.mass_ass_vals_cache.compute(e, is_volume, bases[e], gbases[e], mass_vals);
+					if (mass_vals.quadrature.points.rows() != vals.quadrature.points.rows() || mass_vals.quadrature.points != vals.quadrature.points)
+					{
+						density *= weight;
+						AdjointTools::add_shape_derivative_density(gvals, density, local_storage.vec);
+						gvals.compute(e, is_volume, mass_vals.quadrature.points, gbases[e], gbases[e]);
+						density.setZero(mass_vals.quadrature.weights.size(), dim * dim);
+					}
+
+					InertiaForm::force_shape_derivative_density(is_volume, t, e, mass_vals, *(state.mass_matrix_assembler), velocity, adjoint_nu, density);
+					if (solve_data.body_form)
+						solve_data.body_form->force_shape_derivative_density(t, e, mass_vals, adjoint_p, density);
+
+					density *= weight;
+					AdjointTools::add_shape_derivative_density(gvals, density, local_storage.vec);
+				}
+			});
+		}
 	} // namespace
 
+	void AdjointTools::add_shape_derivative_density(
+		const assembler::ElementAssemblyValues &gvals,
+		const Eigen::MatrixXd &density,
+		Eigen::MatrixXd &term)
+	{
+		for (const auto &v : gvals.basis_values)
+		{
+			const int dim = v.grad_t_m.cols();
+			assert(v.global.size() == 1);
+			assert(density.cols() == dim * dim && density.rows() == v.grad_t_m.rows());
+
+			for (int q = 0; q < density.rows(); ++q)
+				for (int d = 0; d < dim; ++d)
+					term(v.global[0].index * dim + d) += density.row(q).segment(d * dim, dim).dot(v.grad_t_m.row(q));
+		}
+	}
+
 	void AdjointTools::dJ_macro_strain_adjoint_term(
 		const State &state,
 		const Eigen::MatrixXd &sol,
@@ -674,9 +764,12 @@ namespace polyfem::solver
 		const int time_steps = state.args["time"]["time_steps"];
 		const int bdf_order = get_bdf_order(state);
 
-		Eigen::VectorXd elasticity_term, rhs_term, damping_term, mass_term, contact_term, friction_term;
+		Eigen::VectorXd body_term, contact_term, friction_term, mass_term;
 		one_form.setZero(state.n_geom_bases * state.mesh->dimension());
 
+		// the volume terms of every time step accumulate in the same per-thread vectors, the parallel loop is over the elements
+		auto storage = utils::create_thread_storage(LocalThreadShapeStorage(one_form.size()));
+
 		Eigen::VectorXd cur_p, cur_nu;
 		for (int i = time_steps; i > 0; --i)
 		{
@@ -685,45 +778,39 @@ namespace polyfem::solver
 			double beta_dt = beta * dt;
 			const double t = i * dt + t0;
 
-			Eigen::MatrixXd velocity = state.diff_cached.v(i);
-
 			cur_p = adjoint_p.col(i);
 			cur_nu = adjoint_nu.col(i);
 			cur_p(state.boundary_nodes).setZero();
 			cur_nu(state.boundary_nodes).setZero();
 
-			{
-				state.solve_data.inertia_form->force_shape_derivative(state.mesh->is_volume(), state.n_geom_bases, t, state.bases, state.geom_bases(), *(state.mass_matrix_assembler), state.mass_ass_vals_cache, velocity, cur_nu, mass_term);
-				state.solve_data.elastic_form->force_shape_derivative(t, state.n_geom_bases, state.diff_cached.u(i), state.diff_cached.u(i), cur_p, elasticity_term);
-				state.solve_data.body_form->force_shape_derivative(state.n_geom_bases, t, state.diff_cached.u(i - 1), cur_p, rhs_term);
-
-				if (state.solve_data.damping_form)
-					state.solve_data.damping_form->force_shape_derivative(t, state.n_geom_bases, state.diff_cached.u(i), state.diff_cached.u(i - 1), cur_p, damping_term);
-				else
-					damping_term.setZero(mass_term.size());
+			add_volume_forms_shape_derivative(state, t, state.diff_cached.u(i), state.diff_cached.u(i - 1), state.diff_cached.v(i), cur_nu, cur_p, beta_dt, storage);
 
-				if (state.is_contact_enabled())
-				{
-					state.solve_data.contact_form->force_shape_derivative(state.diff_cached.collision_set(i), state.diff_cached.u(i), cur_p, contact_term);
-					contact_term = state.gbasis_nodes_to_basis_nodes * contact_term;
-					// contact_term /= beta_dt * beta_dt;
-				}
-				else
-					contact_term.setZero(mass_term.size());
+			if (state.solve_data.body_form)
+			{
+				state.solve_data.body_form->force_shape_derivative_boundary(state.n_geom_bases, t, state.diff_cached.u(i - 1), cur_p, body_term);
+				one_form += beta_dt * body_term;
+			}
 
-				if (state.solve_data.friction_form)
-				{
-					state.solve_data.friction_form->force_shape_derivative(state.diff_cached.u(i - 1), state.diff_cached.u(i), cur_p, state.diff_cached.friction_collision_set(i), friction_term);
-					friction_term = state.gbasis_nodes_to_basis_nodes * (friction_term / beta);
-					// friction_term /= beta_dt * beta_dt;
-				}
-				else
-					friction_term.setZero(mass_term.size());
+			if (state.is_contact_enabled())
+			{
+				state.solve_data.contact_form->force_shape_derivative(state.diff_cached.collision_set(i), state.diff_cached.u(i), cur_p, contact_term);
+				contact_term = state.gbasis_nodes_to_basis_nodes * contact_term;
+				// contact_term /= beta_dt * beta_dt;
+				one_form += beta_dt * contact_term;
 			}
 
-			one_form += beta_dt * (elasticity_term + rhs_term + damping_term + contact_term + friction_term + mass_term);
+			if (state.solve_data.friction_form)
+			{
+				state.solve_data.friction_form->force_shape_derivative(state.diff_cached.u(i - 1), state.diff_cached.u(i), cur_p, state.diff_cached.friction_collision_set(i), friction_term);
+				friction_term = state.gbasis_nodes_to_basis_nodes * (friction_term / beta);
+				// friction_term /= beta_dt * beta_dt;
+				one_form += beta_dt * friction_term;
+			}
 		}
 
+		for (const LocalThreadShapeStorage &local_storage : storage)
+			one_form += local_storage.vec;
+
 		// time step 0
 		Eigen::VectorXd sum_alpha_p;
 		{
@@ -7,6 +7,11 @@ namespace polyfem
 {
 	class State;
 	class IntegrableFunctional;
+
+	namespace assembler
+	{
+		class ElementAssemblyValues;
+	}
 }
 
 namespace polyfem::solver
@@ -113,6 +118,17 @@ namespace polyfem::solver
 			const Eigen::MatrixXd &adjoint_p,
 			Eigen::VectorXd &one_form);
 
+		/// @brief adds the shape derivative of an element integral to term, given its density at the quadrature points:
+		/// the entry of the geometric basis v in direction d is sum_q density.row(q).segment(d * dim, dim).dot(grad v(q)),
+		/// i.e., density.row(q) is the row-major flattened dim x dim matrix multiplying the gradient of the shape velocity
+		/// @param[in] gvals geometric basis values of the element at the quadrature points of density
+		/// @param[in] density #quadrature points x dim^2, weighted by the quadrature
+		/// @param[in,out] term shape derivative ordered as the geometric bases
+		static void add_shape_derivative_density(
+			const assembler::ElementAssemblyValues &gvals,
+			const Eigen::MatrixXd &density,
+			Eigen::MatrixXd &term);
+
 		static Eigen::VectorXd map_primitive_to_node_order(
 			const State &state,
 			const Eigen::VectorXd &primitives);
@@ -1,5 +1,7 @@
 #include "FullNLProblem.hpp"
 
+#include <polyfem/utils/Profiler.hpp>
+
 namespace polyfem::solver
 {
 	FullNLProblem::FullNLProblem(const std::vector<std::shared_ptr<Form>> &forms)
@@ -49,8 +51,12 @@ namespace polyfem::solver
 
 	void FullNLProblem::line_search_begin(const TVector &x0, const TVector &x1)
 	{
+		POLYFEM_PROFILE_SCOPE("line_search_begin");
 		for (auto &f : forms_)
+		{
+			POLYFEM_PROFILE_SCOPE(f->name());
 			f->line_search_begin(x0, x1);
+		}
 	}
 
 	void FullNLProblem::line_search_end()
@@ -61,10 +67,15 @@ namespace polyfem::solver
 
 	double FullNLProblem::max_step_size(const TVector &x0, const TVector &x1) const
 	{
+		POLYFEM_PROFILE_SCOPE("max_step_size");
 		double step = 1;
 		for (auto &f : forms_)
-			if (f->enabled())
-				step = std::min(step, f->max_step_size(x0, x1));
+		{
+			if (!f->enabled())
+				continue;
+			POLYFEM_PROFILE_SCOPE(f->name());
+			step = std::min(step, f->max_step_size(x0, x1));
+		}
 		return step;
 	}
 
@@ -78,28 +89,41 @@ namespace polyfem::solver
 
 	bool FullNLProblem::is_step_collision_free(const TVector &x0, const TVector &x1) const
 	{
+		POLYFEM_PROFILE_SCOPE("is_step_collision_free");
 		for (auto &f : forms_)
-			if (f->enabled() && !f->is_step_collision_free(x0, x1))
+		{
+			if (!f->enabled())
+				continue;
+			POLYFEM_PROFILE_SCOPE(f->name());
+			if (!f->is_step_collision_free(x0, x1))
 				return false;
+		}
 		return true;
 	}
 
 	double FullNLProblem::value(const TVector &x)
 	{
+		POLYFEM_PROFILE_SCOPE("value");
 		double val = 0;
 		for (auto &f : forms_)
-			if (f->enabled())
-				val += f->value(x);
+		{
+			if (!f->enabled())
+				continue;
+			POLYFEM_PROFILE_SCOPE(f->name());
+			val += f->value(x);
+		}
 		return val;
 	}
 
 	void FullNLProblem::gradient(const TVector &x, TVector &grad)
 	{
+		POLYFEM_PROFILE_SCOPE("gradient");
 		grad = TVector::Zero(x.size());
 		for (auto &f : forms_)
 		{
 			if (!f->enabled())
 				continue;
+			POLYFEM_PROFILE_SCOPE(f->name());
 			TVector tmp;
 			f->first_derivative(x, tmp);
 			grad += tmp;
@@ -108,11 +132,13 @@ namespace polyfem::solver
 
 	void FullNLProblem::hessian(const TVector &x, THessian &hessian)
 	{
+		POLYFEM_PROFILE_SCOPE("hessian");
 		hessian.resize(x.size(), x.size());
 		for (auto &f : forms_)
 		{
 			if (!f->enabled())
 				continue;
+			POLYFEM_PROFILE_SCOPE(f->name());
 			THessian tmp;
 			f->second_derivative(x, tmp);
 			hessian += tmp;
@@ -121,8 +147,12 @@ namespace polyfem::solver
 
 	void FullNLProblem::solution_changed(const TVector &x)
 	{
+		POLYFEM_PROFILE_SCOPE("solution_changed");
 		for (auto &f : forms_)
+		{
+			POLYFEM_PROFILE_SCOPE(f->name());
 			f->solution_changed(x);
+		}
 	}
 
 	void FullNLProblem::post_step(const polysolve::nonlinear::PostStepData &data)
@@ -69,6 +69,7 @@ namespace polyfem::solver
 	void NLProblem::update_quantities(const double t, const TVector &x)
 	{
 		t_ = t;
+		invalidate_boundary_values();
 		const TVector full = reduced_to_full(x);
 		for (auto &f : forms_)
 			f->update_quantities(t, full);
@@ -113,7 +114,7 @@ namespace polyfem::solver
 		FullNLProblem::hessian(reduced_to_full(x), full_hessian);
 		assert(full_hessian.rows() == full_size());
 		assert(full_hessian.cols() == full_size());
-		utils::full_to_reduced_matrix(full_size(), current_size(), boundary_nodes_, full_hessian, hessian);
+		hessian_map_.apply(full_size(), current_size(), boundary_nodes_, full_hessian, hessian);
 	}
 
 	void NLProblem::solution_changed(const TVector &newX)
@@ -141,6 +142,7 @@ namespace polyfem::solver
 		TVector full = reduced_to_full(x);
 		for (auto &form : forms_)
 			form->set_apply_DBC(full, val);
+		invalidate_boundary_values();
 	}
 
 	NLProblem::TVector NLProblem::full_to_reduced(const TVector &full) const
@@ -153,7 +155,7 @@ namespace polyfem::solver
 	NLProblem::TVector NLProblem::reduced_to_full(const TVector &reduced) const
 	{
 		TVector full;
-		reduced_to_full_aux(boundary_nodes_, full_size(), current_size(), reduced, boundary_values(), full);
+		reduced_to_full_aux(boundary_nodes_, full_size(), current_size(), reduced, cached_boundary_values(), full);
 		return full;
 	}
 
@@ -165,6 +167,17 @@ namespace polyfem::solver
 		return result;
 	}
 
+	const Eigen::MatrixXd &NLProblem::cached_boundary_values() const
+	{
+		if (!boundary_values_cache_valid_ || boundary_values_cache_t_ != t_)
+		{
+			boundary_values_cache_ = boundary_values();
+			boundary_values_cache_t_ = t_;
+			boundary_values_cache_valid_ = true;
+		}
+		return boundary_values_cache_;
+	}
+
 	template <class FullMat, class ReducedMat>
 	void NLProblem::full_to_reduced_aux(const std::vector<int> &boundary_nodes, const int full_size, const int reduced_size, const FullMat &full, ReducedMat &reduced)
 	{
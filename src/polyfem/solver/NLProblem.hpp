@@ -3,6 +3,7 @@
 #include <polyfem/solver/FullNLProblem.hpp>
 #include <polyfem/assembler/RhsAssembler.hpp>
 #include <polyfem/mesh/LocalBoundary.hpp>
+#include <polyfem/utils/MatrixUtils.hpp>
 
 namespace polyfem::solver
 {
@@ -62,6 +63,9 @@ namespace polyfem::solver
 	protected:
 		virtual Eigen::MatrixXd boundary_values() const;
 
+		/// @brief Forces the next reduced_to_full to recompute boundary_values()
+		void invalidate_boundary_values() { boundary_values_cache_valid_ = false; }
+
 		const std::vector<int> &boundary_nodes_;
 
 		const int full_size_;    ///< Size of the full problem
@@ -84,6 +88,15 @@ namespace polyfem::solver
 		const int n_boundary_samples_;
 		double t_;
 
+		/// @brief boundary_values() at time t_, memoized since reduced_to_full is called for every evaluation
+		const Eigen::MatrixXd &cached_boundary_values() const;
+		mutable Eigen::MatrixXd boundary_values_cache_;
+		mutable double boundary_values_cache_t_ = 0;
+		mutable bool boundary_values_cache_valid_ = false;
+
+		/// @brief Reduced Hessian pattern and value map, rebuilt only when the full pattern changes
+		utils::FullToReducedMatrixMap hessian_map_;
+
 		template <class FullMat, class ReducedMat>
 		static void full_to_reduced_aux(const std::vector<int> &boundary_nodes, const int full_size, const int reduced_size, const FullMat &full, ReducedMat &reduced);
 
@@ -405,7 +405,7 @@ namespace polyfem::solver
 		return x;
 	}
 
-	std::shared_ptr<State> AdjointOptUtils::create_state(const json &args, CacheLevel level, const size_t max_threads)
+	std::shared_ptr<State> AdjointOptUtils::create_state(const json &args, CacheLevel level, const size_t max_threads, const std::vector<std::shared_ptr<State>> &previous_states, const bool keep_loaded_mesh)
 	{
 		std::shared_ptr<State> state = std::make_shared<State>();
 		state->set_max_threads(max_threads);
@@ -429,7 +429,24 @@ namespace polyfem::solver
 
 		state->optimization_enabled = level;
 		state->init(in_args, true);
+
+		// the mesh is copied and the assembly caches are shared from a previous state with the same discretization,
+		// the copy is taken from the mesh as loaded since build_basis renumbers the node ids of the mesh in place
+		for (const auto &other : previous_states)
+		{
+			if (other && other->loaded_mesh && state->has_same_discretization(*other))
+			{
+				logger().debug("Reusing the discretization of a previous state");
+				state->mesh = other->loaded_mesh->copy();
+				state->loaded_mesh = other->loaded_mesh;
+				state->discretization_source = other;
+				break;
+			}
+		}
+
 		state->load_mesh();
+		if (keep_loaded_mesh && !state->loaded_mesh && state->mesh)
+			state->loaded_mesh = state->mesh->copy();
 		Eigen::MatrixXd sol, pressure;
 		state->build_basis();
 		state->assemble_rhs();
@@ -448,8 +465,14 @@ namespace polyfem::solver
 			if (!load_json(args["path"], cur_args))
 				log_and_throw_adjoint_error("Can't find json for State {}", i);
 
-			states[i++] = AdjointOptUtils::create_state(cur_args, level, max_threads);
+			states[i] = AdjointOptUtils::create_state(cur_args, level, max_threads, states, i + 1 < states.size());
+			++i;
 		}
+
+		// the loaded meshes are only needed to create the states
+		for (const auto &state : states)
+			state->loaded_mesh.reset();
+
 		return states;
 	}
 
@@ -27,7 +27,9 @@ namespace polyfem::solver
 
 		static std::shared_ptr<polysolve::nonlinear::Solver> make_nl_solver(const json &solver_params, const json &linear_solver_params, const double characteristic_length);
 
-		static std::shared_ptr<State> create_state(const json &args, CacheLevel level = CacheLevel::Derivatives, const size_t max_threads = 32);
+		/// the state reuses the mesh and the assembly caches of the first of previous_states with the same discretization,
+		/// keep_loaded_mesh keeps a copy of the loaded mesh (State::loaded_mesh) for the states created after this one
+		static std::shared_ptr<State> create_state(const json &args, CacheLevel level = CacheLevel::Derivatives, const size_t max_threads = 32, const std::vector<std::shared_ptr<State>> &previous_states = {}, const bool keep_loaded_mesh = false);
 
 		static std::vector<std::shared_ptr<State>> create_states(const json &state_args, const CacheLevel &level, const size_t max_threads);
 
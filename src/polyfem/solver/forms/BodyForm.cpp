@@ -117,7 +117,6 @@ namespace polyfem::solver
 		const auto &bases = rhs_assembler_.bases();
 		const auto &gbases = rhs_assembler_.gbases();
 		const int dim = rhs_assembler_.mesh().dimension();
-		const int actual_dim = rhs_assembler_.problem().is_scalar() ? 1 : dim;
 
 		const int n_elements = int(bases.size());
 		term.setZero(n_verts * dim, 1);
@@ -126,6 +125,7 @@ namespace polyfem::solver
 
 		utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
 			LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+			Eigen::MatrixXd density;
 
 			for (int e = start; e < end; ++e)
 			{
@@ -134,31 +134,63 @@ namespace polyfem::solver
 				assembler::ElementAssemblyValues &gvals = local_storage.gvals;
 				gvals.compute(e, rhs_assembler_.mesh().is_volume(), vals.quadrature.points, gbases[e], gbases[e]);
 
-				const quadrature::Quadrature &quadrature = vals.quadrature;
-				local_storage.da = vals.det.array() * quadrature.weights.array();
+				density.setZero(vals.quadrature.weights.size(), dim * dim);
+				force_shape_derivative_density(t, e, vals, adjoint, density);
+				AdjointTools::add_shape_derivative_density(gvals, density, local_storage.vec);
+			}
+		});
 
-				Eigen::MatrixXd p, grad_p;
-				io::Evaluator::interpolate_at_local_vals(e, dim, actual_dim, vals, adjoint, p, grad_p);
+		for (const LocalThreadVecStorage &local_storage : storage)
+			term += local_storage.vec;
 
-				Eigen::MatrixXd rhs_function;
-				rhs_assembler_.problem().rhs(rhs_assembler_.assembler(), vals.val, t, rhs_function);
-				rhs_function *= -1;
-				for (int q = 0; q < vals.val.rows(); q++)
-				{
-					const double rho = density_(quadrature.points.row(q), vals.val.row(q), t, e);
-					rhs_function.row(q) *= rho;
-				}
+		Eigen::VectorXd boundary_term;
+		force_shape_derivative_boundary(n_verts, t, x, adjoint, boundary_term);
+		term += boundary_term;
+	}
 
-				for (int q = 0; q < local_storage.da.size(); ++q)
-				{
-					const double value = p.row(q).dot(rhs_function.row(q)) * local_storage.da(q);
-					for (auto &v : gvals.basis_values)
-					{
-						local_storage.vec.block(v.global[0].index * dim, 0, dim, 1) += value * v.grad_t_m.row(q).transpose();
-					}
-				}
-			}
-		});
+	void BodyForm::force_shape_derivative_density(
+		const double t,
+		const int e,
+		const assembler::ElementAssemblyValues &vals,
+		const Eigen::MatrixXd &adjoint,
+		Eigen::MatrixXd &density) const
+	{
+		const int dim = rhs_assembler_.mesh().dimension();
+		const int actual_dim = rhs_assembler_.problem().is_scalar() ? 1 : dim;
+
+		const quadrature::Quadrature &quadrature = vals.quadrature;
+		const QuadratureVector da = vals.det.array() * quadrature.weights.array();
+
+		Eigen::MatrixXd p, grad_p;
+		io::Evaluator::interpolate_at_local_vals(e, dim, actual_dim, vals, adjoint, p, grad_p);
+
+		Eigen::MatrixXd rhs_function;
+		rhs_assembler_.problem().rhs(rhs_assembler_.assembler(), vals.val, t, rhs_function);
+		for (int q = 0; q < vals.val.rows(); q++)
+		{
+			const double rho = density_(quadrature.points.row(q), vals.val.row(q), t, e);
+			rhs_function.row(q) *= rho;
+		}
+
+		// the integrand only scales with the volume change, i.e., it is value * div(v)
+		for (int q = 0; q < da.size(); ++q)
+		{
+			const double value = p.row(q).dot(rhs_function.row(q)) * da(q);
+			for (int d = 0; d < dim; ++d)
+				density(q, d * dim + d) += value;
+		}
+	}
+
+	void BodyForm::force_shape_derivative_boundary(const int n_verts, const double t, const Eigen::MatrixXd &x, const Eigen::MatrixXd &adjoint, Eigen::VectorXd &term)
+	{
+		const auto &bases = rhs_assembler_.bases();
+		const auto &gbases = rhs_assembler_.gbases();
+		const int dim = rhs_assembler_.mesh().dimension();
+		const int actual_dim = rhs_assembler_.problem().is_scalar() ? 1 : dim;
+
+		term.setZero(n_verts * dim, 1);
+
+		auto storage = utils::create_thread_storage(LocalThreadVecStorage(term.size()));
 
 		// Zero entries in p that correspond to nodes lying between dirichlet and neumann surfaces
 		// DO NOT PARALLELIZE since they both write to the same location
@@ -77,6 +77,31 @@ namespace polyfem::solver
 			const Eigen::MatrixXd &adjoint,
 			Eigen::VectorXd &term);
 
+		/// @brief Adds the integrand of the body force term of force_shape_derivative on one element to density, see AdjointTools::add_shape_derivative_density
+		/// @param[in] t Current time
+		/// @param[in] e Element index
+		/// @param[in] vals Assembly values of the element
+		/// @param[in] adjoint Current adjoint solution
+		/// @param[in,out] density #quadrature points x dim^2 shape derivative density, weighted by the quadrature
+		void force_shape_derivative_density(
+			const double t,
+			const int e,
+			const assembler::ElementAssemblyValues &vals,
+			const Eigen::MatrixXd &adjoint,
+			Eigen::MatrixXd &density) const;
+
+		/// @brief Neumann boundary terms of force_shape_derivative
+		/// @param[in] n_verts Number of vertices
+		/// @param[in] x Current solution
+		/// @param[in] adjoint Current adjoint solution
+		/// @param[out] term Derivative of the Neumann forces multiplied by the adjoint
+		void force_shape_derivative_boundary(
+			const int n_verts,
+			const double t,
+			const Eigen::MatrixXd &x,
+			const Eigen::MatrixXd &adjoint,
+			Eigen::VectorXd &term);
+
 		void hessian_wrt_u_prev(
 			const Eigen::VectorXd &u_prev,
 			const double t,
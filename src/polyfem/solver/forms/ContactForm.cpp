@@ -125,17 +125,67 @@ namespace polyfem::solver
 	void ContactForm::update_collision_set(const Eigen::MatrixXd &displaced_surface)
 	{
 		// Store the previous value used to compute the constraint set to avoid duplicate computation.
-		static Eigen::MatrixXd cached_displaced_surface;
-		if (cached_displaced_surface.size() == displaced_surface.size() && cached_displaced_surface == displaced_surface)
+		if (cached_displaced_surface_.size() == displaced_surface.size() && cached_displaced_surface_ == displaced_surface)
 			return;
 
 		if (use_cached_candidates_)
 			collision_set_.build(
-				candidates_, collision_mesh_, displaced_surface, dhat_);
+				line_search_candidates(), collision_mesh_, displaced_surface, dhat_);
+		else if (candidate_skin_ > 0)
+		{
+			// only the narrow phase is done when the vertices stayed within the skin
+			if (are_persistent_candidates_valid(displaced_surface, displaced_surface))
+				++persistent_candidates_reuses_;
+			else
+				build_persistent_candidates(displaced_surface);
+
+			collision_set_.build(
+				persistent_candidates_, collision_mesh_, displaced_surface, dhat_);
+		}
 		else
 			collision_set_.build(
 				collision_mesh_, displaced_surface, dhat_, dmin_, broad_phase_method_);
-		cached_displaced_surface = displaced_surface;
+		cached_displaced_surface_ = displaced_surface;
+	}
+
+	void ContactForm::set_candidate_skin(const double skin)
+	{
+		assert(skin >= 0);
+		candidate_skin_ = skin;
+		persistent_candidates_.clear();
+		persistent_candidates_vertices_.resize(0, 0);
+	}
+
+	bool ContactForm::are_persistent_candidates_valid(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const
+	{
+		if (candidate_skin_ <= 0 || persistent_candidates_vertices_.size() != V0.size())
+			return false;
+
+		// If every vertex stays in a box of half-size skin around where the candidates were built, so does the box
+		// of every primitive along the trajectory from V0 to V1. Boxes overlapping after an inflation of r overlap at
+		// the build positions after an inflation of r + skin, so they are in the persistent candidates.
+		return (V0 - persistent_candidates_vertices_).lpNorm<Eigen::Infinity>() <= candidate_skin_
+			   && (V1 - persistent_candidates_vertices_).lpNorm<Eigen::Infinity>() <= candidate_skin_;
+	}
+
+	void ContactForm::build_persistent_candidates(const Eigen::MatrixXd &V)
+	{
+		const size_t prev_size = persistent_candidates_.size();
+		const double prev_build_time = persistent_candidates_build_time_;
+
+		persistent_candidates_build_time_ = 0;
+		{
+			POLYFEM_SCOPED_TIMER("persistent contact candidates", persistent_candidates_build_time_);
+			persistent_candidates_.build(
+				collision_mesh_, V, /*inflation_radius=*/(dhat_ + dmin_) / 2 + candidate_skin_, broad_phase_method_);
+		}
+		persistent_candidates_vertices_ = V;
+
+		logger().debug(
+			"Rebuilt persistent contact candidates ({} -> {}) after {} reuses, about {:g}s of broad phase saved",
+			prev_size, persistent_candidates_.size(), persistent_candidates_reuses_,
+			persistent_candidates_reuses_ * prev_build_time);
+		persistent_candidates_reuses_ = 0;
 	}
 
 	double ContactForm::value_unweighted(const Eigen::VectorXd &x) const
@@ -227,7 +277,7 @@ namespace polyfem::solver
 
 		double max_step;
 		if (use_cached_candidates_ && broad_phase_method_ != ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE_GPU)
-			max_step = candidates_.compute_collision_free_stepsize(
+			max_step = line_search_candidates().compute_collision_free_stepsize(
 				collision_mesh_, V0, V1, dmin_, ccd_tolerance_, ccd_max_iterations_);
 		else
 			max_step = ipc::compute_collision_free_stepsize(
@@ -260,20 +310,38 @@ namespace polyfem::solver
 
 	void ContactForm::line_search_begin(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1)
 	{
+		const Eigen::MatrixXd V0 = compute_displaced_surface(x0);
+		const Eigen::MatrixXd V1 = compute_displaced_surface(x1);
+
+		use_cached_candidates_ = true;
+
+		if (candidate_skin_ > 0)
+		{
+			use_persistent_candidates_ = are_persistent_candidates_valid(V0, V1);
+			if (use_persistent_candidates_)
+				++persistent_candidates_reuses_;
+			else if ((V1 - V0).lpNorm<Eigen::Infinity>() <= candidate_skin_)
+			{
+				build_persistent_candidates(V0);
+				use_persistent_candidates_ = true;
+			}
+
+			// long steps leave the skin, they use the swept candidates and the persistent ones are kept
+			if (use_persistent_candidates_)
+				return;
+		}
+
 		candidates_.build(
-			collision_mesh_,
-			compute_displaced_surface(x0),
-			compute_displaced_surface(x1),
+			collision_mesh_, V0, V1,
 			/*inflation_radius=*/dhat_ / 2,
 			broad_phase_method_);
-
-		use_cached_candidates_ = true;
 	}
 
 	void ContactForm::line_search_end()
 	{
 		candidates_.clear();
 		use_cached_candidates_ = false;
+		use_persistent_candidates_ = false;
 	}
 
 	void ContactForm::post_step(const polysolve::nonlinear::PostStepData &data)
@@ -326,7 +394,7 @@ namespace polyfem::solver
 
 		bool is_valid;
 		if (use_cached_candidates_)
-			is_valid = candidates_.is_step_collision_free(
+			is_valid = line_search_candidates().is_step_collision_free(
 				collision_mesh_, displaced0, displaced1, dmin_,
 				ccd_tolerance_, ccd_max_iterations_);
 		else
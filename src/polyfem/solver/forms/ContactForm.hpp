@@ -140,6 +140,10 @@ namespace polyfem::solver
 		/// @brief If true, output debug files
 		bool save_ccd_debug_meshes = false;
 
+		/// @brief Keep the broad-phase candidates across line searches and Newton iterations
+		/// @param skin Extra inflation of the candidate boxes, the candidates are rebuilt only when a vertex moves farther than this from where they were built (0 disables it)
+		void set_candidate_skin(const double skin);
+
 		double dhat() const { return dhat_; }
 		ipc::Collisions get_collision_set() const { return collision_set_; }
 
@@ -150,6 +154,15 @@ namespace polyfem::solver
 		/// @param displaced_surface Vertex positions displaced by the current solution
 		void update_collision_set(const Eigen::MatrixXd &displaced_surface);
 
+		/// @brief Check if the persistent candidates contain all the candidates for every configuration between V0 and V1
+		bool are_persistent_candidates_valid(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const;
+
+		/// @brief Rebuild the persistent candidates around V
+		void build_persistent_candidates(const Eigen::MatrixXd &V);
+
+		/// @brief Candidates used during the line search
+		const ipc::Candidates &line_search_candidates() const { return use_persistent_candidates_ ? persistent_candidates_ : candidates_; }
+
 		/// @brief Collision mesh
 		const ipc::CollisionMesh &collision_mesh_;
 
@@ -189,9 +202,24 @@ namespace polyfem::solver
 		bool use_cached_candidates_ = false;
 		/// @brief Cached constraint set for the current solution
 		ipc::Collisions collision_set_;
+		/// @brief Vertices the cached constraint set was built at
+		Eigen::MatrixXd cached_displaced_surface_;
 		/// @brief Cached candidate set for the current solution
 		ipc::Candidates candidates_;
 
+		/// @brief Extra inflation of the persistent candidates, 0 if disabled
+		double candidate_skin_ = 0;
+		/// @brief If true, the line search uses the persistent candidates
+		bool use_persistent_candidates_ = false;
+		/// @brief Candidates kept across iterations, built with boxes inflated by the skin
+		ipc::Candidates persistent_candidates_;
+		/// @brief Surface vertices the persistent candidates were built at
+		Eigen::MatrixXd persistent_candidates_vertices_;
+		/// @brief Time of the last build of the persistent candidates
+		double persistent_candidates_build_time_ = 0;
+		/// @brief Number of broad phases avoided since the last build of the persistent candidates
+		int persistent_candidates_reuses_ = 0;
+
 		const ipc::BarrierPotential barrier_potential_;
 	};
 } // namespace polyfem::solver
@@ -6,6 +6,7 @@
 #include <polyfem/utils/Timer.hpp>
 #include <polyfem/utils/MaybeParallelFor.hpp>
 #include <polyfem/assembler/ViscousDamping.hpp>
+#include <polyfem/solver/AdjointTools.hpp>
 
 using namespace polyfem::assembler;
 using namespace polyfem::utils;
@@ -29,6 +30,19 @@ namespace polyfem::solver
 		};
 
 		double dot(const Eigen::MatrixXd &A, const Eigen::MatrixXd &B) { return (A.array() * B.array()).sum(); }
+
+		/// S^T : P, with the dim^2 x dim^2 stress gradient S such that (S : X)(i, j) = sum_kl S(i * dim + j, k * dim + l) X(k, l)
+		Eigen::MatrixXd transposed_contraction(const Eigen::MatrixXd &S, const Eigen::MatrixXd &P)
+		{
+			const int dim = P.rows();
+			Eigen::MatrixXd result = Eigen::MatrixXd::Zero(dim, dim);
+			for (int i = 0; i < dim; i++)
+				for (int j = 0; j < dim; j++)
+					for (int k = 0; k < dim; k++)
+						for (int l = 0; l < dim; l++)
+							result(k, l) += S(i * dim + j, k * dim + l) * P(i, j);
+			return result;
+		}
 	} // namespace
 
 	ElasticForm::ElasticForm(const int n_bases,
@@ -215,136 +229,100 @@ namespace polyfem::solver
 	void ElasticForm::force_shape_derivative(const double t, const int n_verts, const Eigen::MatrixXd &x, const Eigen::MatrixXd &x_prev, const Eigen::MatrixXd &adjoint, Eigen::VectorXd &term)
 	{
 		const int dim = is_volume_ ? 3 : 2;
-		const int actual_dim = (assembler_.name() == "Laplacian") ? 1 : dim;
 
 		const int n_elements = int(bases_.size());
 		term.setZero(n_verts * dim, 1);
 
 		auto storage = utils::create_thread_storage(LocalThreadVecStorage(term.size()));
 
-		if (assembler_.name() == "ViscousDamping")
-		{
-			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
-				LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
-
-				for (int e = start; e < end; ++e)
-				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
-					assembler::ElementAssemblyValues gvals;
-					gvals.compute(e, is_volume_, vals.quadrature.points, geom_bases_[e], geom_bases_[e]);
-
-					const quadrature::Quadrature &quadrature = vals.quadrature;
-					local_storage.da = vals.det.array() * quadrature.weights.array();
+		utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+			LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+			assembler::ElementAssemblyValues gvals;
+			Eigen::MatrixXd density;
 
-					Eigen::MatrixXd u, grad_u, prev_u, prev_grad_u, p, grad_p;
-					io::Evaluator::interpolate_at_local_vals(e, dim, dim, vals, x, u, grad_u);
-					io::Evaluator::interpolate_at_local_vals(e, dim, dim, vals, x_prev, prev_u, prev_grad_u);
-					io::Evaluator::interpolate_at_local_vals(e, dim, dim, vals, adjoint, p, grad_p);
+			for (int e = start; e < end; ++e)
+			{
+				assembler::ElementAssemblyValues &vals = local_storage.vals;
+				ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
+				gvals.compute(e, is_volume_, vals.quadrature.points, geom_bases_[e], geom_bases_[e]);
 
-					Eigen::MatrixXd grad_u_i, grad_p_i, prev_grad_u_i;
-					Eigen::MatrixXd grad_v_i;
-					Eigen::MatrixXd stress_tensor, f_prime_gradu_gradv;
-					Eigen::MatrixXd f_prev_prime_prev_gradu_gradv;
+				density.setZero(vals.quadrature.weights.size(), dim * dim);
+				force_shape_derivative_density(t, e, vals, x, x_prev, adjoint, density);
+				AdjointTools::add_shape_derivative_density(gvals, density, local_storage.vec);
+			}
+		});
 
-					for (int q = 0; q < local_storage.da.size(); ++q)
-					{
-						vector2matrix(grad_u.row(q), grad_u_i);
-						vector2matrix(grad_p.row(q), grad_p_i);
-						vector2matrix(prev_grad_u.row(q), prev_grad_u_i);
+		for (const LocalThreadVecStorage &local_storage : storage)
+			term += local_storage.vec;
+	}
 
-						for (auto &v : gvals.basis_values)
-						{
-							Eigen::MatrixXd stress_grad, stress_prev_grad;
-							assembler_.compute_stress_grad(OptAssemblerData(t, dt_, e, quadrature.points.row(q), vals.val.row(q), grad_u_i), prev_grad_u_i, stress_tensor, stress_grad);
-							assembler_.compute_stress_prev_grad(OptAssemblerData(t, dt_, e, quadrature.points.row(q), vals.val.row(q), grad_u_i), prev_grad_u_i, stress_prev_grad);
-							for (int d = 0; d < dim; d++)
-							{
-								grad_v_i.setZero(dim, dim);
-								grad_v_i.row(d) = v.grad_t_m.row(q);
-
-								f_prime_gradu_gradv.setZero(dim, dim);
-								Eigen::MatrixXd tmp = grad_u_i * grad_v_i;
-								for (int i = 0; i < f_prime_gradu_gradv.rows(); i++)
-									for (int j = 0; j < f_prime_gradu_gradv.cols(); j++)
-										for (int k = 0; k < tmp.rows(); k++)
-											for (int l = 0; l < tmp.cols(); l++)
-												f_prime_gradu_gradv(i, j) += stress_grad(i * dim + j, k * dim + l) * tmp(k, l);
-
-								f_prev_prime_prev_gradu_gradv.setZero(dim, dim);
-								tmp = prev_grad_u_i * grad_v_i;
-								for (int i = 0; i < f_prev_prime_prev_gradu_gradv.rows(); i++)
-									for (int j = 0; j < f_prev_prime_prev_gradu_gradv.cols(); j++)
-										for (int k = 0; k < tmp.rows(); k++)
-											for (int l = 0; l < tmp.cols(); l++)
-												f_prev_prime_prev_gradu_gradv(i, j) += stress_prev_grad(i * dim + j, k * dim + l) * tmp(k, l);
-
-								tmp = grad_v_i - grad_v_i.trace() * Eigen::MatrixXd::Identity(dim, dim);
-								local_storage.vec(v.global[0].index * dim + d) -= dot(f_prime_gradu_gradv + f_prev_prime_prev_gradu_gradv + stress_tensor * tmp.transpose(), grad_p_i) * local_storage.da(q);
-							}
-						}
-					}
-				}
-			});
-		}
-		else
+	void ElasticForm::force_shape_derivative_density(
+		const double t,
+		const int e,
+		const assembler::ElementAssemblyValues &vals,
+		const Eigen::MatrixXd &x,
+		const Eigen::MatrixXd &x_prev,
+		const Eigen::MatrixXd &adjoint,
+		Eigen::MatrixXd &density) const
+	{
+		const int dim = is_volume_ ? 3 : 2;
+		const int actual_dim = (assembler_.name() == "Laplacian") ? 1 : dim;
+		const bool is_damping = assembler_.name() == "ViscousDamping";
+
+		const quadrature::Quadrature &quadrature = vals.quadrature;
+		const QuadratureVector da = vals.det.array() * quadrature.weights.array();
+
+		Eigen::MatrixXd u, grad_u, prev_u, prev_grad_u, p, grad_p;
+		io::Evaluator::interpolate_at_local_vals(e, dim, actual_dim, vals, x, u, grad_u);
+		io::Evaluator::interpolate_at_local_vals(e, dim, actual_dim, vals, adjoint, p, grad_p);
+		if (is_damping)
+			io::Evaluator::interpolate_at_local_vals(e, dim, dim, vals, x_prev, prev_u, prev_grad_u);
+
+		Eigen::MatrixXd local_pt, global_pt, grad_u_i, grad_p_i, prev_grad_u_i;
+		Eigen::MatrixXd stress_tensor, stress_grad, stress_prev_grad, stress_grad_p;
+		Eigen::MatrixXd shape_density;
+
+		// The derivative wrt the geometric basis v in direction d has grad_v_i = e_d * grad(v)^T, and it is
+		// linear in grad_v_i, so it is <shape_density, grad_v_i> with the adjoint of every term moved on grad_p_i:
+		// dot(stress_grad : (grad_u_i * grad_v_i), grad_p_i) = <grad_u_i^T * (stress_grad^T : grad_p_i), grad_v_i>
+		// dot(stress_tensor * (grad_v_i - tr(grad_v_i) I)^T, grad_p_i) = <grad_p_i^T * stress_tensor - dot(stress_tensor, grad_p_i) I, grad_v_i>
+		for (int q = 0; q < da.size(); ++q)
 		{
-			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
-				LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+			if (actual_dim == 1)
+			{
+				grad_u_i = grad_u.row(q);
+				grad_p_i = grad_p.row(q);
+			}
+			else
+			{
+				vector2matrix(grad_u.row(q), grad_u_i);
+				vector2matrix(grad_p.row(q), grad_p_i);
+			}
 
-				for (int e = start; e < end; ++e)
-				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
-					assembler::ElementAssemblyValues gvals;
-					gvals.compute(e, is_volume_, vals.quadrature.points, geom_bases_[e], geom_bases_[e]);
+			local_pt = quadrature.points.row(q);
+			global_pt = vals.val.row(q);
+			const OptAssemblerData data(t, dt_, e, local_pt, global_pt, grad_u_i);
+			if (is_damping)
+			{
+				vector2matrix(prev_grad_u.row(q), prev_grad_u_i);
 
-					const quadrature::Quadrature &quadrature = vals.quadrature;
-					local_storage.da = vals.det.array() * quadrature.weights.array();
+				assembler_.compute_stress_grad(data, prev_grad_u_i, stress_tensor, stress_grad);
+				assembler_.compute_stress_prev_grad(data, prev_grad_u_i, stress_prev_grad);
+				shape_density = grad_u_i.transpose() * transposed_contraction(stress_grad, grad_p_i)
+								+ prev_grad_u_i.transpose() * transposed_contraction(stress_prev_grad, grad_p_i);
+			}
+			else
+			{
+				// the stress gradient of an elastic energy is its Hessian, hence symmetric
+				assembler_.compute_stress_grad_multiply_mat(data, grad_p_i, stress_tensor, stress_grad_p);
+				shape_density = grad_u_i.transpose() * stress_grad_p;
+			}
 
-					Eigen::MatrixXd u, grad_u, p, grad_p; //, stiffnesses;
-					io::Evaluator::interpolate_at_local_vals(e, dim, actual_dim, vals, x, u, grad_u);
-					io::Evaluator::interpolate_at_local_vals(e, dim, actual_dim, vals, adjoint, p, grad_p);
-					// assembler_.compute_stiffness_value(formulation_, vals, quadrature.points, x, stiffnesses);
+			shape_density += grad_p_i.transpose() * stress_tensor;
+			shape_density.diagonal().array() -= dot(stress_tensor, grad_p_i);
 
-					for (int q = 0; q < local_storage.da.size(); ++q)
-					{
-						Eigen::MatrixXd grad_u_i, grad_p_i, stiffness_i;
-						if (actual_dim == 1)
-						{
-							grad_u_i = grad_u.row(q);
-							grad_p_i = grad_p.row(q);
-						}
-						else
-						{
-							vector2matrix(grad_u.row(q), grad_u_i);
-							vector2matrix(grad_p.row(q), grad_p_i);
-						}
-
-						// stiffness_i = utils::unflatten(stiffnesses.row(q).transpose(), actual_dim * dim);
-
-						for (auto &v : gvals.basis_values)
-						{
-							for (int d = 0; d < dim; d++)
-							{
-								Eigen::MatrixXd grad_v_i;
-								grad_v_i.setZero(dim, dim);
-								grad_v_i.row(d) = v.grad_t_m.row(q);
-
-								Eigen::MatrixXd stress_tensor, f_prime_gradu_gradv;
-								assembler_.compute_stress_grad_multiply_mat(OptAssemblerData(t, dt_, e, quadrature.points.row(q), vals.val.row(q), grad_u_i), grad_u_i * grad_v_i, stress_tensor, f_prime_gradu_gradv);
-								// f_prime_gradu_gradv = utils::unflatten(stiffness_i * utils::flatten(grad_u_i * grad_v_i), dim);
-
-								Eigen::MatrixXd tmp = grad_v_i - grad_v_i.trace() * Eigen::MatrixXd::Identity(dim, dim);
-								local_storage.vec(v.global[0].index * dim + d) -= dot(f_prime_gradu_gradv + stress_tensor * tmp.transpose(), grad_p_i) * local_storage.da(q);
-							}
-						}
-					}
-				}
-			});
+			for (int d = 0; d < dim; ++d)
+				density.row(q).segment(d * dim, dim) -= da(q) * shape_density.row(d);
 		}
-
-		for (const LocalThreadVecStorage &local_storage : storage)
-			term += local_storage.vec;
 	}
 } // namespace polyfem::solver
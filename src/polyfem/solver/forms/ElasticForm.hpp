@@ -78,6 +78,23 @@ namespace polyfem::solver
 		/// @param[out] term Derivative of force multiplied by the adjoint
 		void force_shape_derivative(const double t, const int n_verts, const Eigen::MatrixXd &x, const Eigen::MatrixXd &x_prev, const Eigen::MatrixXd &adjoint, Eigen::VectorXd &term);
 
+		/// @brief Adds the integrand of force_shape_derivative on one element to density, see AdjointTools::add_shape_derivative_density
+		/// @param t Current time
+		/// @param[in] e Element index
+		/// @param[in] vals Assembly values of the element
+		/// @param[in] x Current solution
+		/// @param[in] x_prev Previous solution, used by damping
+		/// @param[in] adjoint Current adjoint solution
+		/// @param[in,out] density #quadrature points x dim^2 shape derivative density, weighted by the quadrature
+		void force_shape_derivative_density(
+			const double t,
+			const int e,
+			const assembler::ElementAssemblyValues &vals,
+			const Eigen::MatrixXd &x,
+			const Eigen::MatrixXd &x_prev,
+			const Eigen::MatrixXd &adjoint,
+			Eigen::MatrixXd &density) const;
+
 	private:
 		const int n_bases_;
 		const std::vector<basis::ElementBases> &bases_;
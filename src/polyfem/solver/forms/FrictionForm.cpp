@@ -3,6 +3,9 @@
 
 #include <polyfem/utils/Timer.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
+
+#include <algorithm>
 
 namespace polyfem::solver
 {
@@ -120,12 +123,107 @@ namespace polyfem::solver
 	{
 		POLYFEM_SCOPED_TIMER("friction hessian");
 
-		hessian = dv_dx() * friction_potential_.hessian( //
-					  friction_collision_set_, collision_mesh_, compute_surface_velocities(x), project_to_psd_);
+		const int ndof = collision_mesh_.num_vertices() * collision_mesh_.dim();
+		if (friction_collision_set_.empty())
+		{
+			hessian = collision_mesh_.to_full_dof(StiffnessMatrix(ndof, ndof));
+			return;
+		}
+		assert(hessian_slots_offsets_.size() == friction_collision_set_.size() + 1);
+
+		const Eigen::MatrixXd velocities = compute_surface_velocities(x);
+		const Eigen::MatrixXi &E = collision_mesh_.edges();
+		const Eigen::MatrixXi &F = collision_mesh_.faces();
+
+		// the pattern is fixed between lagging updates, every collision adds its local Hessian to the values directly
+		const int n_values = hessian_inner_index_.size();
+		auto storage = utils::create_thread_storage<Eigen::VectorXd>(Eigen::VectorXd::Zero(n_values));
+
+		utils::maybe_parallel_for(friction_collision_set_.size(), [&](int start, int end, int thread_id) {
+			Eigen::VectorXd &local_storage = utils::get_local_thread_storage(storage, thread_id);
+
+			for (size_t i = start; i < end; i++)
+			{
+				const auto &collision = friction_collision_set_[i];
+				const auto local_hessian = friction_potential_.hessian(
+					collision, collision.dof(velocities, E, F), project_to_psd_);
+
+				const int *slots = hessian_slots_.data() + hessian_slots_offsets_[i];
+				assert(local_hessian.size() == hessian_slots_offsets_[i + 1] - hessian_slots_offsets_[i]);
+				for (int k = 0; k < local_hessian.size(); ++k)
+					local_storage[slots[k]] += local_hessian(k);
+			}
+		});
+
+		Eigen::VectorXd values = Eigen::VectorXd::Zero(n_values);
+		for (const auto &local_values : storage)
+			values += local_values;
+		values *= dv_dx();
+
+		hessian = Eigen::Map<const StiffnessMatrix>(
+			ndof, ndof, n_values, hessian_outer_index_.data(), hessian_inner_index_.data(), values.data());
 
 		hessian = collision_mesh_.to_full_dof(hessian);
 	}
 
+	void FrictionForm::init_hessian_pattern()
+	{
+		const int dim = collision_mesh_.dim();
+		const int ndof = collision_mesh_.num_vertices() * dim;
+		const Eigen::MatrixXi &E = collision_mesh_.edges();
+		const Eigen::MatrixXi &F = collision_mesh_.faces();
+
+		// global dof of every local dof of the collisions, in the order of the local Hessians
+		hessian_slots_offsets_.resize(friction_collision_set_.size() + 1);
+		hessian_slots_offsets_[0] = 0;
+		std::vector<std::vector<int>> dofs(friction_collision_set_.size());
+		for (size_t i = 0; i < friction_collision_set_.size(); ++i)
+		{
+			const auto &collision = friction_collision_set_[i];
+			const std::array<long, 4> vids = collision.vertex_ids(E, F);
+			for (int v = 0; v < collision.num_vertices(); ++v)
+			{
+				assert(vids[v] >= 0);
+				for (int d = 0; d < dim; ++d)
+					dofs[i].push_back(vids[v] * dim + d);
+			}
+			hessian_slots_offsets_[i + 1] = hessian_slots_offsets_[i] + dofs[i].size() * dofs[i].size();
+		}
+
+		std::vector<Eigen::Triplet<double>> entries;
+		entries.reserve(hessian_slots_offsets_.back());
+		for (const auto &local_dofs : dofs)
+			for (const int col : local_dofs)
+				for (const int row : local_dofs)
+					entries.emplace_back(row, col, 0);
+
+		StiffnessMatrix pattern(ndof, ndof);
+		pattern.setFromTriplets(entries.begin(), entries.end());
+		pattern.makeCompressed();
+		hessian_outer_index_.assign(pattern.outerIndexPtr(), pattern.outerIndexPtr() + pattern.outerSize() + 1);
+		hessian_inner_index_.assign(pattern.innerIndexPtr(), pattern.innerIndexPtr() + pattern.nonZeros());
+
+		// the local Hessians are column major, as the pattern
+		hessian_slots_.resize(hessian_slots_offsets_.back());
+		utils::maybe_parallel_for(dofs.size(), [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+			{
+				int k = hessian_slots_offsets_[i];
+				for (const int col : dofs[i])
+				{
+					const auto col_begin = hessian_inner_index_.begin() + hessian_outer_index_[col];
+					const auto col_end = hessian_inner_index_.begin() + hessian_outer_index_[col + 1];
+					for (const int row : dofs[i])
+					{
+						const auto it = std::lower_bound(col_begin, col_end, row);
+						assert(it != col_end && *it == row);
+						hessian_slots_[k++] = it - hessian_inner_index_.begin();
+					}
+				}
+			}
+		});
+	}
+
 	void FrictionForm::update_lagging(const Eigen::VectorXd &x, const int iter_num)
 	{
 		const Eigen::MatrixXd displaced_surface = compute_displaced_surface(x);
@@ -140,5 +238,7 @@ namespace polyfem::solver
 		friction_collision_set_.build(
 			collision_mesh_, displaced_surface, collision_set,
 			contact_form_.get_barrier_potential(), contact_form_.barrier_stiffness(), mu_);
+
+		init_hessian_pattern();
 	}
 } // namespace polyfem::solver
@@ -91,6 +91,9 @@ namespace polyfem::solver
 		const ipc::FrictionPotential &get_friction_potential() const { return friction_potential_; }
 
 	private:
+		/// @brief Builds the sparsity pattern of the friction Hessian of the lagged collisions
+		void init_hessian_pattern();
+
 		/// Reference to the collision mesh
 		const ipc::CollisionMesh &collision_mesh_;
 
@@ -105,6 +108,13 @@ namespace polyfem::solver
 
 		ipc::FrictionCollisions friction_collision_set_; ///< Lagged friction constraint set
 
+		/// Sparsity pattern of the friction Hessian (on the collision mesh) of the lagged collisions, only the values change between lagging updates
+		std::vector<StiffnessMatrix::StorageIndex> hessian_outer_index_, hessian_inner_index_;
+		/// For every collision, the position in the pattern of the entries of its local Hessian
+		std::vector<int> hessian_slots_;
+		/// Start of the slots of every collision in hessian_slots_
+		std::vector<int> hessian_slots_offsets_;
+
 		const ContactForm &contact_form_; ///< necessary to have the barrier stiffnes, maybe clean me
 
 		const ipc::FrictionPotential friction_potential_;
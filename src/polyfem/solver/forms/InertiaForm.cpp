@@ -9,6 +9,8 @@
 #include <polyfem/assembler/Mass.hpp>
 #include <polyfem/assembler/AssemblyValsCache.hpp>
 
+#include <polyfem/solver/AdjointTools.hpp>
+
 namespace polyfem::solver
 {
 	namespace
@@ -19,7 +21,6 @@ namespace polyfem::solver
 		public:
 			Eigen::MatrixXd vec;
 			assembler::ElementAssemblyValues vals;
-			QuadratureVector da;
 
 			LocalThreadVecStorage(const int size)
 			{
@@ -77,34 +78,51 @@ namespace polyfem::solver
 
 		utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
 			LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+			assembler::ElementAssemblyValues gvals;
+			Eigen::MatrixXd density;
 
 			for (int e = start; e < end; ++e)
 			{
 				assembler::ElementAssemblyValues &vals = local_storage.vals;
 				ass_vals_cache.compute(e, is_volume, bases[e], geom_bases[e], vals);
-				assembler::ElementAssemblyValues gvals;
 				gvals.compute(e, is_volume, vals.quadrature.points, geom_bases[e], geom_bases[e]);
 
-				const quadrature::Quadrature &quadrature = vals.quadrature;
-				local_storage.da = vals.det.array() * quadrature.weights.array();
-
-				Eigen::MatrixXd vel, grad_vel, p, grad_p;
-				io::Evaluator::interpolate_at_local_vals(e, dim, dim, vals, adjoint, p, grad_p);
-				io::Evaluator::interpolate_at_local_vals(e, dim, dim, vals, velocity, vel, grad_vel);
-
-				for (int q = 0; q < local_storage.da.size(); ++q)
-				{
-					const double rho = assembler.density()(quadrature.points.row(q), vals.val.row(q), t, e);
-					const double value = rho * dot(p.row(q), vel.row(q)) * local_storage.da(q);
-					for (const auto &v : gvals.basis_values)
-					{
-						local_storage.vec.block(v.global[0].index * dim, 0, dim, 1) += v.grad_t_m.row(q).transpose() * value;
-					}
-				}
+				density.setZero(vals.quadrature.weights.size(), dim * dim);
+				force_shape_derivative_density(is_volume, t, e, vals, assembler, velocity, adjoint, density);
+				AdjointTools::add_shape_derivative_density(gvals, density, local_storage.vec);
 			}
 		});
 
 		for (const LocalThreadVecStorage &local_storage : storage)
 			term += local_storage.vec;
 	}
+
+	void InertiaForm::force_shape_derivative_density(
+		bool is_volume,
+		const double t,
+		const int e,
+		const assembler::ElementAssemblyValues &vals,
+		const assembler::Mass &assembler,
+		const Eigen::MatrixXd &velocity,
+		const Eigen::MatrixXd &adjoint,
+		Eigen::MatrixXd &density)
+	{
+		const int dim = is_volume ? 3 : 2;
+
+		const quadrature::Quadrature &quadrature = vals.quadrature;
+		const QuadratureVector da = vals.det.array() * quadrature.weights.array();
+
+		Eigen::MatrixXd vel, grad_vel, p, grad_p;
+		io::Evaluator::interpolate_at_local_vals(e, dim, dim, vals, adjoint, p, grad_p);
+		io::Evaluator::interpolate_at_local_vals(e, dim, dim, vals, velocity, vel, grad_vel);
+
+		// the integrand only scales with the volume change, i.e., it is value * div(v)
+		for (int q = 0; q < da.size(); ++q)
+		{
+			const double rho = assembler.density()(quadrature.points.row(q), vals.val.row(q), t, e);
+			const double value = rho * dot(p.row(q), vel.row(q)) * da(q);
+			for (int d = 0; d < dim; ++d)
+				density(q, d * dim + d) += value;
+		}
+	}
 } // namespace polyfem::solver
@@ -11,6 +11,7 @@ namespace polyfem
 	{
 		class Mass;
 		class AssemblyValsCache;
+		class ElementAssemblyValues;
 	} // namespace assembler
 
 	namespace basis
@@ -45,6 +46,20 @@ namespace polyfem::solver
 			const Eigen::MatrixXd &adjoint,
 			Eigen::VectorXd &term);
 
+		/// @brief Adds the integrand of force_shape_derivative on one element to density, see AdjointTools::add_shape_derivative_density
+		/// @param[in] e Element index
+		/// @param[in] vals Assembly values of the element, with the quadrature of the mass
+		/// @param[in,out] density #quadrature points x dim^2 shape derivative density, weighted by the quadrature
+		static void force_shape_derivative_density(
+			bool is_volume,
+			const double t,
+			const int e,
+			const assembler::ElementAssemblyValues &vals,
+			const assembler::Mass &assembler,
+			const Eigen::MatrixXd &velocity,
+			const Eigen::MatrixXd &adjoint,
+			Eigen::MatrixXd &density);
+
 	protected:
 		/// @brief Compute the value of the form
 		/// @param x Current solution
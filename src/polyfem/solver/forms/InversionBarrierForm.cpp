@@ -9,12 +9,90 @@
 #include <ipc/utils/local_to_global.hpp>
 #include <ipc/utils/eigen_ext.hpp>
 
+#include <igl/predicates/predicates.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+
 namespace polyfem::solver
 {
+	namespace
+	{
+		/// position of vertex v displaced by x, without temporaries
+		template <int DIM>
+		Eigen::Matrix<double, DIM, 1> vertex(const Eigen::MatrixXd &rest_positions, const Eigen::VectorXd &x, const int v)
+		{
+			return rest_positions.row(v).head<DIM>().transpose() + x.segment<DIM>(v * DIM);
+		}
+
+		double cross2(const Eigen::Vector2d &a, const Eigen::Vector2d &b)
+		{
+			return a.x() * b.y() - a.y() * b.x();
+		}
+
+		double det3(const Eigen::Vector3d &a, const Eigen::Vector3d &b, const Eigen::Vector3d &c)
+		{
+			return a.cross(b).dot(c);
+		}
+
+		/// @brief Smallest t in (0, 1] with c[0] + c[1] t + c[2] t^2 + c[3] t^3 <= 0, assuming c[0] > 0
+		/// @return A step slightly before the root (the polynomial is still positive there), or 1 if there is no root
+		double first_nonpositive_root(const std::array<double, 4> &c)
+		{
+			const auto p = [&](const double t) { return c[0] + t * (c[1] + t * (c[2] + t * c[3])); };
+
+			// the polynomial is monotone between the roots of its derivative
+			std::array<double, 4> breaks = {{0, 1, 1, 1}};
+			int n_breaks = 1;
+			const double a = 3 * c[3], b = 2 * c[2];
+			if (a != 0)
+			{
+				const double disc = b * b - 4 * a * c[1];
+				if (disc >= 0)
+				{
+					const double q = -0.5 * (b + std::copysign(std::sqrt(disc), b));
+					for (const double r : {q / a, q != 0 ? c[1] / q : 0.0})
+						if (r > 0 && r < 1)
+							breaks[n_breaks++] = r;
+				}
+			}
+			else if (b != 0)
+			{
+				const double r = -c[1] / b;
+				if (r > 0 && r < 1)
+					breaks[n_breaks++] = r;
+			}
+			std::sort(breaks.begin() + 1, breaks.begin() + n_breaks);
+			breaks[n_breaks++] = 1;
+
+			for (int i = 1; i < n_breaks; ++i)
+			{
+				if (p(breaks[i]) > 0)
+					continue;
+
+				// p(lo) > 0 >= p(hi) and p is monotone on [lo, hi]
+				double lo = breaks[i - 1], hi = breaks[i];
+				for (int it = 0; it < 64 && hi - lo > 1e-12 * hi; ++it)
+				{
+					const double mid = 0.5 * (lo + hi);
+					(p(mid) > 0 ? lo : hi) = mid;
+				}
+				return lo;
+			}
+
+			return 1;
+		}
+	} // namespace
+
 	InversionBarrierForm::InversionBarrierForm(
 		const Eigen::MatrixXd &rest_positions, const Eigen::MatrixXi &elements, const int dim, const double vhat)
 		: rest_positions_(rest_positions), elements_(elements), dim_(dim), vhat_(vhat)
 	{
+		rest_volumes_.resize(elements_.rows());
+		for (int i = 0; i < elements_.rows(); ++i)
+			rest_volumes_[i] = element_volume(rest_positions_(elements_.row(i), Eigen::all));
 	}
 
 	double InversionBarrierForm::value_unweighted(const Eigen::VectorXd &x) const
@@ -30,7 +108,7 @@ namespace polyfem::solver
 			for (int i = start; i < end; i++)
 			{
 				local_potential +=
-					scale * element_volume(rest_positions_(elements_.row(i), Eigen::all))
+					scale * rest_volumes_[i]
 					* ipc::barrier(element_volume(V(elements_.row(i), Eigen::all)), vhat_);
 			}
 		});
@@ -56,7 +134,7 @@ namespace polyfem::solver
 				const Eigen::MatrixXd element_vertices = V(elements_.row(i), Eigen::all);
 
 				Eigen::VectorXd local_grad =
-					(scale * element_volume(rest_positions_(elements_.row(i), Eigen::all))
+					(scale * rest_volumes_[i]
 					 * ipc::barrier_first_derivative(element_volume(element_vertices), vhat_))
 					* element_volume_gradient(element_vertices);
 
@@ -88,7 +166,7 @@ namespace polyfem::solver
 				const double volume = element_volume(element_vertices);
 				const Eigen::VectorXd volume_grad = element_volume_gradient(element_vertices);
 
-				const double rest_volume = element_volume(rest_positions_(elements_.row(i), Eigen::all));
+				const double rest_volume = rest_volumes_[i];
 
 				Eigen::MatrixXd local_hess =
 					(scale * rest_volume * ipc::barrier_second_derivative(volume, vhat_)) * volume_grad * volume_grad.transpose()
@@ -172,17 +250,111 @@ namespace polyfem::solver
 
 	bool InversionBarrierForm::is_step_valid(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const
 	{
-		const Eigen::MatrixXd V = rest_positions_ + utils::unflatten(x1, dim_);
+		igl::predicates::exactinit();
 
-		for (size_t i = 0; i < elements_.rows(); ++i)
-		{
-			// TODO: use exact predicate for this
-			if (element_volume(V(elements_.row(i), Eigen::all)) <= 0)
+		if (dim_ == 2)
+			return is_step_valid_impl<2>(x1);
+		assert(dim_ == 3);
+		return is_step_valid_impl<3>(x1);
+	}
+
+	template <int DIM>
+	bool InversionBarrierForm::is_step_valid_impl(const Eigen::VectorXd &x1) const
+	{
+		std::atomic<bool> valid(true);
+
+		utils::maybe_parallel_for(elements_.rows(), [&](int start, int end, int thread_id) {
+			for (int i = start; i < end && valid.load(std::memory_order_relaxed); ++i)
 			{
-				return false;
+				bool inverted;
+				if constexpr (DIM == 2)
+				{
+					// the element is inverted if it is not positive (i.e., it is negative or degenerate)
+					inverted = igl::predicates::orient2d(
+								   vertex<2>(rest_positions_, x1, elements_(i, 0)),
+								   vertex<2>(rest_positions_, x1, elements_(i, 1)),
+								   vertex<2>(rest_positions_, x1, elements_(i, 2)))
+							   != igl::predicates::Orientation::POSITIVE;
+				}
+				else
+				{
+					// orient3d is negative for tets of positive volume
+					inverted = igl::predicates::orient3d(
+								   vertex<3>(rest_positions_, x1, elements_(i, 0)),
+								   vertex<3>(rest_positions_, x1, elements_(i, 1)),
+								   vertex<3>(rest_positions_, x1, elements_(i, 2)),
+								   vertex<3>(rest_positions_, x1, elements_(i, 3)))
+							   != igl::predicates::Orientation::NEGATIVE;
+				}
+
+				if (inverted)
+					valid.store(false, std::memory_order_relaxed);
 			}
-		}
+		});
+
+		return valid;
+	}
+
+	double InversionBarrierForm::max_step_size(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const
+	{
+		if (dim_ == 2)
+			return max_step_size_impl<2>(x0, x1);
+		assert(dim_ == 3);
+		return max_step_size_impl<3>(x0, x1);
+	}
+
+	template <int DIM>
+	double InversionBarrierForm::max_step_size_impl(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const
+	{
+		using Vector = Eigen::Matrix<double, DIM, 1>;
+
+		const Eigen::VectorXd dx = x1 - x0;
+
+		auto storage = utils::create_thread_storage<double>(1.0);
+
+		utils::maybe_parallel_for(elements_.rows(), [&](int start, int end, int thread_id) {
+			double &local_step = utils::get_local_thread_storage(storage, thread_id);
+			for (int i = start; i < end; ++i)
+			{
+				// edges of the element along x0 + t (x1 - x0), its volume is a polynomial in t
+				const Vector v0 = vertex<DIM>(rest_positions_, x0, elements_(i, 0));
+				const Vector d0 = dx.segment<DIM>(elements_(i, 0) * DIM);
+				std::array<Vector, DIM> e, d;
+				for (int k = 0; k < DIM; ++k)
+				{
+					e[k] = vertex<DIM>(rest_positions_, x0, elements_(i, k + 1)) - v0;
+					d[k] = dx.segment<DIM>(elements_(i, k + 1) * DIM) - d0;
+				}
+
+				std::array<double, 4> c;
+				if constexpr (DIM == 2)
+				{
+					c = {{cross2(e[0], e[1]),
+						  cross2(e[0], d[1]) + cross2(d[0], e[1]),
+						  cross2(d[0], d[1]),
+						  0}};
+				}
+				else
+				{
+					c = {{det3(e[0], e[1], e[2]),
+						  det3(d[0], e[1], e[2]) + det3(e[0], d[1], e[2]) + det3(e[0], e[1], d[2]),
+						  det3(e[0], d[1], d[2]) + det3(d[0], e[1], d[2]) + det3(d[0], d[1], e[2]),
+						  det3(d[0], d[1], d[2])}};
+				}
+
+				// already inverted, nothing a step size can fix
+				if (c[0] <= 0)
+					continue;
+
+				local_step = std::min(local_step, first_nonpositive_root(c));
+			}
+		});
+
+		double step = 1;
+		for (const double local_step : storage)
+			step = std::min(step, local_step);
 
-		return true;
+		// stay away from the root as the barrier is infinite there (same as the CCD of the contact form)
+		return step < 1 ? 0.8 * step : step;
 	}
 } // namespace polyfem::solver
@@ -38,15 +38,29 @@ namespace polyfem::solver
 		/// @return True if the step is allowed
 		bool is_step_valid(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const override;
 
+		/// @brief Determine the maximum step size allowable between the current and next solution
+		/// @param x0 Current solution (step size = 0)
+		/// @param x1 Next solution (step size = 1)
+		/// @return Maximum allowable step size before an element inverts
+		double max_step_size(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const override;
+
 	protected:
 		static double element_volume(const Eigen::MatrixXd &element_vertices);
 		static Eigen::VectorXd element_volume_gradient(const Eigen::MatrixXd &element_vertices);
 		static Eigen::MatrixXd element_volume_hessian(const Eigen::MatrixXd &element_vertices);
 
 	private:
+		template <int DIM>
+		bool is_step_valid_impl(const Eigen::VectorXd &x1) const;
+		template <int DIM>
+		double max_step_size_impl(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const;
+
 		Eigen::MatrixXd rest_positions_;
 		Eigen::MatrixXi elements_;
 		int dim_;
 		double vhat_;
+
+		/// volume of the elements at rest, precomputed since it does not depend on x
+		Eigen::VectorXd rest_volumes_;
 	};
 } // namespace polyfem::solver
\ No newline at end of file
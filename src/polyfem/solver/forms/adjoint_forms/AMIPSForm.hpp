@@ -14,19 +14,15 @@ namespace polyfem::solver
 {
 	namespace
 	{
-		double triangle_jacobian(const Eigen::VectorXd &v1, const Eigen::VectorXd &v2, const Eigen::VectorXd &v3)
+		double triangle_jacobian(const Eigen::Vector2d &v1, const Eigen::Vector2d &v2, const Eigen::Vector2d &v3)
 		{
-			Eigen::VectorXd a = v2 - v1, b = v3 - v1;
+			const Eigen::Vector2d a = v2 - v1, b = v3 - v1;
 			return a(0) * b(1) - b(0) * a(1);
 		}
 
-		double tet_determinant(const Eigen::VectorXd &v1, const Eigen::VectorXd &v2, const Eigen::VectorXd &v3, const Eigen::VectorXd &v4)
+		double tet_determinant(const Eigen::Vector3d &v1, const Eigen::Vector3d &v2, const Eigen::Vector3d &v3, const Eigen::Vector3d &v4)
 		{
-			Eigen::Matrix3d mat;
-			mat.col(0) << v2 - v1;
-			mat.col(1) << v3 - v1;
-			mat.col(2) << v4 - v1;
-			return mat.determinant();
+			return (v2 - v1).cross(v3 - v1).dot(v4 - v1);
 		}
 
 		void scaled_jacobian(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F, Eigen::VectorXd &quality)
@@ -94,13 +90,13 @@ namespace polyfem::solver
 			if (F.cols() == 3)
 			{
 				for (int i = 0; i < F.rows(); i++)
-					if (triangle_jacobian(V.row(F(i, 0)), V.row(F(i, 1)), V.row(F(i, 2))) <= 0)
+					if (triangle_jacobian(V.row(F(i, 0)).head<2>(), V.row(F(i, 1)).head<2>(), V.row(F(i, 2)).head<2>()) <= 0)
 						return true;
 			}
 			else if (F.cols() == 4)
 			{
 				for (int i = 0; i < F.rows(); i++)
-					if (tet_determinant(V.row(F(i, 0)), V.row(F(i, 1)), V.row(F(i, 2)), V.row(F(i, 3))) <= 0)
+					if (tet_determinant(V.row(F(i, 0)).head<3>(), V.row(F(i, 1)).head<3>(), V.row(F(i, 2)).head<3>(), V.row(F(i, 3)).head<3>()) <= 0)
 						return true;
 			}
 			else
@@ -13,6 +13,7 @@
 #include <polyfem/utils/par_for.hpp>
 
 #include <polyfem/utils/JSONUtils.hpp>
+#include <polyfem/utils/Profiler.hpp>
 
 #include <jse/jse.h>
 
@@ -55,6 +56,40 @@ namespace polyfem
 	using namespace problem;
 	using namespace utils;
 
+	namespace
+	{
+		/// rules of the input spec, with the includes resolved and the default linear solvers.
+		/// They are loaded once per process, creating many states (e.g., for optimization) only validates the inputs.
+		const json &input_rules()
+		{
+			static const json rules = []() {
+				json rules;
+				const std::string polyfem_input_spec = POLYFEM_INPUT_SPEC;
+				std::ifstream file(polyfem_input_spec);
+
+				if (file.is_open())
+					file >> rules;
+				else
+				{
+					logger().error("unable to open {} rules", polyfem_input_spec);
+					throw std::runtime_error("Invald spec file");
+				}
+
+				jse::JSE jse;
+				jse.include_directories.push_back(POLYFEM_JSON_SPEC_DIR);
+				jse.include_directories.push_back(POLYSOLVE_JSON_SPEC_DIR);
+				rules = jse.inject_include(rules);
+
+				polysolve::linear::Solver::apply_default_solver(rules, "/solver/linear");
+				polysolve::linear::Solver::apply_default_solver(rules, "/solver/adjoint_linear");
+
+				return rules;
+			}();
+
+			return rules;
+		}
+	} // namespace
+
 	State::State()
 	{
 		using namespace polysolve;
@@ -143,28 +178,9 @@ namespace polyfem
 		apply_common_params(args_in);
 
 		// CHECK validity json
-		json rules;
+		const json &rules = input_rules();
 		jse::JSE jse;
-		{
-			jse.strict = strict_validation;
-			const std::string polyfem_input_spec = POLYFEM_INPUT_SPEC;
-			std::ifstream file(polyfem_input_spec);
-
-			if (file.is_open())
-				file >> rules;
-			else
-			{
-				logger().error("unable to open {} rules", polyfem_input_spec);
-				throw std::runtime_error("Invald spec file");
-			}
-
-			jse.include_directories.push_back(POLYFEM_JSON_SPEC_DIR);
-			jse.include_directories.push_back(POLYSOLVE_JSON_SPEC_DIR);
-			rules = jse.inject_include(rules);
-
-			polysolve::linear::Solver::apply_default_solver(rules, "/solver/linear");
-			polysolve::linear::Solver::apply_default_solver(rules, "/solver/adjoint_linear");
-		}
+		jse.strict = strict_validation;
 
 		polysolve::linear::Solver::select_valid_solver(args_in["solver"]["linear"], logger());
 		if (args_in["solver"]["adjoint_linear"].is_null())
@@ -190,6 +206,13 @@ namespace polyfem
 		this->args = jse.inject_defaults(args_in, rules);
 		units.init(this->args["units"]);
 
+		// a checkpoint stores the time integrator history like a state, in PolyFEM ordering
+		if (!this->args["input"]["data"]["checkpoint"].get<std::string>().empty())
+		{
+			this->args["input"]["data"]["state"] = this->args["input"]["data"]["checkpoint"];
+			this->args["input"]["data"]["reorder"] = false;
+		}
+
 		// Save output directory and resolve output paths dynamically
 		const std::string output_dir = resolve_input_path(this->args["output"]["directory"]);
 		if (!output_dir.empty())
@@ -215,6 +238,14 @@ namespace polyfem
 		const unsigned int thread_in = this->args["solver"]["max_threads"];
 		set_max_threads(thread_in);
 
+		if (this->args["output"]["advanced"]["profile"])
+		{
+			// the profiler is global, states never disable it
+			utils::Profiler::instance().set_enabled(true);
+			if (!this->args["output"]["advanced"]["profile_trace"].get<std::string>().empty())
+				utils::Profiler::instance().set_trace_enabled(true);
+		}
+
 		has_dhat = args_in["contact"].contains("dhat");
 
 		init_time();
@@ -294,6 +325,12 @@ namespace polyfem
 
 		problem->set_units(*assembler, units);
 
+		// Load cases reuse the factorization of a single static linear solve
+		if (!args["load_cases"].empty()
+			&& (problem->is_time_dependent() || !assembler->is_linear() || assembler->name() == "NavierStokes"
+				|| is_contact_enabled() || mixed_assembler != nullptr || args.contains("preset_problem")))
+			log_and_throw_error("Load cases are only supported for static linear problems with boundary_conditions");
+
 		if (optimization_enabled == solver::CacheLevel::Derivatives)
 		{
 			if (is_contact_enabled())
@@ -80,7 +80,7 @@ namespace polyfem
 			args["geometry"],
 			utils::json_as_array(args["boundary_conditions"]["obstacle_displacements"]),
 			utils::json_as_array(args["boundary_conditions"]["dirichlet_boundary"]),
-			args["root_path"], mesh->dimension());
+			args["root_path"], output_dir, mesh->dimension());
 
 		timer.stop();
 		logger().info(" took {}s", timer.getElapsedTime());
@@ -150,7 +150,7 @@ namespace polyfem
 			args["geometry"],
 			utils::json_as_array(args["boundary_conditions"]["obstacle_displacements"]),
 			utils::json_as_array(args["boundary_conditions"]["dirichlet_boundary"]),
-			args["root_path"], mesh->dimension(), names, vertices, cells);
+			args["root_path"], output_dir, mesh->dimension(), names, vertices, cells);
 		timer.stop();
 		logger().info(" took {}s", timer.getElapsedTime());
 	}
@@ -1,8 +1,14 @@
 #include <polyfem/State.hpp>
 
+#include <polyfem/io/MatrixIO.hpp>
+#include <polyfem/solver/forms/ContactForm.hpp>
+#include <polyfem/time_integrator/ImplicitTimeIntegrator.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
+#include <polyfem/utils/Profiler.hpp>
 #include <polyfem/utils/Timer.hpp>
 
+#include <h5pp/h5pp.h>
+
 #include <filesystem>
 
 namespace polyfem
@@ -104,6 +110,8 @@ namespace polyfem
 						sol, *mesh, disc_orders, *problem, timings,
 						assembler->name(), iso_parametric(), args["output"]["advanced"]["sol_at_node"],
 						j);
+		if (utils::Profiler::is_enabled())
+			j["profile"] = utils::Profiler::instance().summary();
 		out << j.dump(4) << std::endl;
 	}
 
@@ -162,25 +170,28 @@ namespace polyfem
 		if (!args["time"].is_null())
 			dt = args["time"]["dt"];
 
-		out_geom.export_data(
-			*this, sol, pressure,
-			!args["time"].is_null(),
-			tend, dt,
-			io::OutGeometryData::ExportOptions(args, mesh->is_linear(), problem->is_scalar(), solve_export_to_file),
-			vis_mesh_path,
-			nodes_path,
-			solution_path,
-			stress_path,
-			mises_path,
-			is_contact_enabled(), solution_frames);
+		{
+			POLYFEM_PROFILE_SCOPE("Exporting data");
+			out_geom.export_data(
+				*this, sol, pressure,
+				!args["time"].is_null(),
+				tend, dt,
+				io::OutGeometryData::ExportOptions(args, mesh->is_linear(), problem->is_scalar(), solve_export_to_file),
+				vis_mesh_path,
+				nodes_path,
+				solution_path,
+				stress_path,
+				mises_path,
+				is_contact_enabled(), solution_frames);
+		}
+
+		const std::string trace_path = resolve_output_path(args["output"]["advanced"]["profile_trace"]);
+		if (!trace_path.empty() && utils::Profiler::instance().is_trace_enabled())
+			utils::Profiler::instance().save_trace(trace_path);
 	}
 
-	void State::save_restart_json(const double t0, const double dt, const int t) const
+	json State::restart_json(const double t0, const double dt, const int t) const
 	{
-		const std::string restart_json_path = args["output"]["restart_json"];
-		if (restart_json_path.empty())
-			return;
-
 		json restart_json;
 		restart_json["root_path"] = root_path();
 		restart_json["common"] = root_path();
@@ -260,7 +271,47 @@ namespace polyfem
 			},
 		}};
 
+		return restart_json;
+	}
+
+	void State::save_restart_json(const double t0, const double dt, const int t) const
+	{
+		const std::string restart_json_path = args["output"]["restart_json"];
+		if (restart_json_path.empty())
+			return;
+
 		std::ofstream file(resolve_output_path(fmt::format(restart_json_path, t)));
-		file << restart_json;
+		file << restart_json(t0, dt, t);
+	}
+
+	void State::save_checkpoint(const time_integrator::ImplicitTimeIntegrator &time_integrator, const double t0, const double dt, const int t) const
+	{
+		const std::string checkpoint_path = resolve_output_path(fmt::format(args["output"]["data"]["checkpoint"], t));
+		if (checkpoint_path.empty())
+			return;
+
+		POLYFEM_PROFILE_SCOPE("Saving checkpoint");
+
+		// u, v, and a, (re)creates the file
+		time_integrator.save_state(checkpoint_path);
+
+		json restart = restart_json(t0, dt, t);
+		restart["input"] = {{"data", {{"checkpoint", checkpoint_path}}}};
+
+		{
+			h5pp::File file(checkpoint_path, h5pp::FileAccess::READWRITE);
+			file.writeDataset(restart.dump(), "json");
+			file.writeDataset(t, "t");
+
+			// the restart checks that it rebuilds the same discretization
+			file.writeDataset(n_bases, "n_bases");
+			file.writeDataset(in_node_to_node, "in_node_to_node");
+
+			if (solve_data.contact_form != nullptr)
+				file.writeDataset(solve_data.contact_form->barrier_stiffness(), "barrier_stiffness");
+		}
+
+		if (args["output"]["data"]["advanced"]["checkpoint_mass"] && mass.size() > 0)
+			io::write_sparse_matrix(checkpoint_path, "mass", mass, /*replace=*/false);
 	}
 } // namespace polyfem
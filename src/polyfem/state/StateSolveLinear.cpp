@@ -2,6 +2,7 @@
 
 #include <polyfem/assembler/Mass.hpp>
 #include <polyfem/assembler/AssemblerUtils.hpp>
+#include <polyfem/assembler/GenericProblem.hpp>
 
 #include <polyfem/time_integrator/ImplicitTimeIntegrator.hpp>
 #include <polyfem/time_integrator/BDF.hpp>
@@ -11,6 +12,7 @@
 #include <polyfem/solver/forms/InertiaForm.hpp>
 #include <polysolve/linear/FEMSolver.hpp>
 
+#include <polyfem/utils/MaybeParallelFor.hpp>
 #include <polyfem/utils/Timer.hpp>
 
 #include <unsupported/Eigen/SparseExtra>
@@ -25,6 +27,7 @@ namespace polyfem
 
 	void State::build_stiffness_mat(StiffnessMatrix &stiffness)
 	{
+		POLYFEM_PROFILE_SCOPE("Assembling stiffness mat");
 		igl::Timer timer;
 		timer.start();
 		logger().info("Assembling stiffness mat...");
@@ -75,11 +78,13 @@ namespace polyfem
 		assert(assembler->is_linear() && !is_contact_enabled());
 		assert(solve_data.rhs_assembler != nullptr);
 
+		POLYFEM_PROFILE_SCOPE("Linear solve");
+
 		const int problem_dim = problem->is_scalar() ? 1 : mesh->dimension();
 		const int precond_num = problem_dim * n_bases;
 
 		Eigen::VectorXd x;
-		if (optimization_enabled == solver::CacheLevel::Derivatives)
+		if (optimization_enabled == solver::CacheLevel::Derivatives || !args["load_cases"].empty())
 		{
 			auto A_tmp = A;
 			prefactorize(*solver, A, boundary_nodes, precond_num, args["output"]["data"]["stiffness_mat"]);
@@ -130,9 +135,118 @@ namespace polyfem
 
 		Eigen::VectorXd b = rhs;
 
+		// The load cases reuse the factorization, they need the matrix before the Dirichlet rows are replaced
+		const bool has_load_cases = !args["load_cases"].empty();
+		const StiffnessMatrix A_load_cases = has_load_cases ? A : StiffnessMatrix();
+
 		// --------------------------------------------------------------------
 
 		solve_linear(lin_solver_cached, A, b, args["output"]["advanced"]["spectrum"], sol, pressure);
+
+		if (has_load_cases)
+			solve_load_cases(A_load_cases, A);
+	}
+
+	void State::solve_load_cases(const StiffnessMatrix &A, const StiffnessMatrix &A_factorized)
+	{
+		POLYFEM_PROFILE_SCOPE("Load cases");
+
+		const json &load_cases = args["load_cases"];
+		const int n_cases = load_cases.size();
+
+		// Unsupported problems are rejected in init
+		assert(!problem->is_time_dependent() && mixed_assembler == nullptr);
+		assert(lin_solver_cached != nullptr);
+
+		igl::Timer timer;
+		timer.start();
+		logger().info("Solving {} load cases...", n_cases);
+
+		json p_params = {};
+		p_params["formulation"] = assembler->name();
+		p_params["root_path"] = root_path();
+		{
+			RowVectorNd min, max, delta;
+			mesh->bounding_box(min, max);
+			delta = (max - min) / 2. + min;
+			if (mesh->is_volume())
+				p_params["bbox_center"] = {delta(0), delta(1), delta(2)};
+			else
+				p_params["bbox_center"] = {delta(0), delta(1)};
+		}
+
+		// Set up the problem of every case and check that it constrains the same nodes
+		std::vector<std::shared_ptr<assembler::Problem>> case_problems(n_cases);
+		std::vector<std::vector<LocalBoundary>> case_local_boundaries(n_cases), case_neumann_boundaries(n_cases);
+		for (int c = 0; c < n_cases; ++c)
+		{
+			std::shared_ptr<assembler::Problem> case_problem;
+			if (problem->is_scalar())
+				case_problem = std::make_shared<assembler::GenericScalarProblem>("GenericScalar");
+			else
+				case_problem = std::make_shared<assembler::GenericTensorProblem>("GenericTensor");
+
+			case_problem->clear();
+			json bc = load_cases[c]["boundary_conditions"];
+			bc["root_path"] = root_path();
+			case_problem->set_parameters(bc);
+			case_problem->set_parameters(p_params);
+			case_problem->set_units(*assembler, units);
+
+			if (!setup_problem_bc(*case_problem, case_local_boundaries[c], case_neumann_boundaries[c]))
+				log_and_throw_error("Load case {} constrains different nodes than the main problem, it cannot reuse its factorization", c);
+
+			case_problems[c] = case_problem;
+		}
+
+		// Assemble the right-hand sides
+		std::vector<Eigen::MatrixXd> case_rhs(n_cases);
+		utils::maybe_parallel_for(n_cases, [&](int start, int end, int thread_id) {
+			for (int c = start; c < end; ++c)
+			{
+				const auto rhs_assembler = build_rhs_assembler(n_bases, bases, mass_ass_vals_cache, *case_problems[c]);
+				rhs_assembler->assemble(mass_matrix_assembler->density(), case_rhs[c]);
+				case_rhs[c] *= -1;
+				rhs_assembler->set_bc(
+					case_local_boundaries[c], boundary_nodes, n_boundary_samples(),
+					(assembler->name() != "Bilaplacian") ? case_neumann_boundaries[c] : std::vector<LocalBoundary>(), case_rhs[c]);
+			}
+		});
+
+		// Solve with the factorization of the main problem
+		load_case_sols.resize(A.rows(), n_cases);
+		for (int c = 0; c < n_cases; ++c)
+		{
+			Eigen::VectorXd b = case_rhs[c];
+			Eigen::VectorXd x;
+			dirichlet_solve_prefactorized(*lin_solver_cached, A, b, boundary_nodes, x);
+			load_case_sols.col(c) = x;
+
+			const std::string name = load_cases[c]["name"];
+			const double error = (A_factorized * x - case_rhs[c]).norm();
+			logger().debug("Load case {} '{}' solver error: {}", c, name, error);
+		}
+
+		timer.stop();
+		logger().info(" took {}s", timer.getElapsedTime());
+
+		// Per-case output
+		for (int c = 0; c < n_cases; ++c)
+		{
+			const std::string vis_mesh_path = resolve_output_path(load_cases[c]["paraview"]);
+			const std::string solution_path = resolve_output_path(load_cases[c]["solution"]);
+			if (vis_mesh_path.empty() && solution_path.empty())
+				continue;
+
+			POLYFEM_PROFILE_SCOPE("Exporting data");
+			std::vector<io::SolutionFrame> frames;
+			out_geom.export_data(
+				*this, load_case_sols.col(c), Eigen::MatrixXd(),
+				/*is_time_dependent=*/false, /*tend=*/1, /*dt=*/1,
+				io::OutGeometryData::ExportOptions(args, mesh->is_linear(), problem->is_scalar(), true),
+				vis_mesh_path, "", solution_path, "", "",
+				is_contact_enabled(), frames);
+		}
 	}
 
 	void State::init_linear_solve(Eigen::MatrixXd &sol, const double t)
@@ -316,6 +430,7 @@ namespace polyfem
 			time_integrator->update_quantities(sol);
 
 			save_timestep(time, t, t0, dt, sol, pressure);
+			save_checkpoint(*time_integrator, t0, dt, t);
 			logger().info("{}/{}  t={}", t, time_steps, time);
 		}
 
@@ -23,6 +23,8 @@
 
 #include <ipc/ipc.hpp>
 
+#include <h5pp/h5pp.h>
+
 namespace polyfem
 {
 	using namespace mesh;
@@ -64,6 +66,7 @@ namespace polyfem
 			double forward_solve_time = 0, remeshing_time = 0, global_relaxation_time = 0;
 
 			{
+				POLYFEM_PROFILE_SCOPE("Forward solve");
 				POLYFEM_SCOPED_TIMER(forward_solve_time);
 				solve_tensor_nonlinear(sol, t);
 			}
@@ -77,6 +80,7 @@ namespace polyfem
 
 				bool remesh_success;
 				{
+					POLYFEM_PROFILE_SCOPE("Remeshing");
 					POLYFEM_SCOPED_TIMER(remeshing_time);
 					remesh_success = this->remesh(t0 + dt * t, dt, sol);
 				}
@@ -89,6 +93,7 @@ namespace polyfem
 				// Only do global relaxation if remeshing was successful
 				if (remesh_success)
 				{
+					POLYFEM_PROFILE_SCOPE("Global relaxation");
 					POLYFEM_SCOPED_TIMER(global_relaxation_time);
 					solve_tensor_nonlinear(sol, t, false); // solve the scene again after remeshing
 				}
@@ -134,6 +139,7 @@ namespace polyfem
 
 			// save restart file
 			save_restart_json(t0, dt, t);
+			save_checkpoint(*solve_data.time_integrator, t0, dt, t);
 			stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, sol);
 		}
 	}
@@ -253,7 +259,21 @@ namespace polyfem
 			form->set_output_dir(output_dir);
 
 		if (solve_data.contact_form != nullptr)
+		{
 			solve_data.contact_form->save_ccd_debug_meshes = args["output"]["advanced"]["save_ccd_debug_meshes"];
+			solve_data.contact_form->set_candidate_skin(
+				args["solver"]["contact"]["CCD"]["candidate_skin"].get<double>() * solve_data.contact_form->dhat());
+		}
+
+		// Restore the adaptive barrier stiffness of the checkpoint
+		const std::string checkpoint_path = resolve_input_path(args["input"]["data"]["checkpoint"]);
+		if (init_time_integrator && !checkpoint_path.empty()
+			&& solve_data.contact_form != nullptr && solve_data.contact_form->use_adaptive_barrier_stiffness())
+		{
+			h5pp::File file(checkpoint_path, h5pp::FileAccess::READONLY);
+			if (file.linkExists("barrier_stiffness"))
+				solve_data.contact_form->set_barrier_stiffness(file.readDataset<double>("barrier_stiffness"));
+		}
 
 		// --------------------------------------------------------------------
 		// Initialize nonlinear problems
@@ -295,6 +315,7 @@ namespace polyfem
 
 		// ---------------------------------------------------------------------
 
+		POLYFEM_PROFILE_SCOPE("Nonlinear solve");
 		std::shared_ptr<polysolve::nonlinear::Solver> nl_solver = make_nl_solver(true);
 
 		ALSolver al_solver(
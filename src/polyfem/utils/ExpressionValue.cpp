@@ -42,6 +42,27 @@ namespace polyfem
 			return (0 < x) - (x < 0);
 		}
 
+		/// compiles expr with the variables x, y, z, and t bound to the given references
+		static te_expr *compile(const std::string &expr, double &x, double &y, double &z, double &t, int &err)
+		{
+			const std::vector<te_variable> vars = {
+				{"x", &x, TE_VARIABLE},
+				{"y", &y, TE_VARIABLE},
+				{"z", &z, TE_VARIABLE},
+				{"t", &t, TE_VARIABLE},
+				{"min", (const void *)min, TE_FUNCTION2},
+				{"max", (const void *)max, TE_FUNCTION2},
+				{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
+				{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
+				{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
+				{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
+				{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
+				{"sign", (const void *)sign, TE_FUNCTION1},
+			};
+
+			return te_compile(expr.c_str(), vars.data(), vars.size(), &err);
+		}
+
 		ExpressionValue::ExpressionValue()
 		{
 			clear();
@@ -91,23 +112,8 @@ namespace polyfem
 
 			double x = 0, y = 0, z = 0, t = 0;
 
-			std::vector<te_variable> vars = {
-				{"x", &x, TE_VARIABLE},
-				{"y", &y, TE_VARIABLE},
-				{"z", &z, TE_VARIABLE},
-				{"t", &t, TE_VARIABLE},
-				{"min", (const void *)min, TE_FUNCTION2},
-				{"max", (const void *)max, TE_FUNCTION2},
-				{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
-				{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
-				{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
-				{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
-				{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
-				{"sign", (const void *)sign, TE_FUNCTION1},
-			};
-
 			int err;
-			te_expr *tmp = te_compile(expr.c_str(), vars.data(), vars.size(), &err);
+			te_expr *tmp = compile(expr, x, y, z, t, err);
 			if (!tmp)
 			{
 				logger().error("Unable to parse: {}", expr);
@@ -200,23 +206,8 @@ namespace polyfem
 			else
 			{
 
-				std::vector<te_variable> vars = {
-					{"x", &x, TE_VARIABLE},
-					{"y", &y, TE_VARIABLE},
-					{"z", &z, TE_VARIABLE},
-					{"t", &t, TE_VARIABLE},
-					{"min", (const void *)min, TE_FUNCTION2},
-					{"max", (const void *)max, TE_FUNCTION2},
-					{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
-					{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
-					{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
-					{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
-					{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
-					{"sign", (const void *)sign, TE_FUNCTION1},
-				};
-
 				int err;
-				te_expr *tmp = te_compile(expr_.c_str(), vars.data(), vars.size(), &err);
+				te_expr *tmp = compile(expr_, x, y, z, t, err);
 				assert(tmp != nullptr);
 				result = te_eval(tmp);
 				te_free(tmp);
@@ -232,5 +223,51 @@ namespace polyfem
 
 			return result;
 		}
+
+		void ExpressionValue::eval(const Eigen::MatrixXd &pts, const double t, const int index, Eigen::VectorXd &val) const
+		{
+			assert(unit_type_set_);
+			assert(pts.cols() == 2 || pts.cols() == 3);
+
+			const bool planar = pts.cols() == 2;
+			val.resize(pts.rows());
+
+			if (!expr_.empty())
+			{
+				double x = 0, y = 0, z = 0, tt = t;
+				int err;
+				te_expr *tmp = compile(expr_, x, y, z, tt, err);
+				assert(tmp != nullptr);
+				for (int i = 0; i < pts.rows(); ++i)
+				{
+					x = pts(i, 0);
+					y = pts(i, 1);
+					z = planar ? 0 : pts(i, 2);
+					val(i) = te_eval(tmp);
+				}
+				te_free(tmp);
+			}
+			else if (mat_.size() > 0)
+				val.setConstant(mat_(index));
+			else if (sfunc_ || tfunc_)
+			{
+				for (int i = 0; i < pts.rows(); ++i)
+				{
+					const double z = planar ? 0 : pts(i, 2);
+					val(i) = sfunc_ ? sfunc_(pts(i, 0), pts(i, 1), z, t, index) : tfunc_(pts(i, 0), pts(i, 1), z, t)(tfunc_coo_);
+				}
+			}
+			else
+				val.setConstant(value_);
+
+			if (!unit_.base_units().empty())
+			{
+				if (!unit_.is_convertible(unit_type_))
+					log_and_throw_error(fmt::format("Cannot convert {} to {}", units::to_string(unit_), units::to_string(unit_type_)));
+
+				for (int i = 0; i < val.size(); ++i)
+					val(i) = units::convert(val(i), unit_, unit_type_);
+			}
+		}
 	} // namespace utils
 } // namespace polyfem
@@ -33,6 +33,13 @@ namespace polyfem
 
 			double operator()(double x, double y, double z = 0, double t = 0, int index = -1) const;
 
+			/// @brief evaluates the value at all points, expressions are compiled once for all of them
+			/// @param[in] pts #pts x 2 or 3 points
+			/// @param[in] t time
+			/// @param[in] index index passed to the functions (e.g., element or vertex id), the same for all points
+			/// @param[out] val #pts values
+			void eval(const Eigen::MatrixXd &pts, const double t, const int index, Eigen::VectorXd &val) const;
+
 			void clear();
 
 			bool is_zero() const { return expr_.empty() && fabs(value_) < 1e-10; }
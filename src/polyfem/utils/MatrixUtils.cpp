@@ -3,6 +3,7 @@
 #include <polyfem/utils/Logger.hpp>
 #include <polyfem/utils/Timer.hpp>
 
+#include <algorithm>
 #include <vector>
 
 void polyfem::utils::show_matrix_stats(const Eigen::MatrixXd &M)
@@ -152,6 +153,122 @@ void polyfem::utils::full_to_reduced_matrix(
 	reduced.makeCompressed();
 }
 
+void polyfem::utils::FullToReducedMatrixMap::apply(
+	const int full_size,
+	const int reduced_size,
+	const std::vector<int> &removed_vars,
+	const StiffnessMatrix &full,
+	StiffnessMatrix &reduced)
+{
+	if (reduced_size == full_size || reduced_size == full.rows() || !full.isCompressed())
+	{
+		full_to_reduced_matrix(full_size, reduced_size, removed_vars, full, reduced);
+		return;
+	}
+
+	POLYFEM_SCOPED_TIMER("full to reduced matrix");
+	assert(full.rows() == full_size && full.cols() == full_size);
+
+	if (!has_pattern(removed_vars, full))
+		build(full_size, reduced_size, removed_vars, full);
+
+	// Reuse the storage of reduced if it already has the pattern
+	const auto same_as_pattern = [&]() {
+		if (reduced.rows() != reduced_pattern_.rows() || reduced.cols() != reduced_pattern_.cols()
+			|| !reduced.isCompressed() || reduced.nonZeros() != reduced_pattern_.nonZeros())
+			return false;
+		const auto n_outer = reduced_pattern_.outerSize() + 1;
+		return std::equal(reduced.outerIndexPtr(), reduced.outerIndexPtr() + n_outer, reduced_pattern_.outerIndexPtr())
+			   && std::equal(reduced.innerIndexPtr(), reduced.innerIndexPtr() + reduced_pattern_.nonZeros(), reduced_pattern_.innerIndexPtr());
+	};
+	if (!same_as_pattern())
+		reduced = reduced_pattern_;
+
+	const double *full_values = full.valuePtr();
+	double *reduced_values = reduced.valuePtr();
+	for (size_t i = 0; i < value_map_.size(); ++i)
+		reduced_values[i] = full_values[value_map_[i]];
+}
+
+void polyfem::utils::FullToReducedMatrixMap::clear()
+{
+	removed_vars_.clear();
+	full_outer_.clear();
+	full_inner_.clear();
+	reduced_pattern_.resize(0, 0);
+	value_map_.clear();
+}
+
+bool polyfem::utils::FullToReducedMatrixMap::has_pattern(const std::vector<int> &removed_vars, const StiffnessMatrix &full) const
+{
+	if (full_outer_.size() != size_t(full.outerSize() + 1) || full_inner_.size() != size_t(full.nonZeros()))
+		return false;
+
+	return removed_vars == removed_vars_
+		   && std::equal(full_outer_.begin(), full_outer_.end(), full.outerIndexPtr())
+		   && std::equal(full_inner_.begin(), full_inner_.end(), full.innerIndexPtr());
+}
+
+void polyfem::utils::FullToReducedMatrixMap::build(
+	const int full_size,
+	const int reduced_size,
+	const std::vector<int> &removed_vars,
+	const StiffnessMatrix &full)
+{
+	assert(full.isCompressed());
+	assert(std::is_sorted(removed_vars.begin(), removed_vars.end()));
+	++n_builds_;
+
+	removed_vars_ = removed_vars;
+	full_outer_.assign(full.outerIndexPtr(), full.outerIndexPtr() + full.outerSize() + 1);
+	full_inner_.assign(full.innerIndexPtr(), full.innerIndexPtr() + full.nonZeros());
+
+	Eigen::VectorXi indices(full_size);
+	int index = 0;
+	size_t kk = 0;
+	for (int i = 0; i < full_size; ++i)
+	{
+		if (kk < removed_vars.size() && removed_vars[kk] == i)
+		{
+			++kk;
+			indices(i) = -1;
+		}
+		else
+		{
+			indices(i) = index++;
+		}
+	}
+	assert(index == reduced_size);
+
+	// Kept rows stay sorted in every kept column, so the reduced matrix is built directly in compressed form
+	std::vector<StiffnessMatrix::StorageIndex> outer(reduced_size + 1, 0);
+	std::vector<StiffnessMatrix::StorageIndex> inner;
+	inner.reserve(full.nonZeros()); // Conservative estimate
+	value_map_.clear();
+	value_map_.reserve(full.nonZeros());
+
+	for (int k = 0; k < full.outerSize(); ++k)
+	{
+		if (indices(k) < 0)
+			continue;
+
+		for (auto i = full.outerIndexPtr()[k]; i < full.outerIndexPtr()[k + 1]; ++i)
+		{
+			const int row = indices(full.innerIndexPtr()[i]);
+			if (row < 0)
+				continue;
+
+			inner.push_back(row);
+			value_map_.push_back(i);
+		}
+		outer[indices(k) + 1] = inner.size();
+	}
+
+	const std::vector<double> zeros(inner.size(), 0);
+	reduced_pattern_ = Eigen::Map<const StiffnessMatrix>(
+		reduced_size, reduced_size, inner.size(), outer.data(), inner.data(), zeros.data());
+}
+
 Eigen::MatrixXd polyfem::utils::reorder_matrix(
 	const Eigen::MatrixXd &in,
 	const Eigen::VectorXi &in_to_out,
@@ -107,6 +107,49 @@ namespace polyfem
 			const StiffnessMatrix &full,
 			StiffnessMatrix &reduced);
 
+		/// @brief Persistent full_to_reduced_matrix for a sequence of matrices sharing a sparsity pattern.
+		///
+		/// The reduced pattern and the positions of its values in the full matrix are computed once
+		/// per sparsity pattern of the full matrix (and set of removed variables). Every other call
+		/// only gathers the values into reduced, which keeps its pattern (and allocation) so that the
+		/// linear solver can reuse its symbolic factorization.
+		class FullToReducedMatrixMap
+		{
+		public:
+			/// @brief Same as full_to_reduced_matrix.
+			void apply(
+				const int full_size,
+				const int reduced_size,
+				const std::vector<int> &removed_vars,
+				const StiffnessMatrix &full,
+				StiffnessMatrix &reduced);
+
+			/// @brief Forget the cached pattern.
+			void clear();
+
+			/// @brief Number of times the map was (re)built.
+			int n_builds() const { return n_builds_; }
+
+		private:
+			void build(
+				const int full_size,
+				const int reduced_size,
+				const std::vector<int> &removed_vars,
+				const StiffnessMatrix &full);
+
+			bool has_pattern(const std::vector<int> &removed_vars, const StiffnessMatrix &full) const;
+
+			std::vector<int> removed_vars_;
+			std::vector<StiffnessMatrix::StorageIndex> full_outer_;
+			std::vector<StiffnessMatrix::StorageIndex> full_inner_;
+
+			StiffnessMatrix reduced_pattern_;
+			/// Index in the values of full of each value of reduced
+			std::vector<StiffnessMatrix::StorageIndex> value_map_;
+
+			int n_builds_ = 0;
+		};
+
 		/// @brief Reorder row blocks in a matrix.
 		/// @param in Input matrix.
 		/// @param in_to_out Mapping from input blocks to output blocks.
@@ -0,0 +1,219 @@
+#include "Profiler.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+
+namespace polyfem::utils
+{
+	namespace
+	{
+		/// maximum number of trace events stored per thread
+		constexpr size_t MAX_EVENTS = size_t(1) << 22;
+	} // namespace
+
+	std::atomic<bool> Profiler::enabled_(false);
+
+	Profiler &Profiler::instance()
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+
+	Profiler::Profiler()
+		: epoch_(Clock::now())
+	{
+	}
+
+	Profiler::ThreadData &Profiler::local_data()
+	{
+		thread_local ThreadData *data = nullptr;
+		if (data == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			threads_.push_back(std::make_unique<ThreadData>());
+			data = threads_.back().get();
+			data->id = threads_.size() - 1;
+			data->nodes.push_back({"", -1});
+		}
+		return *data;
+	}
+
+	void Profiler::begin(const std::string &name)
+	{
+		ThreadData &data = local_data();
+
+		const int parent = data.stack.empty() ? 0 : data.stack.back();
+		int node;
+		const auto it = data.nodes[parent].children.find(name);
+		if (it == data.nodes[parent].children.end())
+		{
+			node = data.nodes.size();
+			data.nodes[parent].children[name] = node;
+			data.nodes.push_back({name, parent});
+		}
+		else
+			node = it->second;
+
+		data.stack.push_back(node);
+		data.starts.push_back(Clock::now());
+	}
+
+	void Profiler::end()
+	{
+		const Clock::time_point stop = Clock::now();
+		ThreadData &data = local_data();
+		if (data.stack.empty())
+			return; // cleared while the scope was open
+
+		const int node = data.stack.back();
+		const Clock::time_point start = data.starts.back();
+		data.stack.pop_back();
+		data.starts.pop_back();
+
+		Node &n = data.nodes[node];
+		++n.calls;
+		n.time += std::chrono::duration<double>(stop - start).count();
+
+		if (trace_enabled_)
+		{
+			if (data.events.size() < MAX_EVENTS)
+				data.events.push_back({
+					node,
+					std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch_).count(),
+					std::chrono::duration_cast<std::chrono::nanoseconds>(stop - epoch_).count(),
+				});
+			else
+				++data.dropped_events;
+		}
+	}
+
+	void Profiler::clear()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (auto &data : threads_)
+		{
+			data->nodes.resize(1);
+			data->nodes[0].children.clear();
+			data->stack.clear();
+			data->starts.clear();
+			data->events.clear();
+			data->dropped_events = 0;
+		}
+		epoch_ = Clock::now();
+	}
+
+	json Profiler::summary() const
+	{
+		struct Row
+		{
+			std::string name;
+			int depth;
+			size_t calls = 0;
+			double time = 0;
+			double children_time = 0;
+			std::map<int, double> thread_times;
+		};
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		// merge the per-thread trees by path
+		std::vector<std::string> order;
+		std::unordered_map<std::string, Row> rows;
+
+		for (const auto &data : threads_)
+		{
+			const std::function<void(int, const std::string &, int)> visit = [&](const int node, const std::string &path, const int depth) {
+				for (const auto &[name, child] : data->nodes[node].children)
+				{
+					const Node &c = data->nodes[child];
+					const std::string child_path = path.empty() ? name : (path + "/" + name);
+
+					auto it = rows.find(child_path);
+					if (it == rows.end())
+					{
+						order.push_back(child_path);
+						it = rows.emplace(child_path, Row{name, depth}).first;
+					}
+					Row &row = it->second;
+					row.calls += c.calls;
+					row.time += c.time;
+					row.thread_times[data->id] += c.time;
+					if (node != 0)
+						rows.at(path).children_time += c.time;
+
+					visit(child, child_path, depth + 1);
+				}
+			};
+			visit(0, "", 0);
+		}
+
+		std::sort(order.begin(), order.end());
+
+		json table = json::array();
+		for (const std::string &path : order)
+		{
+			const Row &row = rows.at(path);
+
+			json threads = json::object();
+			for (const auto &[id, time] : row.thread_times)
+				threads[std::to_string(id)] = time;
+
+			table.push_back({
+				{"path", path},
+				{"name", row.name},
+				{"depth", row.depth},
+				{"calls", row.calls},
+				{"total", row.time},
+				{"self", std::max(0.0, row.time - row.children_time)},
+				{"threads", threads},
+			});
+		}
+
+		return table;
+	}
+
+	void Profiler::save_trace(const std::string &path) const
+	{
+		std::ofstream out(path);
+		if (!out.is_open())
+		{
+			logger().error("Unable to save profiler trace to {}", path);
+			return;
+		}
+
+		json events = json::array();
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (const auto &data : threads_)
+		{
+			events.push_back({
+				{"name", "thread_name"},
+				{"ph", "M"},
+				{"pid", 0},
+				{"tid", data->id},
+				{"args", {{"name", fmt::format("thread {}", data->id)}}},
+			});
+
+			for (const Event &e : data->events)
+			{
+				events.push_back({
+					{"name", data->nodes[e.node].name},
+					{"ph", "X"},
+					{"pid", 0},
+					{"tid", data->id},
+					{"ts", e.start * 1e-3},
+					{"dur", (e.end - e.start) * 1e-3},
+				});
+			}
+
+			if (data->dropped_events > 0)
+				logger().warn("Profiler dropped {} trace events of thread {}", data->dropped_events, data->id);
+		}
+
+		out << json({{"traceEvents", events}, {"displayTimeUnit", "ms"}}).dump() << std::endl;
+	}
+} // namespace polyfem::utils
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Opens a profiler scope until the end of the enclosing block, the arguments
+/// are only converted to the scope name if the profiler is enabled.
+#define POLYFEM_PROFILE_SCOPE(...) \
+	polyfem::utils::ProfileScope __polyfem_profile_scope([&]() { return std::string(__VA_ARGS__); })
+
+namespace polyfem
+{
+	namespace utils
+	{
+		/// @brief Hierarchical, thread-aware profiler.
+		///
+		/// Every thread records its own tree of nested scopes (call count and total
+		/// time per node) and, if tracing is enabled, the individual scope events.
+		/// Scopes opened on a worker thread are roots of that thread's tree.
+		/// When disabled, opening a scope costs one relaxed atomic load.
+		///
+		/// summary(), save_trace(), and clear() must not run while scopes are open.
+		class Profiler
+		{
+		public:
+			static Profiler &instance();
+
+			static bool is_enabled() { return enabled_.load(std::memory_order_relaxed); }
+			void set_enabled(const bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+			/// @brief Also record the individual scope events, needed by save_trace
+			void set_trace_enabled(const bool enabled) { trace_enabled_ = enabled; }
+			bool is_trace_enabled() const { return trace_enabled_; }
+
+			/// @brief Opens a scope nested in the current scope of the calling thread
+			void begin(const std::string &name);
+			/// @brief Closes the current scope of the calling thread
+			void end();
+
+			/// @brief Discards everything recorded so far
+			void clear();
+
+			/// @brief Aggregated table of the scopes, merged over the threads by path.
+			/// Each row has the path, name, depth, calls, total and self time (s),
+			/// and the total time per thread.
+			json summary() const;
+
+			/// @brief Writes the recorded events as a Chrome trace (chrome://tracing, Perfetto)
+			/// @param path output path
+			void save_trace(const std::string &path) const;
+
+		private:
+			using Clock = std::chrono::steady_clock;
+
+			struct Node
+			{
+				std::string name;
+				int parent;
+				std::unordered_map<std::string, int> children;
+				size_t calls = 0;
+				double time = 0;
+			};
+
+			struct Event
+			{
+				int node;
+				int64_t start; ///< ns since epoch_
+				int64_t end;   ///< ns since epoch_
+			};
+
+			struct ThreadData
+			{
+				int id;
+				std::vector<Node> nodes; ///< nodes[0] is the root
+				std::vector<int> stack;  ///< open nodes
+				std::vector<Clock::time_point> starts;
+				std::vector<Event> events;
+				size_t dropped_events = 0;
+			};
+
+			Profiler();
+
+			ThreadData &local_data();
+
+			static std::atomic<bool> enabled_;
+			bool trace_enabled_ = false;
+
+			Clock::time_point epoch_;
+
+			mutable std::mutex mutex_;
+			std::vector<std::unique_ptr<ThreadData>> threads_;
+		};
+
+		/// @brief RAII profiler scope, see POLYFEM_PROFILE_SCOPE
+		class ProfileScope
+		{
+		public:
+			template <typename NameFunction>
+			explicit ProfileScope(NameFunction &&name)
+			{
+				if (Profiler::is_enabled())
+				{
+					Profiler::instance().begin(name());
+					active_ = true;
+				}
+			}
+
+			~ProfileScope()
+			{
+				if (active_)
+					Profiler::instance().end();
+			}
+
+			ProfileScope(const ProfileScope &) = delete;
+			ProfileScope &operator=(const ProfileScope &) = delete;
+
+		private:
+			bool active_ = false;
+		};
+	} // namespace utils
+} // namespace polyfem
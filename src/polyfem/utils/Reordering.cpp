@@ -0,0 +1,200 @@
+#include "Reordering.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+
+namespace polyfem::utils
+{
+	namespace
+	{
+		// Spreads the lowest 21 bits of x so that there are two zero bits between each of them
+		uint64_t spread_bits_3(uint64_t x)
+		{
+			x &= 0x1fffff;
+			x = (x | x << 32) & 0x1f00000000ffff;
+			x = (x | x << 16) & 0x1f0000ff0000ff;
+			x = (x | x << 8) & 0x100f00f00f00f00f;
+			x = (x | x << 4) & 0x10c30c30c30c30c3;
+			x = (x | x << 2) & 0x1249249249249249;
+			return x;
+		}
+
+		// Spreads the lowest 32 bits of x so that there is one zero bit between each of them
+		uint64_t spread_bits_2(uint64_t x)
+		{
+			x &= 0xffffffff;
+			x = (x | x << 16) & 0x0000ffff0000ffff;
+			x = (x | x << 8) & 0x00ff00ff00ff00ff;
+			x = (x | x << 4) & 0x0f0f0f0f0f0f0f0f;
+			x = (x | x << 2) & 0x3333333333333333;
+			x = (x | x << 1) & 0x5555555555555555;
+			return x;
+		}
+
+		// Breadth-first level structure rooted at root, restricted to unnumbered vertices.
+		// Returns the vertices in BFS order and fills the level of each reached vertex.
+		std::vector<int> level_structure(
+			const std::vector<std::vector<int>> &adjacency,
+			const int root,
+			const std::vector<bool> &numbered,
+			std::vector<int> &level)
+		{
+			std::vector<int> queue;
+			queue.push_back(root);
+			level[root] = 0;
+			for (size_t head = 0; head < queue.size(); ++head)
+			{
+				const int v = queue[head];
+				for (const int n : adjacency[v])
+				{
+					if (numbered[n] || level[n] >= 0)
+						continue;
+					level[n] = level[v] + 1;
+					queue.push_back(n);
+				}
+			}
+			return queue;
+		}
+
+		// George-Liu heuristic for a pseudo-peripheral vertex of the component containing start
+		int pseudo_peripheral_vertex(
+			const std::vector<std::vector<int>> &adjacency,
+			const int start,
+			const std::vector<bool> &numbered,
+			std::vector<int> &level)
+		{
+			int root = start;
+			int eccentricity = -1;
+			while (true)
+			{
+				const std::vector<int> component = level_structure(adjacency, root, numbered, level);
+				const int depth = level[component.back()];
+
+				// min degree vertex in the last level
+				int candidate = component.back();
+				for (auto it = component.rbegin(); it != component.rend() && level[*it] == depth; ++it)
+				{
+					if (adjacency[*it].size() < adjacency[candidate].size())
+						candidate = *it;
+				}
+
+				for (const int v : component)
+					level[v] = -1;
+
+				if (depth <= eccentricity)
+					return root;
+
+				eccentricity = depth;
+				root = candidate;
+			}
+		}
+	} // namespace
+
+	Eigen::VectorXi morton_order(const Eigen::MatrixXd &points)
+	{
+		const int n = points.rows();
+		const int dim = points.cols();
+		assert(dim == 2 || dim == 3);
+
+		Eigen::VectorXi order(n);
+		if (n == 0)
+			return order;
+
+		const Eigen::RowVectorXd min = points.colwise().minCoeff();
+		const double extent = std::max((points.colwise().maxCoeff() - min).maxCoeff(), 1e-16);
+
+		const double n_cells = dim == 3 ? double((1 << 21) - 1) : double(0xffffffffu);
+
+		std::vector<std::pair<uint64_t, int>> keys(n);
+		for (int i = 0; i < n; ++i)
+		{
+			uint64_t key = 0;
+			for (int d = 0; d < dim; ++d)
+			{
+				const uint64_t c = uint64_t((points(i, d) - min(d)) / extent * n_cells);
+				key |= (dim == 3 ? spread_bits_3(c) : spread_bits_2(c)) << d;
+			}
+			keys[i] = std::make_pair(key, i);
+		}
+
+		std::sort(keys.begin(), keys.end());
+		for (int i = 0; i < n; ++i)
+			order[i] = keys[i].second;
+
+		return order;
+	}
+
+	Eigen::VectorXi reverse_cuthill_mckee(const std::vector<std::vector<int>> &adjacency)
+	{
+		const int n = adjacency.size();
+
+		std::vector<bool> numbered(n, false);
+		std::vector<int> level(n, -1);
+		std::vector<int> cm;
+		cm.reserve(n);
+
+		// visit components starting from low degree vertices
+		std::vector<int> by_degree(n);
+		std::iota(by_degree.begin(), by_degree.end(), 0);
+		std::stable_sort(by_degree.begin(), by_degree.end(), [&](int a, int b) { return adjacency[a].size() < adjacency[b].size(); });
+
+		std::vector<int> neighbors;
+		for (const int start : by_degree)
+		{
+			if (numbered[start])
+				continue;
+
+			const int root = pseudo_peripheral_vertex(adjacency, start, numbered, level);
+
+			size_t head = cm.size();
+			cm.push_back(root);
+			numbered[root] = true;
+			for (; head < cm.size(); ++head)
+			{
+				neighbors.clear();
+				for (const int v : adjacency[cm[head]])
+				{
+					if (!numbered[v])
+					{
+						numbered[v] = true;
+						neighbors.push_back(v);
+					}
+				}
+				std::stable_sort(neighbors.begin(), neighbors.end(), [&](int a, int b) { return adjacency[a].size() < adjacency[b].size(); });
+				cm.insert(cm.end(), neighbors.begin(), neighbors.end());
+			}
+		}
+		assert(cm.size() == n);
+
+		Eigen::VectorXi order(n);
+		for (int i = 0; i < n; ++i)
+			order[i] = cm[n - 1 - i];
+
+		return order;
+	}
+
+	Eigen::VectorXi invert_permutation(const Eigen::VectorXi &order)
+	{
+		Eigen::VectorXi new_index(order.size());
+		for (int i = 0; i < order.size(); ++i)
+			new_index[order[i]] = i;
+		return new_index;
+	}
+
+	int graph_bandwidth(const std::vector<std::vector<int>> &adjacency, const Eigen::VectorXi &new_index)
+	{
+		int bandwidth = 0;
+		for (int i = 0; i < adjacency.size(); ++i)
+		{
+			const int ni = new_index.size() > 0 ? new_index[i] : i;
+			for (const int j : adjacency[i])
+			{
+				const int nj = new_index.size() > 0 ? new_index[j] : j;
+				bandwidth = std::max(bandwidth, std::abs(ni - nj));
+			}
+		}
+		return bandwidth;
+	}
+} // namespace polyfem::utils
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <vector>
+
+namespace polyfem::utils
+{
+	/// @brief Orders a point set along a Morton (Z-order) space-filling curve.
+	/// @param points #points x dim matrix of positions, dim is 2 or 3.
+	/// @return order[i] is the index of the i-th point along the curve.
+	Eigen::VectorXi morton_order(const Eigen::MatrixXd &points);
+
+	/// @brief Computes the reverse Cuthill-McKee ordering of an undirected graph.
+	/// Every connected component is started from a pseudo-peripheral vertex.
+	/// @param adjacency Symmetric adjacency lists, without self loops.
+	/// @return order[i] is the old index of the vertex numbered i.
+	Eigen::VectorXi reverse_cuthill_mckee(const std::vector<std::vector<int>> &adjacency);
+
+	/// @brief Inverts a permutation.
+	/// @param order order[i] is the old index of the entry numbered i.
+	/// @return new_index[j] is the new index of the entry with old index j.
+	Eigen::VectorXi invert_permutation(const Eigen::VectorXi &order);
+
+	/// @brief Bandwidth of the graph given by its adjacency lists, i.e., max |i - j| over its edges.
+	/// @param adjacency Adjacency lists.
+	/// @param new_index If not empty, the numbering to measure the bandwidth with.
+	/// @return The bandwidth.
+	int graph_bandwidth(const std::vector<std::vector<int>> &adjacency, const Eigen::VectorXi &new_index = Eigen::VectorXi());
+} // namespace polyfem::utils
@@ -0,0 +1,132 @@
+#include "TaskGraph.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
+#include <polyfem/utils/par_for.hpp>
+
+#ifdef POLYFEM_WITH_TBB
+#include <tbb/task_arena.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+namespace polyfem::utils
+{
+	namespace
+	{
+		/// limits the parallel loops started from the calling thread while in scope
+		class ThreadBudgetGuard
+		{
+		public:
+			ThreadBudgetGuard(const size_t budget)
+				: previous_(NThread::thread_budget())
+			{
+				NThread::set_thread_budget(budget);
+			}
+
+			~ThreadBudgetGuard() { NThread::set_thread_budget(previous_); }
+
+		private:
+			const size_t previous_;
+		};
+
+		/// runs f with its parallel loops limited to n_threads threads
+		void run_with_threads(const int n_threads, const std::function<void()> &f)
+		{
+#if defined(POLYFEM_WITH_TBB)
+			tbb::task_arena arena(n_threads);
+			arena.execute(f);
+#else
+			ThreadBudgetGuard guard(n_threads);
+			f();
+#endif
+		}
+	} // namespace
+
+	void run_task_graph(
+		const std::vector<std::vector<int>> &dependencies,
+		const int threads_per_task,
+		const std::function<void(int)> &run)
+	{
+		const int n_tasks = dependencies.size();
+		if (n_tasks == 0)
+			return;
+
+		const int n_threads = std::max<int>(1, get_n_threads());
+		const int task_threads = std::clamp(threads_per_task, 1, n_threads);
+		const int n_workers = std::clamp(n_threads / task_threads, 1, n_tasks);
+
+		std::vector<std::vector<int>> dependents(n_tasks);
+		std::vector<int> n_missing(n_tasks);
+		std::deque<int> ready;
+		for (int i = 0; i < n_tasks; ++i)
+		{
+			n_missing[i] = dependencies[i].size();
+			for (const int d : dependencies[i])
+			{
+				assert(d >= 0 && d < n_tasks);
+				dependents[d].push_back(i);
+			}
+
+			if (n_missing[i] == 0)
+				ready.push_back(i);
+		}
+
+		std::mutex mutex;
+		std::condition_variable cv;
+		int n_running = 0;
+		int n_done = 0;
+		std::exception_ptr error;
+
+		// every chunk is a worker running the ready tasks, it waits while the running tasks can make new ones ready
+		maybe_parallel_for(n_workers, [&](int start, int end, int thread_id) {
+			if (start == end)
+				return;
+
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true)
+			{
+				cv.wait(lock, [&]() { return !ready.empty() || n_running == 0 || error; });
+				if (ready.empty() || error)
+					break;
+
+				const int task = ready.front();
+				ready.pop_front();
+				++n_running;
+
+				lock.unlock();
+				std::exception_ptr task_error;
+				try
+				{
+					run_with_threads(task_threads, [&]() { run(task); });
+				}
+				catch (...)
+				{
+					task_error = std::current_exception();
+				}
+				lock.lock();
+
+				--n_running;
+				++n_done;
+				if (task_error && !error)
+					error = task_error;
+				for (const int d : dependents[task])
+				{
+					if (--n_missing[d] == 0)
+						ready.push_back(d);
+				}
+				cv.notify_all();
+			}
+		});
+
+		if (error)
+			std::rethrow_exception(error);
+		if (n_done != n_tasks)
+			log_and_throw_error("The task graph has a cycle, only {} of {} tasks ran", n_done, n_tasks);
+	}
+} // namespace polyfem::utils
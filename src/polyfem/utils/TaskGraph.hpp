@@ -0,0 +1,18 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+namespace polyfem::utils
+{
+	/// @brief runs tasks concurrently, every task starts as soon as the tasks it depends on are done.
+	/// The parallel loops of every task are limited to threads_per_task threads, so that the tasks
+	/// running at the same time do not oversubscribe the machine.
+	/// @param[in] dependencies for every task, the tasks that must be done before it starts
+	/// @param[in] threads_per_task number of threads available to every task, at most the number of threads
+	/// @param[in] run runs the i-th task
+	void run_task_graph(
+		const std::vector<std::vector<int>> &dependencies,
+		const int threads_per_task,
+		const std::function<void(int)> &run);
+} // namespace polyfem::utils
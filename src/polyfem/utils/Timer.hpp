@@ -5,6 +5,8 @@
 #include <polyfem/utils/Logger.hpp>
 // clang-format on
 
+#include <polyfem/utils/Profiler.hpp>
+
 #include <igl/Timer.h>
 
 #define POLYFEM_SCOPED_TIMER(...) polyfem::utils::Timer __polyfem_timer(__VA_ARGS__)
@@ -72,6 +74,12 @@ namespace polyfem
 
 			inline void start()
 			{
+				// named timers are also scopes of the profiler
+				if (!m_name.empty() && !m_profiling && Profiler::is_enabled())
+				{
+					Profiler::instance().begin(m_name);
+					m_profiling = true;
+				}
 				is_running = true;
 				m_timer.start();
 			}
@@ -82,6 +90,11 @@ namespace polyfem
 					return;
 				m_timer.stop();
 				is_running = false;
+				if (m_profiling)
+				{
+					Profiler::instance().end();
+					m_profiling = false;
+				}
 				log_msg();
 				if (m_total_time)
 					*m_total_time += getElapsedTimeInSec();
@@ -116,6 +129,7 @@ namespace polyfem
 			double *m_total_time = nullptr;
 			size_t *m_count = nullptr;
 			bool is_running = false;
+			bool m_profiling = false;
 		};
 	} // namespace utils
 } // namespace polyfem
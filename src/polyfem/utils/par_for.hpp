@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <thread>
 
@@ -22,7 +23,12 @@ namespace polyfem
 				return instance;
 			}
 
-			inline size_t num_threads() const { return num_threads_; }
+			/// number of threads of the parallel loops, limited by the budget of the calling thread
+			inline size_t num_threads() const { return thread_budget_ > 0 ? std::min(thread_budget_, num_threads_) : num_threads_; }
+
+			/// limits the number of threads of the parallel loops started from the calling thread, 0 for no limit
+			static void set_thread_budget(const size_t budget) { thread_budget_ = budget; }
+			static size_t thread_budget() { return thread_budget_; }
 
 			void set_num_threads(const int max_threads)
 			{
@@ -40,6 +46,7 @@ namespace polyfem
 			NThread() {}
 
 			size_t num_threads_;
+			static inline thread_local size_t thread_budget_ = 0;
 
 #ifdef POLYFEM_WITH_TBB
 			/// limits the number of used threads
@@ -12,10 +12,12 @@
 
 #include <polyfem/basis/barycentric/MVPolygonalBasis2d.hpp>
 #include <polyfem/basis/barycentric/WSPolygonalBasis2d.hpp>
+#include <polyfem/basis/PolygonalBasisCache.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 
+#include <filesystem>
 #include <iostream>
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -1178,3 +1180,49 @@ TEST_CASE("WS_2d", "[bases]")
 		}
 	}
 }
+
+TEST_CASE("polygonal_basis_cache", "[bases]")
+{
+	Eigen::MatrixXd centers = Eigen::MatrixXd::Random(8, 2);
+	Eigen::MatrixXd samples = Eigen::MatrixXd::Random(20, 2);
+	Eigen::MatrixXd integrals = Eigen::MatrixXd::Random(5, 3);
+	Eigen::MatrixXd rhs = Eigen::MatrixXd::Random(20, 5);
+	Quadrature quadr;
+	quadr.points = Eigen::MatrixXd::Random(6, 2);
+	quadr.weights = Eigen::VectorXd::Random(6);
+
+	PolygonalBasisCache cache("2d Laplacian");
+	const PolygonalBasisCache::Key key = cache.key(1, centers, samples, integrals, quadr, rhs);
+	REQUIRE(key == cache.key(1, centers, samples, integrals, quadr, rhs));
+	REQUIRE(key != cache.key(2, centers, samples, integrals, quadr, rhs));
+	REQUIRE(key != PolygonalBasisCache("2d LinearElasticity").key(1, centers, samples, integrals, quadr, rhs));
+
+	Eigen::MatrixXd perturbed = centers;
+	perturbed(3, 1) += 1e-12;
+	REQUIRE(key != cache.key(1, perturbed, samples, integrals, quadr, rhs));
+
+	Eigen::MatrixXd weights;
+	REQUIRE(!cache.find(key, weights));
+
+	const Eigen::MatrixXd expected = Eigen::MatrixXd::Random(11, 5);
+	cache.insert(key, expected);
+	REQUIRE(cache.find(key, weights));
+	REQUIRE(weights == expected);
+	REQUIRE(cache.hits() == 1);
+	REQUIRE(cache.misses() == 1);
+
+	const std::string path = (std::filesystem::temp_directory_path() / "polyfem_poly_basis_cache.bin").string();
+	REQUIRE(cache.save(path));
+
+	PolygonalBasisCache loaded("2d Laplacian");
+	REQUIRE(loaded.load(path));
+	REQUIRE(loaded.size() == 1);
+	REQUIRE(loaded.find(key, weights));
+	REQUIRE(weights == expected);
+
+	PolygonalBasisCache other("2d LinearElasticity");
+	REQUIRE(!other.load(path));
+	REQUIRE(other.size() == 0);
+
+	std::filesystem::remove(path);
+}
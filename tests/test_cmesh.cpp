@@ -1,10 +1,18 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <polyfem/mesh/mesh2D/CMesh2D.hpp>
+#include <polyfem/mesh/mesh3D/Mesh3D.hpp>
 #include <polyfem/State.hpp>
+#include <polyfem/io/BinaryMesh.hpp>
+#include <polyfem/mesh/Obstacle.hpp>
+#include <polyfem/utils/MatrixUtils.hpp>
+#include <polyfem/utils/par_for.hpp>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 ////////////////////////////////////////////////////////////////////////////////
 
 using namespace polyfem;
@@ -21,3 +29,184 @@ TEST_CASE("append_2d", "[mesh_test]")
 
 	m1->append(m2);
 }
+
+TEST_CASE("flat_adjacency_3d", "[mesh_test]")
+{
+	// Used to init geogram
+	State state;
+
+	const auto mesh = Mesh::create(POLYFEM_DATA_DIR + std::string("/contact/meshes/3D/simple/cube.msh"));
+	REQUIRE(mesh->is_volume());
+	const Mesh3D &m3d = dynamic_cast<const Mesh3D &>(*mesh);
+
+	const auto check_adjacency = [&]() {
+		std::vector<int> ids;
+		for (int c = 0; c < m3d.n_cells(); ++c)
+		{
+			for (int lv = 0; lv < m3d.n_cell_vertices(c); ++lv)
+			{
+				m3d.get_vertex_elements_neighs(m3d.cell_vertex(c, lv), ids);
+				CHECK(std::find(ids.begin(), ids.end(), c) != ids.end());
+			}
+
+			for (int le = 0; le < m3d.n_cell_edges(c); ++le)
+			{
+				m3d.get_edge_elements_neighs(m3d.cell_edge(c, le), ids);
+				CHECK(std::find(ids.begin(), ids.end(), c) != ids.end());
+			}
+
+			for (int lf = 0; lf < m3d.n_cell_faces(c); ++lf)
+			{
+				const auto idx = m3d.switch_element(m3d.get_index_from_element(c, lf, 0));
+				if (m3d.is_boundary_face(m3d.cell_face(c, lf)))
+					CHECK(idx.element < 0);
+				else
+					CHECK(m3d.switch_element(idx).element == c);
+			}
+		}
+	};
+
+	check_adjacency();
+
+	// the refinement reads the neighbor lists released after loading
+	const int n_cells = m3d.n_cells();
+	mesh->refine(1, 0);
+	REQUIRE(m3d.n_cells() > n_cells);
+	check_adjacency();
+}
+
+TEST_CASE("red_refinement_tet", "[mesh_test]")
+{
+	// Used to init geogram
+	State state;
+
+	const int n_refs = GENERATE(1, 2);
+	const std::string path = POLYFEM_DATA_DIR + std::string("/contact/meshes/3D/simple/cube.msh");
+
+	const auto signed_volume = [](const Mesh3D &m, const int c) {
+		const RowVectorNd p0 = m.point(m.cell_vertex(c, 0));
+		const Eigen::Vector3d a = (m.point(m.cell_vertex(c, 1)) - p0).transpose();
+		const Eigen::Vector3d b = (m.point(m.cell_vertex(c, 2)) - p0).transpose();
+		const Eigen::Vector3d d = (m.point(m.cell_vertex(c, 3)) - p0).transpose();
+		return a.cross(b).dot(d) / 6;
+	};
+
+	const auto refine = [&](const int n_threads) {
+		utils::NThread::get().set_num_threads(n_threads);
+		auto mesh = Mesh::create(path);
+		REQUIRE(mesh->is_volume());
+		REQUIRE(mesh->is_simplicial());
+		mesh->refine(n_refs, 0);
+		return mesh;
+	};
+
+	const auto input = Mesh::create(path);
+	const Mesh3D &in3d = dynamic_cast<const Mesh3D &>(*input);
+	// orientation of the input tets, the children keep it
+	const double orientation = signed_volume(in3d, 0) > 0 ? 1 : -1;
+	double volume = 0;
+	for (int c = 0; c < in3d.n_cells(); ++c)
+	{
+		REQUIRE(orientation * signed_volume(in3d, c) > 0);
+		volume += orientation * signed_volume(in3d, c);
+	}
+
+	const auto serial = refine(1);
+	const auto parallel = refine(-1);
+	utils::NThread::get().set_num_threads(-1);
+
+	const Mesh3D &s3d = dynamic_cast<const Mesh3D &>(*serial);
+	const Mesh3D &p3d = dynamic_cast<const Mesh3D &>(*parallel);
+
+	// identical results with 1 and with all threads
+	REQUIRE(s3d.n_cells() == in3d.n_cells() * (1 << (3 * n_refs)));
+	REQUIRE(p3d.n_vertices() == s3d.n_vertices());
+	REQUIRE(p3d.n_faces() == s3d.n_faces());
+	REQUIRE(p3d.n_cells() == s3d.n_cells());
+	for (int v = 0; v < s3d.n_vertices(); ++v)
+		CHECK(p3d.point(v) == s3d.point(v));
+	for (int f = 0; f < s3d.n_faces(); ++f)
+	{
+		REQUIRE(p3d.n_face_vertices(f) == s3d.n_face_vertices(f));
+		for (int lv = 0; lv < s3d.n_face_vertices(f); ++lv)
+			CHECK(p3d.face_vertex(f, lv) == s3d.face_vertex(f, lv));
+	}
+	for (int c = 0; c < s3d.n_cells(); ++c)
+		for (int lv = 0; lv < 4; ++lv)
+			CHECK(p3d.cell_vertex(c, lv) == s3d.cell_vertex(c, lv));
+
+	// every child is oriented as the input and the children fill the input
+	double refined_volume = 0;
+	for (int c = 0; c < s3d.n_cells(); ++c)
+	{
+		const double vol = orientation * signed_volume(s3d, c);
+		CHECK(vol > 0);
+		refined_volume += vol;
+	}
+	CHECK(std::abs(refined_volume - volume) <= 1e-12 * volume);
+}
+
+TEST_CASE("binary_mesh_3d", "[mesh_test]")
+{
+	// Used to init geogram
+	State state;
+
+	const std::string msh_path = POLYFEM_DATA_DIR + std::string("/contact/meshes/3D/simple/cube.msh");
+	const std::string pfm_path = (std::filesystem::temp_directory_path() / "polyfem_binary_mesh_3d.pfm").string();
+	REQUIRE(io::BinaryMeshWriter::convert_msh(msh_path, pfm_path));
+
+	const auto msh_mesh = Mesh::create(msh_path);
+	const auto pfm_mesh = Mesh::create(pfm_path);
+	REQUIRE(pfm_mesh != nullptr);
+
+	CHECK(pfm_mesh->n_vertices() == msh_mesh->n_vertices());
+	CHECK(pfm_mesh->n_edges() == msh_mesh->n_edges());
+	CHECK(pfm_mesh->n_faces() == msh_mesh->n_faces());
+	CHECK(pfm_mesh->n_cells() == msh_mesh->n_cells());
+	CHECK(pfm_mesh->get_body_ids() == msh_mesh->get_body_ids());
+
+	CHECK(pfm_mesh->in_ordered_vertices() == msh_mesh->in_ordered_vertices());
+	CHECK(pfm_mesh->in_ordered_edges() == msh_mesh->in_ordered_edges());
+	CHECK(pfm_mesh->in_ordered_faces() == msh_mesh->in_ordered_faces());
+
+	for (int v = 0; v < pfm_mesh->n_vertices(); ++v)
+		CHECK(pfm_mesh->point(v) == msh_mesh->point(v));
+
+	std::filesystem::remove(pfm_path);
+}
+
+TEST_CASE("obstacle_mesh_sequence", "[mesh_test]")
+{
+	Eigen::MatrixXd V0(3, 2);
+	V0 << 0, 0,
+		1, 0,
+		0, 1;
+	Eigen::MatrixXi E(3, 2);
+	E << 0, 1,
+		1, 2,
+		2, 0;
+
+	std::vector<Eigen::MatrixXd> frames = {V0, V0, V0};
+	frames[1].col(0).array() += 1;
+	frames[2].col(1).array() += 2;
+
+	Obstacle obstacle;
+	obstacle.append_mesh_sequence(frames, Eigen::VectorXi(), E, Eigen::MatrixXi(), /*fps=*/2);
+	REQUIRE(obstacle.n_vertices() == 3);
+
+	const auto displacement = [&](const double t, const bool flat) {
+		Eigen::MatrixXd sol = flat ? Eigen::MatrixXd::Zero(obstacle.ndof(), 1) : Eigen::MatrixXd::Zero(obstacle.n_vertices(), 2);
+		obstacle.update_displacement(t, sol);
+		return flat ? utils::unflatten(sol, 2) : sol;
+	};
+
+	for (const bool flat : {true, false})
+	{
+		CHECK(displacement(0, flat).isZero());
+		CHECK(displacement(0.5, flat).isApprox(frames[1] - V0));
+		// halfway between the second and the third frame
+		CHECK(displacement(0.75, flat).isApprox(0.5 * (frames[1] + frames[2]) - V0));
+		// the last frame is held
+		CHECK(displacement(10, flat).isApprox(frames[2] - V0));
+	}
+}
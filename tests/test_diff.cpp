@@ -13,6 +13,10 @@
 #include <polyfem/solver/forms/parametrization/Parametrizations.hpp>
 #include <polyfem/solver/forms/parametrization/NodeCompositeParametrizations.hpp>
 #include <polyfem/solver/AdjointNLProblem.hpp>
+#include <polyfem/solver/forms/BodyForm.hpp>
+#include <polyfem/solver/forms/ElasticForm.hpp>
+#include <polyfem/solver/forms/InertiaForm.hpp>
+#include <polyfem/time_integrator/BDF.hpp>
 
 #include <catch2/catch_all.hpp>
 #include <math.h>
@@ -132,6 +136,63 @@ namespace
 	}
 } // namespace
 
+TEST_CASE("shared-discretization", "[test_adjoint]")
+{
+	json args = R"(
+	{
+		"geometry": [{
+			"surface_selection": 7,
+			"point_selection": [{
+				"id": 2,
+				"box": [[0, 0], [0.5, 1]],
+				"relative": true
+			}]
+		}],
+		"materials": {
+			"type": "NeoHookean",
+			"E": 20000,
+			"nu": 0.3
+		},
+		"boundary_conditions": {
+			"dirichlet_boundary": [{
+				"id": 2,
+				"value": [0, 0]
+			}],
+			"rhs": [10, 10]
+		}
+	})"_json;
+	args["geometry"][0]["mesh"] = POLYFEM_DATA_DIR + std::string("/contact/meshes/2D/simple/circle/circle36.obj");
+
+	std::shared_ptr<State> state0 = AdjointOptUtils::create_state(args, CacheLevel::Derivatives, 32, {}, /*keep_loaded_mesh=*/true);
+
+	// same discretization, different load
+	args["boundary_conditions"]["rhs"] = {0, -10};
+	std::shared_ptr<State> state1 = AdjointOptUtils::create_state(args, CacheLevel::Derivatives, 32, {state0});
+	std::shared_ptr<State> state2 = AdjointOptUtils::create_state(args);
+
+	CHECK(state1->ass_vals_cache.shares_values_with(state0->ass_vals_cache));
+	CHECK(state1->mass_ass_vals_cache.shares_values_with(state0->mass_ass_vals_cache));
+	CHECK(!state2->ass_vals_cache.shares_values_with(state0->ass_vals_cache));
+	CHECK(state2->loaded_mesh == nullptr);
+
+	// the point selection of the shared state picks the same nodes as a state loaded from scratch
+	REQUIRE(state2->mesh->has_node_ids());
+	REQUIRE(!state2->boundary_nodes.empty());
+	CHECK(state1->boundary_nodes == state2->boundary_nodes);
+	for (int n = 0; n < state2->mesh->n_vertices(); ++n)
+		CHECK(state1->mesh->get_node_id(n) == state2->mesh->get_node_id(n));
+
+	Eigen::MatrixXd sol1, sol2, pressure;
+	state1->solve_problem(sol1, pressure);
+	state2->solve_problem(sol2, pressure);
+	CHECK((sol1 - sol2).norm() <= 1e-12 * (1 + sol2.norm()));
+
+	// a new build, e.g., after a shape update, computes its own caches and leaves the shared ones untouched
+	state1->build_basis();
+	CHECK(!state1->ass_vals_cache.shares_values_with(state0->ass_vals_cache));
+	CHECK(!state0->ass_vals_cache.empty());
+}
+
 TEST_CASE("laplacian", "[test_adjoint]")
 {
 	json opt_args;
@@ -803,6 +864,65 @@ TEST_CASE("damping-transient", "[test_adjoint]")
 	verify_adjoint(*nl_problem, x, velocity_discrete, opt_args["solver"]["nonlinear"]["debug_fd_eps"], 1e-4);
 }
 
+TEST_CASE("shape-transient-volume-terms", "[test_adjoint]")
+{
+	json in_args;
+	load_json(append_root_path("damping-transient.json"), in_args);
+	std::shared_ptr<State> state_ptr = create_state_and_solve(in_args);
+	const State &state = *state_ptr;
+	REQUIRE(state.solve_data.damping_form);
+	REQUIRE(!state.is_contact_enabled());
+
+	const double t0 = state.args["time"]["t0"];
+	const double dt = state.args["time"]["dt"];
+	const int time_steps = state.args["time"]["time_steps"];
+	int bdf_order = 1;
+	if (state.args["time"]["integrator"].is_object() && state.args["time"]["integrator"]["type"] == "BDF")
+		bdf_order = state.args["time"]["integrator"]["steps"];
+
+	const int ndof = state.diff_cached.u(0).size();
+	const Eigen::MatrixXd adjoint_nu = Eigen::MatrixXd::Random(ndof, time_steps + 1);
+	const Eigen::MatrixXd adjoint_p = Eigen::MatrixXd::Random(ndof, time_steps + 1);
+
+	Eigen::VectorXd one_form;
+	AdjointTools::dJ_shape_transient_adjoint_term(state, adjoint_nu, adjoint_p, one_form);
+
+	// sum of the shape derivatives of the separate forms, one element pass each
+	Eigen::VectorXd expected, elasticity_term, rhs_term, damping_term, mass_term;
+	expected.setZero(state.n_geom_bases * state.mesh->dimension());
+	Eigen::VectorXd cur_p, cur_nu;
+	for (int i = time_steps; i > 0; --i)
+	{
+		const double beta_dt = time_integrator::BDF::betas(std::min(bdf_order, i) - 1) * dt;
+		const double t = i * dt + t0;
+
+		cur_p = adjoint_p.col(i);
+		cur_nu = adjoint_nu.col(i);
+		cur_p(state.boundary_nodes).setZero();
+		cur_nu(state.boundary_nodes).setZero();
+
+		state.solve_data.inertia_form->force_shape_derivative(state.mesh->is_volume(), state.n_geom_bases, t, state.bases, state.geom_bases(), *(state.mass_matrix_assembler), state.mass_ass_vals_cache, state.diff_cached.v(i), cur_nu, mass_term);
+		state.solve_data.elastic_form->force_shape_derivative(t, state.n_geom_bases, state.diff_cached.u(i), state.diff_cached.u(i), cur_p, elasticity_term);
+		state.solve_data.body_form->force_shape_derivative(state.n_geom_bases, t, state.diff_cached.u(i - 1), cur_p, rhs_term);
+		state.solve_data.damping_form->force_shape_derivative(t, state.n_geom_bases, state.diff_cached.u(i), state.diff_cached.u(i - 1), cur_p, damping_term);
+
+		expected += beta_dt * (elasticity_term + rhs_term + damping_term + mass_term);
+	}
+
+	Eigen::VectorXd sum_alpha_p;
+	sum_alpha_p.setZero(ndof);
+	for (int j = 0; j < std::min(bdf_order, time_steps); ++j)
+		sum_alpha_p -= time_integrator::BDF::alphas(std::min(bdf_order - 1, j))[j] * adjoint_p.col(j + 1);
+	sum_alpha_p(state.boundary_nodes).setZero();
+	state.solve_data.inertia_form->force_shape_derivative(state.mesh->is_volume(), state.n_geom_bases, t0, state.bases, state.geom_bases(), *(state.mass_matrix_assembler), state.mass_ass_vals_cache, state.diff_cached.v(0), sum_alpha_p, mass_term);
+	expected += mass_term;
+
+	expected = utils::flatten(utils::unflatten(expected, state.mesh->dimension())(state.primitive_to_node(), Eigen::all));
+
+	REQUIRE(one_form.size() == expected.size());
+	CHECK((one_form - expected).norm() <= 1e-8 * std::max(1., expected.norm()));
+}
+
 TEST_CASE("material-transient", "[test_adjoint]")
 {
 	json opt_args;
@@ -16,6 +16,7 @@
 #include <polyfem/solver/forms/RayleighDampingForm.hpp>
 
 #include <polyfem/time_integrator/ImplicitEuler.hpp>
+#include <polyfem/utils/MatrixUtils.hpp>
 
 #include <finitediff.hpp>
 
@@ -264,6 +265,51 @@ TEST_CASE("contact form derivatives", "[form][form_derivatives][contact_form]")
 	test_form(form, *state_ptr);
 }
 
+TEST_CASE("contact form persistent candidates", "[form][contact_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+
+	const double dhat = 0.1;
+	const auto create_form = [&]() {
+		auto form = std::make_shared<ContactForm>(
+			state_ptr->collision_mesh, dhat, state_ptr->avg_mass,
+			/*use_convergent_formulation=*/false, /*use_adaptive_barrier_stiffness=*/false,
+			/*is_time_dependent=*/false, false, ipc::BroadPhaseMethod::HASH_GRID,
+			/*ccd_tolerance=*/1e-6, /*ccd_max_iterations=*/static_cast<int>(1e6));
+		form->set_barrier_stiffness(1e3);
+		return form;
+	};
+
+	const auto form = create_form();
+	const auto persistent_form = create_form();
+	// small enough to be left, and the candidates rebuilt, during the random walk
+	persistent_form->set_candidate_skin(dhat / 10);
+
+	Eigen::VectorXd x = Eigen::VectorXd::Zero(state_ptr->n_bases * dim);
+	form->init(x);
+	persistent_form->init(x);
+
+	for (int i = 0; i < 20; ++i)
+	{
+		const Eigen::VectorXd x1 = x + Eigen::VectorXd::Random(x.size()) * dhat / 50;
+
+		form->line_search_begin(x, x1);
+		persistent_form->line_search_begin(x, x1);
+		CHECK(persistent_form->max_step_size(x, x1) == form->max_step_size(x, x1));
+		CHECK(persistent_form->is_step_collision_free(x, x1) == form->is_step_collision_free(x, x1));
+		form->line_search_end();
+		persistent_form->line_search_end();
+
+		x = x1;
+		form->solution_changed(x);
+		persistent_form->solution_changed(x);
+
+		CHECK(persistent_form->get_collision_set().size() == form->get_collision_set().size());
+		CHECK(std::abs(persistent_form->value(x) - form->value(x)) <= 1e-10 * std::max(1.0, std::abs(form->value(x))));
+	}
+}
+
 TEST_CASE("elastic form derivatives", "[form][form_derivatives][elastic_form]")
 {
 	const int dim = GENERATE(2, 3);
@@ -309,6 +355,83 @@ TEST_CASE("friction form derivatives", "[form][form_derivatives][friction_form]"
 	test_form(form, *state_ptr);
 }
 
+TEST_CASE("friction form hessian pattern", "[form][form_derivatives][friction_form]")
+{
+	// two bodies in contact: vertices 2 and 3 of the top edge are within dhat of the bottom edge
+	const double dhat = 0.1;
+	Eigen::MatrixXd V(4, 2);
+	V << 0, 0,
+		1, 0,
+		0.2, dhat / 2,
+		0.8, dhat / 2;
+	Eigen::MatrixXi E(2, 2);
+	E << 0, 1,
+		2, 3;
+	const ipc::CollisionMesh collision_mesh(V, E);
+
+	const ipc::BroadPhaseMethod broad_phase_method = ipc::BroadPhaseMethod::HASH_GRID;
+	ContactForm contact_form(
+		collision_mesh, dhat, /*avg_mass=*/1, /*use_convergent_formulation=*/false,
+		/*use_adaptive_barrier_stiffness=*/false, /*is_time_dependent=*/false, false, broad_phase_method,
+		/*ccd_tolerance=*/1e-6, /*ccd_max_iterations=*/static_cast<int>(1e6));
+	contact_form.set_barrier_stiffness(1e3);
+
+	const double epsv = 1e-3;
+	FrictionForm form(
+		collision_mesh, nullptr, epsv, /*mu=*/0.5, dhat, broad_phase_method,
+		contact_form, /*n_lagging_iters=*/-1);
+	form.set_project_to_psd(GENERATE(false, true));
+
+	const auto check_hessian = [&](const Eigen::VectorXd &x) {
+		StiffnessMatrix hess;
+		form.second_derivative(x, hess);
+
+		const StiffnessMatrix expected = form.dv_dx() * form.get_friction_potential().hessian(form.get_friction_collision_set(), collision_mesh, form.compute_surface_velocities(x), form.is_project_to_psd());
+		CHECK((Eigen::MatrixXd(hess) - Eigen::MatrixXd(expected)).norm() <= 1e-10 * std::max(1.0, Eigen::MatrixXd(expected).norm()));
+
+		if (!form.is_project_to_psd())
+		{
+			Eigen::MatrixXd fhess;
+			fd::finite_jacobian(
+				x,
+				[&form](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+					Eigen::VectorXd grad;
+					form.first_derivative(x, grad);
+					return grad;
+				},
+				fhess);
+			CHECK(fd::compare_hessian(Eigen::MatrixXd(hess), fhess));
+		}
+
+		return hess;
+	};
+
+	// sliding of the top edge, around the smoothing velocity
+	Eigen::VectorXd x = Eigen::VectorXd::Zero(V.size());
+	form.init_lagging(x);
+	REQUIRE(form.get_friction_collision_set().size() >= 2);
+	const size_t n_collisions = form.get_friction_collision_set().size();
+
+	for (int i = 0; i < 5; ++i)
+	{
+		x.setRandom();
+		x *= epsv;
+		check_hessian(x);
+	}
+
+	// lifting vertex 3 out of contact changes the collisions, the pattern has to be rebuilt
+	x.setZero();
+	x(3 * 2 + 1) = 2 * dhat;
+	form.update_lagging(x);
+	REQUIRE(form.get_friction_collision_set().size() < n_collisions);
+	REQUIRE(form.get_friction_collision_set().size() > 0);
+
+	x(2 * 2) = epsv / 2;
+	const StiffnessMatrix hess = check_hessian(x);
+	CHECK(Eigen::MatrixXd(hess).row(3 * 2).norm() == 0);
+	CHECK(Eigen::MatrixXd(hess).row(3 * 2 + 1).norm() == 0);
+}
+
 TEST_CASE("damping form derivatives", "[form][form_derivatives][damping_form]")
 {
 	const int dim = GENERATE(2, 3);
@@ -493,6 +616,34 @@ TEST_CASE("Inversion barrier form derivatives", "[form][form_derivatives][invers
 	test_form(form, *state_ptr);
 }
 
+TEST_CASE("Inversion barrier form max step size", "[form][inversion_barrier]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+
+	Eigen::MatrixXd V;
+	Eigen::MatrixXi F;
+	state_ptr->build_mesh_matrices(V, F);
+
+	InversionBarrierForm form(V, F, state_ptr->mesh->dimension(), 1e-3);
+
+	// mirror the mesh along x, every element becomes flat at t = 1/3
+	Eigen::MatrixXd U = Eigen::MatrixXd::Zero(V.rows(), V.cols());
+	U.col(0) = -3 * V.col(0);
+	const Eigen::VectorXd x0 = Eigen::VectorXd::Zero(U.size());
+	const Eigen::VectorXd x1 = utils::flatten(U);
+
+	CHECK(form.is_step_valid(x0, x0));
+	CHECK(!form.is_step_valid(x0, x1));
+
+	const double step = form.max_step_size(x0, x1);
+	CHECK(std::abs(step - 0.8 / 3) < 1e-8);
+	CHECK(form.is_step_valid(x0, step * x1));
+
+	// moving away from inversion is always allowed
+	CHECK(form.max_step_size(x0, -x1) == 1);
+}
+
 TEST_CASE("L2 projection form derivatives", "[form][form_derivatives][L2]")
 {
 	const int dim = GENERATE(2, 3);
@@ -1,9 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <polyfem/io/MatrixIO.hpp>
+
 #include <nlohmann/json.hpp>
 
 #include <h5pp/h5pp.h>
 
+#include <filesystem>
+
 TEST_CASE("HDF5", "[hdf5]")
 {
 	using MatrixXl = Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic>;
@@ -28,4 +32,32 @@ TEST_CASE("HDF5", "[hdf5]")
 		cells[i] = file.readDataset<MatrixXl>("/meshes/" + name + "/c").cast<int>();
 		vertices[i] = file.readDataset<Eigen::MatrixXd>("/meshes/" + name + "/v");
 	}
-}
\ No newline at end of file
+}
+TEST_CASE("HDF5_sparse_matrix", "[hdf5]")
+{
+	const std::string path = (std::filesystem::current_path() / "DELETE_ME_sparse.hdf5").string();
+
+	std::vector<Eigen::Triplet<double>> triplets = {{0, 0, 2}, {1, 0, -1}, {0, 1, -1}, {1, 1, 2}, {3, 2, 5}};
+	polyfem::StiffnessMatrix mat(4, 3);
+	mat.setFromTriplets(triplets.begin(), triplets.end());
+
+	Eigen::MatrixXd dense = Eigen::MatrixXd::Ones(2, 2);
+	polyfem::io::write_matrix(path, "u", dense);
+	REQUIRE(polyfem::io::write_sparse_matrix(path, "mass", mat, /*replace=*/false));
+
+	polyfem::StiffnessMatrix read;
+	REQUIRE(polyfem::io::read_sparse_matrix(path, "mass", read));
+	CHECK(read.rows() == mat.rows());
+	CHECK(read.cols() == mat.cols());
+	CHECK(read.nonZeros() == mat.nonZeros());
+	CHECK(Eigen::MatrixXd(read) == Eigen::MatrixXd(mat));
+
+	// the other datasets are kept
+	Eigen::MatrixXd read_dense;
+	polyfem::io::read_matrix(path, "u", read_dense);
+	CHECK(read_dense == dense);
+
+	CHECK(!polyfem::io::read_sparse_matrix(path, "stiffness", read));
+
+	std::filesystem::remove(path);
+}
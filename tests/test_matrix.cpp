@@ -247,3 +247,39 @@ TEST_CASE("cache", "[matrix]")
 	REQUIRE(tmp2.coeff(9, 4) == 6);
 	REQUIRE(tmp2.coeff(9, 9) == 4);
 }
+
+TEST_CASE("full_to_reduced_map", "[matrix]")
+{
+	const int n = 30;
+	const std::vector<int> removed = {0, 3, 4, 17, 29};
+	const int reduced_size = n - removed.size();
+
+	Eigen::MatrixXd dense = (Eigen::MatrixXd::Random(n, n).array() > 0.3).cast<double>();
+	dense(1, 2) = dense(2, 1) = 0;
+	StiffnessMatrix full = dense.sparseView();
+	full.makeCompressed();
+
+	FullToReducedMatrixMap map;
+	StiffnessMatrix reduced, expected;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int k = 0; k < full.nonZeros(); ++k)
+			full.valuePtr()[k] = i + k;
+
+		map.apply(n, reduced_size, removed, full, reduced);
+		full_to_reduced_matrix(n, reduced_size, removed, full, expected);
+
+		REQUIRE(reduced.rows() == reduced_size);
+		REQUIRE(Eigen::MatrixXd(reduced - expected).norm() == 0);
+	}
+	REQUIRE(map.n_builds() == 1);
+
+	// a new pattern rebuilds the map
+	full.coeffRef(1, 2) += 1;
+	full.coeffRef(2, 1) += 1;
+	full.makeCompressed();
+	map.apply(n, reduced_size, removed, full, reduced);
+	full_to_reduced_matrix(n, reduced_size, removed, full, expected);
+	REQUIRE(Eigen::MatrixXd(reduced - expected).norm() == 0);
+	REQUIRE(map.n_builds() == 2);
+}
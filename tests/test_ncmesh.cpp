@@ -3,6 +3,7 @@
 
 #include <polyfem/mesh/mesh2D/NCMesh2D.hpp>
 #include <polyfem/mesh/mesh3D/NCMesh3D.hpp>
+#include <polyfem/refinement/APosteriori.hpp>
 
 #include <polyfem/autogen/auto_p_bases.hpp>
 #include <polyfem/autogen/auto_q_bases.hpp>
@@ -10,6 +11,7 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <algorithm>
 
 #include <Eigen/Dense>
 #include <unsupported/Eigen/SparseExtra>
@@ -188,3 +190,81 @@ TEST_CASE("ncmesh3d", "[ncmesh]")
 	REQUIRE(fabs(state.stats.h1_semi_err) < 1e-7);
 	REQUIRE(fabs(state.stats.l2_err) < 1e-8);
 }
+
+TEST_CASE("ncmesh2d_adaptive", "[ncmesh]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = R"(
+		{
+			"materials": {"type": "Laplacian"},
+
+			"geometry": [{
+				"mesh": "",
+				"enabled": true,
+				"type": "mesh",
+				"surface_selection": 7
+			}],
+
+			"space":{
+				"discr_order": 1,
+				"adaptive_refinement": {
+					"enabled": true,
+					"tolerance": 0
+				},
+				"advanced": {
+					"bc_method": "sample"
+				}
+			},
+
+			"boundary_conditions": {
+				"dirichlet_boundary": [{
+					"id": "all",
+					"value": "x^4+y^4"
+				}],
+				"rhs": "12*x^2+12*y^2"
+			},
+
+			"output": {
+				"reference": {
+					"solution": "x^4+y^4",
+					"gradient": ["4*x^3","4*y^3"]
+				}
+			}
+		})"_json;
+	in_args["geometry"][0]["mesh"] = path + "/contact/meshes/2D/simple/circle/circle36.obj";
+
+	std::vector<double> errors;
+	std::vector<int> n_elements;
+	for (const int max_iterations : {1, 3})
+	{
+		in_args["space"]["adaptive_refinement"]["max_iterations"] = max_iterations;
+
+		State state;
+		state.set_max_threads(1);
+		state.init_logger("", spdlog::level::off, spdlog::level::off, false);
+		state.init(in_args, true);
+		state.load_mesh(true);
+
+		Eigen::MatrixXd sol, pressure;
+		refinement::APosteriori::solve(state, sol, pressure);
+		state.compute_errors(sol);
+
+		errors.push_back(state.stats.h1_semi_err);
+		n_elements.push_back(state.mesh->n_elements());
+	}
+
+	REQUIRE(n_elements[1] > n_elements[0]);
+	REQUIRE(errors[1] < errors[0]);
+}
+
+TEST_CASE("dorfler_marking", "[ncmesh]")
+{
+	const Eigen::Vector4d errors(1, 4, 2, 3);
+
+	std::vector<int> marked = refinement::APosteriori::dorfler_mark(errors, 0.5);
+	std::sort(marked.begin(), marked.end());
+	REQUIRE(marked == std::vector<int>{1, 3});
+
+	REQUIRE(refinement::APosteriori::dorfler_mark(errors, 1).size() == 4);
+	REQUIRE(refinement::APosteriori::dorfler_mark(errors, 0).size() == 1);
+}
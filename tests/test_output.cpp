@@ -4,7 +4,9 @@
 
 #include <polyfem/State.hpp>
 #include <polyfem/Common.hpp>
+#include <polyfem/io/Evaluator.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
+#include <polyfem/utils/RefElementSampler.hpp>
 
 #include <filesystem>
 #include <iostream>
@@ -82,3 +84,227 @@ TEST_CASE("full sim", "[.][full_sim]")
 
 	std::filesystem::remove_all(outdir);
 }
+
+TEST_CASE("evaluator thread independence", "[evaluator]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = R"(
+	{
+		"geometry": [{
+			"transformation": {
+				"scale": [0.1, 1, 1]
+			},
+			"n_refs": 1
+		}],
+		"materials": {
+			"type": "NeoHookean",
+			"E": 20000,
+			"nu": 0.3
+		},
+		"output": {
+			"log": {
+				"level": "warning"
+			}
+		}
+	})"_json;
+	in_args["geometry"][0]["mesh"] = path + "/contact/meshes/3D/simple/bar/bar-6.msh";
+
+	State state;
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	const mesh::Mesh &mesh = *state.mesh;
+	const int dim = mesh.dimension();
+
+	utils::RefElementSampler sampler;
+	sampler.init(mesh.is_volume(), mesh.n_elements(), 1e-3);
+	const int n_points = mesh.n_elements() * sampler.simplex_points().rows();
+
+	srand(42);
+	const Eigen::MatrixXd fun = 1e-2 * Eigen::VectorXd::Random(state.n_bases * dim);
+
+	struct Output
+	{
+		Eigen::MatrixXd interpolated, vertex_values, stress;
+		Eigen::VectorXd von_mises;
+		std::vector<assembler::Assembler::NamedMatrix> scalar, tensor, avg_scalar, avg_tensor;
+	};
+
+	const auto evaluate = [&](const int n_threads) {
+		state.set_max_threads(n_threads);
+
+		Output out;
+		io::Evaluator::interpolate_function(
+			mesh, false, state.bases, state.disc_orders, state.polys, state.polys_3d,
+			sampler, n_points, fun, out.interpolated, /*use_sampler=*/true, /*boundary_only=*/false);
+		io::Evaluator::compute_scalar_value(
+			mesh, false, state.bases, state.geom_bases(), state.disc_orders, state.polys, state.polys_3d,
+			*state.assembler, sampler, n_points, fun, 0, out.scalar, /*use_sampler=*/true, /*boundary_only=*/false);
+		io::Evaluator::compute_tensor_value(
+			mesh, false, state.bases, state.geom_bases(), state.disc_orders, state.polys, state.polys_3d,
+			*state.assembler, sampler, n_points, fun, 0, out.tensor, /*use_sampler=*/true, /*boundary_only=*/false);
+		io::Evaluator::average_grad_based_function(
+			mesh, false, state.n_bases, state.bases, state.geom_bases(), state.disc_orders, state.polys, state.polys_3d,
+			*state.assembler, sampler, 0, n_points, fun, out.avg_scalar, out.avg_tensor, /*use_sampler=*/true, /*boundary_only=*/false);
+		io::Evaluator::compute_vertex_values(mesh, dim, state.bases, sampler, fun, out.vertex_values);
+		io::Evaluator::compute_stress_at_quadrature_points(
+			mesh, false, state.bases, state.geom_bases(), state.disc_orders, *state.assembler, fun, 0, out.stress, out.von_mises);
+		return out;
+	};
+
+	const Output serial = evaluate(1);
+	const Output parallel = evaluate(std::numeric_limits<int>::max());
+
+	// the element values are stored or accumulated in the order of the elements, the results are identical
+	CHECK(serial.interpolated == parallel.interpolated);
+	CHECK(serial.vertex_values == parallel.vertex_values);
+	CHECK(serial.stress == parallel.stress);
+	CHECK(serial.von_mises == parallel.von_mises);
+
+	const auto check_named = [](const std::vector<assembler::Assembler::NamedMatrix> &a, const std::vector<assembler::Assembler::NamedMatrix> &b) {
+		REQUIRE(a.size() == b.size());
+		for (int i = 0; i < a.size(); ++i)
+		{
+			CHECK(a[i].first == b[i].first);
+			CHECK(a[i].second == b[i].second);
+		}
+	};
+	CHECK(!serial.scalar.empty());
+	check_named(serial.scalar, parallel.scalar);
+	check_named(serial.tensor, parallel.tensor);
+	check_named(serial.avg_scalar, parallel.avg_scalar);
+}
+
+TEST_CASE("load cases", "[load_cases]")
+{
+	json args = R"(
+	{
+		"geometry": [{
+			"surface_selection": [
+				{
+					"id": 1,
+					"axis": "-x",
+					"position": 0.3,
+					"relative": true
+				},
+				{
+					"id": 2,
+					"axis": "x",
+					"position": 0.7,
+					"relative": true
+				}
+			]
+		}],
+		"materials": {
+			"type": "LinearElasticity",
+			"E": 20000,
+			"nu": 0.3
+		},
+		"solver": {
+			"linear": {
+				"solver": "Eigen::SimplicialLDLT"
+			}
+		},
+		"boundary_conditions": {
+			"dirichlet_boundary": [{
+				"id": 1,
+				"value": [0, 0]
+			}],
+			"neumann_boundary": [{
+				"id": 2,
+				"value": [100, 0]
+			}],
+			"rhs": [0, 0]
+		},
+		"output": {
+			"log": {
+				"level": "warning"
+			}
+		}
+	})"_json;
+	args["geometry"][0]["mesh"] = POLYFEM_DATA_DIR + std::string("/contact/meshes/2D/simple/circle/circle36.obj");
+
+	// the cases differ from the main problem in the Dirichlet values, the Neumann loads and the body force
+	const json load_cases = R"([
+		{
+			"name": "dirichlet",
+			"boundary_conditions": {
+				"dirichlet_boundary": [{
+					"id": 1,
+					"value": [0.01, "0.01*y"]
+				}],
+				"rhs": [0, 0]
+			}
+		},
+		{
+			"name": "neumann",
+			"boundary_conditions": {
+				"dirichlet_boundary": [{
+					"id": 1,
+					"value": [0, 0]
+				}],
+				"neumann_boundary": [{
+					"id": 2,
+					"value": [0, -50]
+				}],
+				"rhs": [0, 10]
+			}
+		}
+	])"_json;
+
+	const auto solve = [](const json &args, Eigen::MatrixXd &load_case_sols) {
+		State state;
+		state.init(args, true);
+		state.load_mesh();
+		state.build_basis();
+		state.assemble_rhs();
+		state.assemble_mass_mat();
+
+		Eigen::MatrixXd sol, pressure;
+		state.solve_problem(sol, pressure);
+		load_case_sols = state.load_case_sols;
+		return sol;
+	};
+
+	SECTION("matches separate solves")
+	{
+		json cases_args = args;
+		cases_args["load_cases"] = load_cases;
+
+		Eigen::MatrixXd load_case_sols;
+		const Eigen::MatrixXd sol = solve(cases_args, load_case_sols);
+		REQUIRE(load_case_sols.cols() == load_cases.size());
+		REQUIRE(load_case_sols.rows() == sol.size());
+
+		for (int c = 0; c < load_cases.size(); ++c)
+		{
+			CAPTURE(c);
+			json case_args = args;
+			case_args["boundary_conditions"] = load_cases[c]["boundary_conditions"];
+
+			Eigen::MatrixXd unused;
+			const Eigen::MatrixXd expected = solve(case_args, unused);
+			REQUIRE(expected.size() == load_case_sols.rows());
+			CHECK(expected.norm() > 0);
+			CHECK((load_case_sols.col(c) - expected).norm() <= 1e-8 * expected.norm());
+			CHECK((load_case_sols.col(c) - sol).norm() > 1e-8 * expected.norm());
+		}
+	}
+
+	SECTION("rejects transient and nonlinear problems")
+	{
+		json cases_args = args;
+		cases_args["load_cases"] = load_cases;
+
+		json transient_args = cases_args;
+		transient_args["time"] = R"({"dt": 0.1, "tend": 1})"_json;
+		State transient_state;
+		CHECK_THROWS(transient_state.init(transient_args, true));
+
+		json nonlinear_args = cases_args;
+		nonlinear_args["materials"]["type"] = "NeoHookean";
+		State nonlinear_state;
+		CHECK_THROWS(nonlinear_state.init(nonlinear_args, true));
+	}
+}
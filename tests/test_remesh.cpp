@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+#include <polyfem/mesh/remesh/L2Projection.hpp>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <numeric>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace polyfem;
+using namespace polyfem::mesh;
+
+namespace
+{
+	/// mass matrix of n linear elements on [0, 1], scaled by s
+	Eigen::SparseMatrix<double> mass_matrix(const int n, const double s = 1)
+	{
+		const double h = 1.0 / n;
+		std::vector<Eigen::Triplet<double>> entries;
+		for (int e = 0; e < n; ++e)
+		{
+			for (int i = 0; i < 2; ++i)
+				for (int j = 0; j < 2; ++j)
+					entries.emplace_back(e + i, e + j, s * h / (i == j ? 3 : 6));
+		}
+		Eigen::SparseMatrix<double> M(n + 1, n + 1);
+		M.setFromTriplets(entries.begin(), entries.end());
+		M.makeCompressed();
+		return M;
+	}
+
+	/// solution of the factorized matrix for a random right-hand side, compared with a dense solve
+	void check_solver(polysolve::linear::Solver &solver, const Eigen::SparseMatrix<double> &M)
+	{
+		const Eigen::VectorXd b = Eigen::VectorXd::Random(M.rows());
+		Eigen::VectorXd x(M.rows());
+		solver.solve(b, x);
+		const Eigen::VectorXd expected = Eigen::MatrixXd(M).llt().solve(b);
+		CHECK((x - expected).norm() <= 1e-10 * expected.norm());
+	}
+} // namespace
+
+TEST_CASE("reduced L2 projection", "[remesh][l2_projection]")
+{
+	const int n = 12;
+	const Eigen::SparseMatrix<double> M = mass_matrix(n);
+	// projection from a mesh with a different mass
+	const Eigen::SparseMatrix<double> A = mass_matrix(n, 1.5);
+
+	const Eigen::MatrixXd y = Eigen::MatrixXd::Random(n + 1, 2);
+	const Eigen::MatrixXd x0 = Eigen::MatrixXd::Random(n + 1, 2);
+
+	const std::vector<int> boundary_nodes = GENERATE(
+		std::vector<int>{},
+		std::vector<int>{0, n},
+		std::vector<int>{0, 3, 4, 9});
+	CAPTURE(boundary_nodes);
+
+	Eigen::MatrixXd x = x0;
+	reduced_L2_projection(M, A, y, boundary_nodes, x);
+
+	// dense solve of the free nodes
+	std::vector<int> free_nodes;
+	for (int i = 0; i <= n; ++i)
+		if (std::find(boundary_nodes.begin(), boundary_nodes.end(), i) == boundary_nodes.end())
+			free_nodes.push_back(i);
+
+	const Eigen::MatrixXd dense_M = M;
+	const Eigen::MatrixXd g = -((dense_M * x0 - A * y)(free_nodes, Eigen::all));
+	Eigen::MatrixXd expected = x0;
+	expected(free_nodes, Eigen::all) += dense_M(free_nodes, free_nodes).llt().solve(g);
+
+	CHECK((x - expected).norm() <= 1e-10 * expected.norm());
+	for (const int b : boundary_nodes)
+		CHECK(x.row(b) == x0.row(b));
+
+	if (boundary_nodes.empty())
+	{
+		const Eigen::MatrixXd unconstrained = unconstrained_L2_projection(M, A, y);
+		CHECK((x - unconstrained).norm() <= 1e-10 * unconstrained.norm());
+	}
+}
+
+TEST_CASE("reduced L2 projection all fixed", "[remesh][l2_projection]")
+{
+	const int n = 5;
+	const Eigen::SparseMatrix<double> M = mass_matrix(n);
+	const Eigen::MatrixXd y = Eigen::MatrixXd::Random(n + 1, 2);
+	const Eigen::MatrixXd x0 = Eigen::MatrixXd::Random(n + 1, 2);
+
+	std::vector<int> boundary_nodes(n + 1);
+	std::iota(boundary_nodes.begin(), boundary_nodes.end(), 0);
+
+	Eigen::MatrixXd x = x0;
+	reduced_L2_projection(M, M, y, boundary_nodes, x);
+	CHECK(x == x0);
+}
+
+TEST_CASE("factorization cache", "[remesh][l2_projection]")
+{
+	const Eigen::SparseMatrix<double> M10 = mass_matrix(10), M11 = mass_matrix(11), M12 = mass_matrix(12);
+
+	SECTION("same pattern")
+	{
+		FactorizationCache cache;
+
+		check_solver(cache.factorize(M10), M10);
+		// same pattern with different values is only refactorized
+		const Eigen::SparseMatrix<double> scaled = mass_matrix(10, 3);
+		check_solver(cache.factorize(scaled), scaled);
+		check_solver(cache.factorize(M10), M10);
+
+		CHECK(cache.n_analyses() == 1);
+		CHECK(cache.size() == 1);
+		CHECK(cache.non_zeros() == M10.nonZeros());
+	}
+
+	SECTION("eviction")
+	{
+		// room for the two largest patterns only
+		FactorizationCache cache(M11.nonZeros() + M12.nonZeros());
+
+		check_solver(cache.factorize(M10), M10);
+		check_solver(cache.factorize(M11), M11);
+		CHECK(cache.size() == 2);
+
+		// drops the least recently used, M10
+		check_solver(cache.factorize(M12), M12);
+		CHECK(cache.n_analyses() == 3);
+		CHECK(cache.size() == 2);
+		CHECK(cache.non_zeros() == M11.nonZeros() + M12.nonZeros());
+
+		check_solver(cache.factorize(M11), M11);
+		CHECK(cache.n_analyses() == 3);
+
+		// M10 is analyzed again and drops M12, used before M11
+		check_solver(cache.factorize(M10), M10);
+		CHECK(cache.n_analyses() == 4);
+		CHECK(cache.non_zeros() <= cache.max_non_zeros());
+
+		check_solver(cache.factorize(M11), M11);
+		CHECK(cache.n_analyses() == 4);
+		check_solver(cache.factorize(M12), M12);
+		CHECK(cache.n_analyses() == 5);
+	}
+}
@@ -2,6 +2,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <polyfem/State.hpp>
+#include <polyfem/SimulationServer.hpp>
 #include <polyfem/Common.hpp>
 #include <polyfem/utils/Logger.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
@@ -122,3 +123,33 @@ TEST_CASE("restart", "[.][restart]")
 
 	std::filesystem::remove_all(outdir);
 }
+
+TEST_CASE("server_affected_stage", "[restart]")
+{
+	using Stage = SimulationServer::Stage;
+
+	const json args = R"({
+		"geometry": [{"mesh": "square.obj"}],
+		"space": {"discr_order": 1},
+		"materials": {"type": "LinearElasticity", "E": 1, "nu": 0.3},
+		"boundary_conditions": {"dirichlet_boundary": [{"id": 1, "value": [0, 0]}]},
+		"output": {"json": "sim.json"}
+	})"_json;
+
+	const auto stage = [&](const json &patch) {
+		json tmp = args;
+		tmp.merge_patch(patch);
+		return SimulationServer::affected_stage(args, tmp);
+	};
+
+	CHECK(SimulationServer::affected_stage(json::object(), args) == Stage::Full);
+	CHECK(stage(json::object()) == Stage::Export);
+	CHECK(stage(R"({"output": {"json": "other.json"}})"_json) == Stage::Export);
+	CHECK(stage(R"({"boundary_conditions": {"dirichlet_boundary": [{"id": 1, "value": [1, 0]}]}})"_json) == Stage::Solve);
+	CHECK(stage(R"({"solver": {"linear": {"solver": "Eigen::SimplicialLDLT"}}})"_json) == Stage::Solve);
+	CHECK(stage(R"({"materials": {"E": 10}})"_json) == Stage::Assembly);
+	CHECK(stage(R"({"materials": {"E": 10}, "output": {"json": "other.json"}})"_json) == Stage::Assembly);
+	CHECK(stage(R"({"space": {"discr_order": 2}})"_json) == Stage::Full);
+	CHECK(stage(R"({"geometry": [{"mesh": "circle.obj"}]})"_json) == Stage::Full);
+	CHECK(stage(R"({"output": {"paraview": {"vismesh_rel_area": 0.1}}})"_json) == Stage::Full);
+}
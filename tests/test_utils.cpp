@@ -6,6 +6,9 @@
 #include <polyfem/io/MshReader.hpp>
 #include <polyfem/mesh/Mesh.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
+#include <polyfem/utils/Reordering.hpp>
+#include <polyfem/utils/Profiler.hpp>
+#include <polyfem/utils/TaskGraph.hpp>
 
 #ifdef POLYFEM_WITH_REMESHING
 #include <wmtk/TriMesh.h>
@@ -13,6 +16,8 @@
 
 #include <Eigen/Dense>
 
+#include <mutex>
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 ////////////////////////////////////////////////////////////////////////////////
@@ -107,6 +112,20 @@ TEST_CASE("expression", "[utils]")
 	REQUIRE(expr(2, 3, 4) == Catch::Approx(2. * 2. + sqrt(2. * 3.) + sin(4.) * 2.).margin(1e-10));
 	REQUIRE(expr2d(2, 3) == Catch::Approx(2. * 2. + sqrt(2. * 3.)).margin(1e-10));
 	REQUIRE(val(2, 3, 4) == Catch::Approx(1).margin(1e-16));
+
+	const Eigen::MatrixXd pts = Eigen::MatrixXd::Random(20, 3).array().abs();
+	Eigen::VectorXd batch;
+	for (const auto *e : {&expr, &val})
+	{
+		e->eval(pts, 0, -1, batch);
+		REQUIRE(batch.size() == pts.rows());
+		for (int i = 0; i < pts.rows(); ++i)
+			REQUIRE(batch(i) == Catch::Approx((*e)(pts(i, 0), pts(i, 1), pts(i, 2))).margin(1e-12));
+	}
+
+	expr2d.eval(pts.leftCols(2), 0, -1, batch);
+	for (int i = 0; i < pts.rows(); ++i)
+		REQUIRE(batch(i) == Catch::Approx(expr2d(pts(i, 0), pts(i, 1))).margin(1e-12));
 }
 
 TEST_CASE("mshreader", "[utils]")
@@ -132,6 +151,125 @@ TEST_CASE("inverse", "[utils]")
 	REQUIRE(((utils::inverse(mat3) - mat3_inv)).norm() == Catch::Approx(0).margin(1e-12));
 }
 
+TEST_CASE("reordering", "[utils]")
+{
+	// n x n grid graph with shuffled vertex ids
+	const int n = 20;
+	Eigen::VectorXi shuffle = Eigen::VectorXi::LinSpaced(n * n, 0, n * n - 1);
+	std::reverse(shuffle.data() + n * n / 3, shuffle.data() + n * n);
+	std::reverse(shuffle.data(), shuffle.data() + 2 * n * n / 3);
+
+	std::vector<std::vector<int>> adjacency(n * n);
+	Eigen::MatrixXd points(n * n, 2);
+	for (int i = 0; i < n; ++i)
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			const int v = shuffle[i * n + j];
+			points.row(v) << i, j;
+			if (i + 1 < n)
+			{
+				adjacency[v].push_back(shuffle[(i + 1) * n + j]);
+				adjacency[shuffle[(i + 1) * n + j]].push_back(v);
+			}
+			if (j + 1 < n)
+			{
+				adjacency[v].push_back(shuffle[i * n + j + 1]);
+				adjacency[shuffle[i * n + j + 1]].push_back(v);
+			}
+		}
+	}
+
+	const auto is_permutation = [&](const Eigen::VectorXi &order) {
+		std::vector<int> tmp(order.data(), order.data() + order.size());
+		std::sort(tmp.begin(), tmp.end());
+		for (int i = 0; i < tmp.size(); ++i)
+			if (tmp[i] != i)
+				return false;
+		return true;
+	};
+
+	const Eigen::VectorXi rcm = reverse_cuthill_mckee(adjacency);
+	REQUIRE(rcm.size() == n * n);
+	REQUIRE(is_permutation(rcm));
+	CHECK(graph_bandwidth(adjacency, invert_permutation(rcm)) <= n + 1);
+
+	const Eigen::VectorXi morton = morton_order(points);
+	REQUIRE(morton.size() == n * n);
+	REQUIRE(is_permutation(morton));
+	CHECK(graph_bandwidth(adjacency, invert_permutation(morton)) < graph_bandwidth(adjacency));
+}
+
+TEST_CASE("profiler", "[utils]")
+{
+	Profiler &profiler = Profiler::instance();
+	profiler.clear();
+
+	{
+		// disabled scopes are not recorded
+		POLYFEM_PROFILE_SCOPE("disabled");
+	}
+
+	profiler.set_enabled(true);
+	for (int i = 0; i < 3; ++i)
+	{
+		POLYFEM_PROFILE_SCOPE("outer");
+		for (int j = 0; j < 2; ++j)
+		{
+			POLYFEM_PROFILE_SCOPE("inner");
+		}
+	}
+	profiler.set_enabled(false);
+
+	const json summary = profiler.summary();
+	REQUIRE(summary.size() == 2);
+
+	CHECK(summary[0]["path"] == "outer");
+	CHECK(summary[0]["depth"] == 0);
+	CHECK(summary[0]["calls"] == 3);
+
+	CHECK(summary[1]["path"] == "outer/inner");
+	CHECK(summary[1]["depth"] == 1);
+	CHECK(summary[1]["calls"] == 6);
+
+	CHECK(summary[1]["total"].get<double>() <= summary[0]["total"].get<double>());
+	CHECK(summary[0]["self"].get<double>() >= 0);
+
+	profiler.clear();
+	CHECK(profiler.summary().empty());
+}
+
+TEST_CASE("task_graph", "[utils]")
+{
+	// two chains joined by the last task
+	const int n = 10;
+	std::vector<std::vector<int>> dependencies(n);
+	for (int i = 2; i < n - 1; ++i)
+		dependencies[i].push_back(i - 2);
+	dependencies[n - 1] = {n - 2, n - 3};
+
+	std::mutex mutex;
+	std::vector<int> order;
+	run_task_graph(dependencies, 1, [&](int i) {
+		std::lock_guard<std::mutex> lock(mutex);
+		order.push_back(i);
+	});
+
+	REQUIRE(order.size() == n);
+	std::vector<int> position(n);
+	for (int i = 0; i < n; ++i)
+		position[order[i]] = i;
+	for (int i = 0; i < n; ++i)
+		for (const int d : dependencies[i])
+			CHECK(position[d] < position[i]);
+
+	CHECK_THROWS(run_task_graph({{1}, {0}}, 1, [](int) {}));
+	CHECK_THROWS(run_task_graph(dependencies, 1, [](int i) {
+		if (i == 3)
+			throw std::runtime_error("task failed");
+	}));
+}
+
 #ifdef POLYFEM_WITH_REMESHING
 TEST_CASE("wmtk_instatiation", "[utils]")
 {